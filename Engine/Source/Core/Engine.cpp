@@ -8,6 +8,7 @@
 #include "Window.h"
 #include "Platform/Vulkan/VulkanRenderer.h"
 #include "Platform/Vulkan/VulkanRendererContext.h"
+#include "Memory/AllocationRecorder.h"
 #include "Memory/Mem.h"
 #include "Platform/Windows/WindowsWindow.h"
 #include "Log.h"
@@ -19,29 +20,81 @@ void CEngine::Start()
 {
     GEngine = this;
     
+    RK_MEMORY_SCOPE(Engine);
+
     CLog::Init();
+    RK_ENGINE_INFO("Memory kernels: {}", Mem::GetKernelName());
+
+    // The logger is created before the baseline, it lives until the process exits.
+    const SMemoryMetrics StartMetrics = GetMemoryMetrics();
+    for (size_t Tag = 0; Tag < static_cast<size_t>(EMemoryTag::Count); ++Tag)
+    {
+        StartLiveBytes[Tag] = StartMetrics.Tags[Tag].LiveBytes - StartMetrics.Tags[Tag].PersistentBytes;
+    }
+    if (bTrackLeaks)
+    {
+        Mem::SetLeakTracking(true);
+    }
+    for (size_t Tag = 0; Tag < static_cast<size_t>(EMemoryTag::Count); ++Tag)
+    {
+        Mem::SetMemoryBudget(static_cast<EMemoryTag>(Tag), MemoryBudgets[Tag]);
+    }
+
+    if (AllocationCapturePath != nullptr)
+    {
+        if (AllocationRecorder::Start(AllocationCapturePath))
+        {
+            RK_ENGINE_INFO("Recording heap allocations to {}", AllocationCapturePath);
+        }
+        else
+        {
+            RK_ENGINE_WARNING("Failed to start the allocation recorder at {}", AllocationCapturePath);
+        }
+    }
+
+    FrameArena.Init(PARAMETER_FRAME_ARENA_SIZE);
 
     Window = new CWindowsWindow(SWindowSpecification { "Rocket Engine", PARAMETER_VIEWPORT_WIDTH, PARAMETER_VIEWPORT_HEIGHT } );
     Window->CreateNativeWindow();
-    Renderer = new CVulkanRenderer();
-    Renderer->Init();
-    Scene = new CScene();
+    {
+        RK_MEMORY_SCOPE(Renderer);
+        Renderer = new CVulkanRenderer();
+        Renderer->Init();
+    }
+    {
+        RK_MEMORY_SCOPE(Scene);
+        Scene = new CScene();
+    }
 
     OnStart();
 }
 
 void CEngine::Run()
 {
+    RkVulkanRendererContext* Context = Cast<RkVulkanRendererContext>(Window->GetContext());
+
+    uint64 FrameIndex = 0;
     while (!Window->ShouldClose())
     {
         Metrics.Reset();
         Time.Validate();
 
+        const bool bAuditFrame = AllocationAuditMode != EAllocationAuditMode::Disabled && FrameIndex >= PARAMETER_ALLOCATION_AUDIT_WARMUP_FRAMES;
+        if (bAuditFrame)
+        {
+            Mem::BeginAllocationAudit(AllocationAuditMode);
+        }
+
         Window->Poll();
+
+        // Once the frame slot's fence has signalled, nothing references its transient memory anymore.
+        Context->WaitForFrame();
+        FrameArena.BeginFrame(static_cast<uint32>(Context->GetCurrentFrame()));
+
         OnUpdate(Time.GetDeltaTime());
         Scene->Tick(Time.GetDeltaTime());
 
-        Cast<RkVulkanRendererContext>(Window->GetContext())->Draw();
+        Context->Draw();
         Renderer->BeginFrame();
         //for (CActor* Actor : Scene->GetActors())
         //{
@@ -49,7 +102,116 @@ void CEngine::Run()
         //}
         Renderer->EndFrame();
 
+        Metrics.FrameArenaUsed = FrameArena.GetCurrent().GetUsed();
+        Metrics.FrameArenaOverflow = FrameArena.GetCurrent().GetOverflowSize();
+        Metrics.FrameArenaHighWaterMark = FrameArena.GetHighWaterMark();
+
+        const SMemoryMetrics MemoryMetrics = GetMemoryMetrics(&MemoryRateWindow);
+        for (size_t Tag = 0; Tag < static_cast<size_t>(EMemoryTag::Count); ++Tag)
+        {
+            Metrics.AllocationRates[Tag] = MemoryMetrics.Tags[Tag].AllocationRate;
+        }
+        Metrics.CurrentObjectAllocated = static_cast<uint32>(MemoryMetrics.TotalHeapAllocations - MemoryMetrics.TotalHeapDeallocations);
+        Metrics.TotalObjectAllocated = static_cast<uint32>(MemoryMetrics.TotalHeapAllocations);
+        Metrics.CurrentSizeAllocated = MemoryMetrics.CurrentHeapAllocation;
+        Metrics.TotalSizeAllocated = MemoryMetrics.TotalHeapBytesAllocated;
+        CheckMemoryBudgets(MemoryMetrics);
+
         Window->Swap();
+
+        if (bAuditFrame)
+        {
+            const SAllocationAuditReport Report = Mem::EndAllocationAudit();
+            Metrics.FrameAllocations = Report.NumAllocations;
+            Metrics.FrameAllowedAllocations = Report.NumAllowedAllocations;
+            Metrics.FrameAllocatedBytes = Report.NumBytes;
+            ReportFrameAllocations(FrameIndex, Report);
+        }
+        ++FrameIndex;
+    }
+}
+
+void CEngine::ReportFrameAllocations(uint64 FrameIndex, const SAllocationAuditReport& Report)
+{
+    for (uint32 Index = 0; Index < Report.NumRecords; ++Index)
+    {
+        const SAllocationAuditRecord& Record = Report.Records[Index];
+
+        uint64 SiteHash = 0;
+        for (uint32 Frame = 0; Frame < Record.NumFrames; ++Frame)
+        {
+            SiteHash = Hash::Combine(SiteHash, reinterpret_cast<uintptr_t>(Record.Frames[Frame]));
+        }
+        if (!ReportedAllocationSites.Add(SiteHash))
+        {
+            continue;
+        }
+
+        std::ostringstream CallStack;
+        for (uint32 Frame = 0; Frame < Record.NumFrames; ++Frame)
+        {
+            CallStack << "\n    " << Record.Frames[Frame];
+        }
+        RK_ENGINE_WARNING("Heap allocation of {} bytes ({}) in audited frame {}:{}", Record.Size, Mem::GetTagName(Record.Tag), FrameIndex, CallStack.str());
+    }
+}
+
+// The warning itself comes from the allocation that crosses a budget, this only summarizes the frame.
+void CEngine::CheckMemoryBudgets(const SMemoryMetrics& MemoryMetrics)
+{
+    Metrics.OverBudgetTags = 0;
+    for (uint32 Tag = 0; Tag < static_cast<uint32>(EMemoryTag::Count); ++Tag)
+    {
+        const size_t Budget = MemoryBudgets[Tag];
+        if (Budget != Mem::GetMemoryBudget(static_cast<EMemoryTag>(Tag)))
+        {
+            Mem::SetMemoryBudget(static_cast<EMemoryTag>(Tag), Budget);
+        }
+        if (Budget != 0 && MemoryMetrics.Tags[Tag].LiveBytes > Budget)
+        {
+            Metrics.OverBudgetTags |= 1u << Tag;
+        }
+    }
+}
+
+void CEngine::ReportLiveAllocations()
+{
+    const SMemoryMetrics MemoryMetrics = GetMemoryMetrics();
+
+    LeakedBytes = 0;
+    for (size_t Tag = 0; Tag < static_cast<size_t>(EMemoryTag::Count); ++Tag)
+    {
+        // Persistent allocations made after Start, such as pool slabs, are expected to outlive shutdown.
+        const size_t LiveBytes = MemoryMetrics.Tags[Tag].LiveBytes - MemoryMetrics.Tags[Tag].PersistentBytes;
+        if (LiveBytes > StartLiveBytes[Tag])
+        {
+            LeakedBytes += LiveBytes - StartLiveBytes[Tag];
+            RK_ENGINE_ERROR("{} memory leaked: {} bytes still live after shutdown", Mem::GetTagName(static_cast<EMemoryTag>(Tag)), LiveBytes - StartLiveBytes[Tag]);
+        }
+    }
+
+    if (!Mem::IsLeakTrackingEnabled())
+    {
+        return;
+    }
+    Mem::SetLeakTracking(false);
+
+    SLiveAllocationSite Sites[PARAMETER_LEAK_REPORT_MAX_SITES];
+    const uint32 NumSites = Mem::GetLiveAllocationSites(Sites, PARAMETER_LEAK_REPORT_MAX_SITES);
+    for (uint32 Index = 0; Index < NumSites && Index < PARAMETER_LEAK_REPORT_MAX_SITES; ++Index)
+    {
+        const SLiveAllocationSite& Site = Sites[Index];
+
+        std::ostringstream CallStack;
+        for (uint32 Frame = 0; Frame < Site.NumFrames; ++Frame)
+        {
+            CallStack << "\n    " << Site.Frames[Frame];
+        }
+        RK_ENGINE_ERROR("{} live allocations of {} bytes in total ({}):{}", Site.NumAllocations, Site.NumBytes, Mem::GetTagName(Site.Tag), CallStack.str());
+    }
+    if (NumSites > PARAMETER_LEAK_REPORT_MAX_SITES)
+    {
+        RK_ENGINE_ERROR("{} more call sites with live allocations are not listed", NumSites - PARAMETER_LEAK_REPORT_MAX_SITES);
     }
 }
 
@@ -64,6 +226,13 @@ void CEngine::Stop()
     delete Renderer;
     delete Scene;
 
+    FrameArena.Destroy();
+    ReportedAllocationSites = TSet<uint64>();
+
+    AllocationRecorder::Stop();
+
+    ReportLiveAllocations();
+
     GEngine = nullptr;
 }
 
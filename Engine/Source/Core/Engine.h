@@ -4,6 +4,10 @@
 #include <mutex>
 
 #include "Math/MathTypes.h"
+#include "Memory/FrameArena.h"
+#include "Memory/Map.h"
+#include "Memory/Mem.h"
+#include "Renderer/RendererContext.h"
 
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
@@ -28,6 +32,13 @@ typedef std::size_t SizeType;
 
 static constexpr int32 PARAMETER_VIEWPORT_WIDTH = 1920;
 static constexpr int32 PARAMETER_VIEWPORT_HEIGHT = 1080;
+static constexpr size_t PARAMETER_FRAME_ARENA_SIZE = 4 * 1024 * 1024;
+
+// Frames run before the allocation audit is armed, so startup and first-use allocations are not reported.
+static constexpr uint32 PARAMETER_ALLOCATION_AUDIT_WARMUP_FRAMES = 120;
+
+// Largest groups of still-live allocations listed by the leak report at shutdown.
+static constexpr uint32 PARAMETER_LEAK_REPORT_MAX_SITES = 16;
 
 /* A duration of time in seconds. */
 struct STimespan
@@ -80,9 +91,27 @@ struct SMetrics
 	size_t CurrentSizeAllocated;
 	size_t TotalSizeAllocated;
 
+	size_t FrameArenaUsed;
+	size_t FrameArenaOverflow;
+	size_t FrameArenaHighWaterMark;
+
+	// Heap allocations made by the main thread during the audited frame, see CEngine::AllocationAuditMode.
+	uint32 FrameAllocations;
+	uint32 FrameAllowedAllocations;
+	size_t FrameAllocatedBytes;
+
+	// Heap bytes allocated per second by each memory tag, sampled once per frame.
+	float AllocationRates[static_cast<size_t>(EMemoryTag::Count)];
+
+	// Bit per memory tag that was over its budget at the end of the frame.
+	uint32 OverBudgetTags;
+
 	void Reset()
 	{
 		DrawCallCounter = 0;
+		FrameAllocations = 0;
+		FrameAllowedAllocations = 0;
+		FrameAllocatedBytes = 0;
 	}
 };
 
@@ -106,15 +135,47 @@ public:
 
 	STimespan Time;
 	SMetrics Metrics;
+
+	// Transient per-frame memory, recycled once the frame's fence has signalled.
+	TFrameArena<MAX_FRAMES_IN_FLIGHT> FrameArena;
+
+	// Audits the steady-state main loop for heap allocations. Set before Run, Assert breaks on the first one.
+	EAllocationAuditMode AllocationAuditMode = EAllocationAuditMode::Disabled;
+
+	// When set before Start, every heap allocation until Stop is recorded to this file for the AllocationReport tool.
+	const char* AllocationCapturePath = nullptr;
+
+	// Live heap bytes allowed per memory tag, zero for no limit. The allocation that takes a tag over logs a warning,
+	// once per crossing. Changes made after Start apply from the next frame.
+	size_t MemoryBudgets[static_cast<size_t>(EMemoryTag::Count)] = {};
+
+	// When set before Start, Stop reports the allocations made since Start that are still live by call site.
+	bool bTrackLeaks = false;
+
+	// Bytes allocated since Start that were still live after Stop, for automated runs to fail on.
+	size_t LeakedBytes = 0;
 	
 protected:
 	virtual void OnStart() {}
 	virtual void OnUpdate(float DeltaTime) {}
 	virtual void OnStop() {}
+
+	void ReportFrameAllocations(uint64 FrameIndex, const SAllocationAuditReport& Report);
+	void CheckMemoryBudgets(const SMemoryMetrics& MemoryMetrics);
+	void ReportLiveAllocations();
 	
 	CWindow* Window;
 	CRenderer* Renderer;
 	CScene* Scene;
+
+	// Call stacks of audited allocations that were already reported, so each site is logged once.
+	TSet<uint64> ReportedAllocationSites;
+
+	// Live bytes per tag when Start began, without persistent allocations, the baseline the leak report compares against.
+	size_t StartLiveBytes[static_cast<size_t>(EMemoryTag::Count)] = {};
+
+	// Rate state of the per-frame memory sample.
+	SMemoryRateWindow MemoryRateWindow;
 	
 	static CEngine* GEngine;
 };
@@ -122,4 +183,9 @@ protected:
 static inline CEngine* GetEngine()
 {
 	return CEngine::Get();
+}
+
+static inline TFrameArena<MAX_FRAMES_IN_FLIGHT>& GetFrameArena()
+{
+	return CEngine::Get()->FrameArena;
 }
\ No newline at end of file
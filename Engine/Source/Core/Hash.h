@@ -0,0 +1,90 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "Math/MathTypes.h"
+
+namespace Hash
+{
+    /* 64-bit finalizer (splitmix64). Every input bit affects every output bit, so sequential ids spread evenly. */
+    constexpr uint64 Mix64(uint64 Value)
+    {
+        Value ^= Value >> 30;
+        Value *= 0xBF58476D1CE4E5B9ull;
+        Value ^= Value >> 27;
+        Value *= 0x94D049BB133111EBull;
+        Value ^= Value >> 31;
+        return Value;
+    }
+
+    constexpr uint64 Combine(uint64 Seed, uint64 Value)
+    {
+        return Mix64(Seed ^ (Value + 0x9E3779B97F4A7C15ull + (Seed << 6) + (Seed >> 2)));
+    }
+
+    constexpr char ToLowerAscii(char Character)
+    {
+        return Character >= 'A' && Character <= 'Z' ? static_cast<char>(Character - 'A' + 'a') : Character;
+    }
+
+    /* 64-bit FNV-1a of the bytes of Text, usable at compile time. */
+    constexpr uint64 String(std::string_view Text)
+    {
+        uint64 Value = 0xCBF29CE484222325ull;
+        for (char Character : Text)
+        {
+            Value = (Value ^ static_cast<uint8>(Character)) * 0x100000001B3ull;
+        }
+        return Value;
+    }
+
+    /* Same as String after folding ASCII letters to lower case. */
+    constexpr uint64 StringNoCase(std::string_view Text)
+    {
+        uint64 Value = 0xCBF29CE484222325ull;
+        for (char Character : Text)
+        {
+            Value = (Value ^ static_cast<uint8>(ToLowerAscii(Character))) * 0x100000001B3ull;
+        }
+        return Value;
+    }
+}
+
+/*
+ * Unmixed hash of a value, used by TMap and TSet which apply Hash::Mix64 themselves. Overload for engine types
+ * next to their declaration. Types that can be looked up in place of each other must hash the same.
+ */
+template<typename T>
+inline uint64 GetTypeHash(const T& Value)
+{
+    if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+    {
+        return static_cast<uint64>(Value);
+    }
+    else if constexpr (std::is_pointer_v<T>)
+    {
+        return static_cast<uint64>(reinterpret_cast<uintptr_t>(Value));
+    }
+    else
+    {
+        return static_cast<uint64>(std::hash<T>()(Value));
+    }
+}
+
+inline uint64 GetTypeHash(std::string_view Value)
+{
+    return static_cast<uint64>(std::hash<std::string_view>()(Value));
+}
+
+inline uint64 GetTypeHash(const std::string& Value)
+{
+    return GetTypeHash(std::string_view(Value));
+}
+
+inline uint64 GetTypeHash(const char* Value)
+{
+    return GetTypeHash(std::string_view(Value));
+}
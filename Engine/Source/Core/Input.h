@@ -1,11 +1,11 @@
 ﻿#pragma once
 
 #include <chrono>
-#include <unordered_map>
 #include <utility>
 
 #include "KeyCode.h"
 #include "Math/MathTypes.h"
+#include "Memory/Map.h"
 
 struct SKeyPressData
 {
@@ -63,7 +63,7 @@ protected:
     virtual std::pair<float, float> GetMousePositionImpl() = 0;
 
 protected:
-    std::unordered_map<int32, SKeyPressData> KeyPressData;
+    TMap<int32, SKeyPressData> KeyPressData;
     
 private:
     static CInput* GInput;
@@ -0,0 +1,320 @@
+#include "EnginePCH.h"
+#include "Name.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+namespace
+{
+    // Names up to this length are lower cased in a buffer on the stack, longer ones in a temporary heap block.
+    static constexpr uint32 MaxStackNameLength = 1024;
+
+    static constexpr uint32 EntriesPerPageBits = 12;
+    static constexpr uint32 EntriesPerPage = 1u << EntriesPerPageBits;
+    static constexpr uint32 MaxPages = 1024;
+
+    static constexpr size_t EntryBlockSize = 64 * 1024;
+    static constexpr uint32 InitialTableCapacity = 1024;
+
+    struct SNameEntry
+    {
+        uint64 Hash;
+
+        // Id of the lower case spelling, the entry's own id if it has no upper case letters.
+        uint32 NoCaseId;
+
+        uint32 Length;
+
+        // Null terminated, the entry is allocated with room for Length characters.
+        char Data[1];
+    };
+
+    /*
+     * Open-addressing index from string hash to id. A slot packs the upper half of the hash above the id, so
+     * probing rejects most mismatches without touching the entry. Zero marks an empty slot. The table is only
+     * written under the lock and replaced when it grows. Readers may still hold the old one, so it is never freed.
+     */
+    struct SNameTable
+    {
+        uint32 Mask;
+
+        std::atomic<uint64> Slots[1];
+    };
+
+    static SNameEntry GNoneEntry { Hash::String(""), 0, 0, { 0 } };
+
+    // Entries are addressed by id through fixed pages, so ids stay valid and lookups lock free while the table grows.
+    static SNameEntry* GFirstPage[EntriesPerPage] = { &GNoneEntry };
+    static std::atomic<SNameEntry**> GEntryPages[MaxPages] = { GFirstPage };
+
+    static std::atomic<SNameTable*> GTable { nullptr };
+
+    // Guards everything below as well as adding entries and table slots.
+    static std::mutex GWriteMutex;
+
+    static uint32 GNumEntries = 1;
+
+    // Names live until the process exits, so their storage comes from malloc and stays out of the heap tracking.
+    static char* GEntryBlock = nullptr;
+    static size_t GEntryBlockUsed = EntryBlockSize;
+
+    static inline const SNameEntry* GetEntry(uint32 Id)
+    {
+        return GEntryPages[Id >> EntriesPerPageBits].load(std::memory_order_acquire)[Id & (EntriesPerPage - 1)];
+    }
+
+    static inline bool Matches(const SNameEntry& Entry, std::string_view Text, bool bLowerCase)
+    {
+        if (Entry.Length != Text.size())
+        {
+            return false;
+        }
+        if (!bLowerCase)
+        {
+            return std::memcmp(Entry.Data, Text.data(), Text.size()) == 0;
+        }
+
+        for (size_t Index = 0; Index < Text.size(); ++Index)
+        {
+            if (Entry.Data[Index] != Hash::ToLowerAscii(Text[Index]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // With bLowerCase set, finds the entry spelled as the lower case of Text. Hash must match the spelling searched for.
+    static uint32 FindInTable(const SNameTable* Table, std::string_view Text, uint64 Hash, bool bLowerCase)
+    {
+        if (Table == nullptr)
+        {
+            return 0;
+        }
+
+        const uint32 HashTag = static_cast<uint32>(Hash >> 32);
+        for (uint32 Index = static_cast<uint32>(Hash) & Table->Mask; ; Index = (Index + 1) & Table->Mask)
+        {
+            const uint64 Slot = Table->Slots[Index].load(std::memory_order_acquire);
+            if (Slot == 0)
+            {
+                return 0;
+            }
+
+            const uint32 Id = static_cast<uint32>(Slot);
+            if (static_cast<uint32>(Slot >> 32) == HashTag)
+            {
+                const SNameEntry& Entry = *GetEntry(Id);
+                if (Entry.Hash == Hash && Matches(Entry, Text, bLowerCase))
+                {
+                    return Id;
+                }
+            }
+        }
+    }
+
+    static SNameTable* AllocateTable(uint32 Capacity)
+    {
+        void* Block = std::calloc(1, sizeof(SNameTable) + (Capacity - 1) * sizeof(std::atomic<uint64>));
+        if (Block == nullptr)
+        {
+            std::abort();
+        }
+
+        SNameTable* Table = static_cast<SNameTable*>(Block);
+        Table->Mask = Capacity - 1;
+        return Table;
+    }
+
+    static void InsertSlot(SNameTable* Table, uint64 Hash, uint32 Id)
+    {
+        uint32 Index = static_cast<uint32>(Hash) & Table->Mask;
+        while (Table->Slots[Index].load(std::memory_order_relaxed) != 0)
+        {
+            Index = (Index + 1) & Table->Mask;
+        }
+        Table->Slots[Index].store((static_cast<uint64>(Hash >> 32) << 32) | Id, std::memory_order_release);
+    }
+
+    // Keeps the load factor at or below one half.
+    static SNameTable* ReserveTableLocked(uint32 NumEntries)
+    {
+        SNameTable* Table = GTable.load(std::memory_order_relaxed);
+        const uint32 Capacity = Table ? Table->Mask + 1 : 0;
+        if (NumEntries * 2 <= Capacity)
+        {
+            return Table;
+        }
+
+        const uint32 NewCapacity = Capacity ? Capacity * 2 : InitialTableCapacity;
+        SNameTable* NewTable = AllocateTable(NewCapacity);
+        for (uint32 Id = 1; Id < GNumEntries; ++Id)
+        {
+            InsertSlot(NewTable, GetEntry(Id)->Hash, Id);
+        }
+        GTable.store(NewTable, std::memory_order_release);
+        return NewTable;
+    }
+
+    static SNameEntry* AllocateEntryLocked(uint32 Length)
+    {
+        const size_t Size = (offsetof(SNameEntry, Data) + Length + 1 + alignof(SNameEntry) - 1) & ~(alignof(SNameEntry) - 1);
+        if (GEntryBlockUsed + Size > EntryBlockSize)
+        {
+            // A name longer than a block gets a block of its own, which the next entry then finds full.
+            GEntryBlock = static_cast<char*>(std::malloc(std::max(Size, EntryBlockSize)));
+            GEntryBlockUsed = 0;
+            if (GEntryBlock == nullptr)
+            {
+                std::abort();
+            }
+        }
+
+        SNameEntry* Entry = reinterpret_cast<SNameEntry*>(GEntryBlock + GEntryBlockUsed);
+        GEntryBlockUsed += Size;
+        return Entry;
+    }
+
+    static uint32 FindOrAddLocked(std::string_view Text, uint64 Hash)
+    {
+        uint32 Id = FindInTable(GTable.load(std::memory_order_relaxed), Text, Hash, false);
+        if (Id != 0)
+        {
+            return Id;
+        }
+
+        // The lower case spelling is added first, so its id is known when this entry is published.
+        uint32 NoCaseId = 0;
+        for (size_t Index = 0; Index < Text.size(); ++Index)
+        {
+            if (Hash::ToLowerAscii(Text[Index]) != Text[Index])
+            {
+                char StackBuffer[MaxStackNameLength];
+                char* LowerCase = Text.size() <= MaxStackNameLength ? StackBuffer : static_cast<char*>(std::malloc(Text.size()));
+                if (LowerCase == nullptr)
+                {
+                    std::abort();
+                }
+
+                for (size_t Character = 0; Character < Text.size(); ++Character)
+                {
+                    LowerCase[Character] = Hash::ToLowerAscii(Text[Character]);
+                }
+                const std::string_view LowerCaseText(LowerCase, Text.size());
+                NoCaseId = FindOrAddLocked(LowerCaseText, Hash::String(LowerCaseText));
+
+                if (LowerCase != StackBuffer)
+                {
+                    std::free(LowerCase);
+                }
+                break;
+            }
+        }
+
+        Id = GNumEntries;
+        const uint32 Page = Id >> EntriesPerPageBits;
+        if (Page >= MaxPages)
+        {
+            assert(false && "Too many names have been interned.");
+            std::abort();
+        }
+
+        SNameTable* Table = ReserveTableLocked(Id);
+
+        SNameEntry* Entry = AllocateEntryLocked(static_cast<uint32>(Text.size()));
+        Entry->Hash = Hash;
+        Entry->NoCaseId = NoCaseId != 0 ? NoCaseId : Id;
+        Entry->Length = static_cast<uint32>(Text.size());
+        std::memcpy(Entry->Data, Text.data(), Text.size());
+        Entry->Data[Text.size()] = '\0';
+
+        SNameEntry** Entries = GEntryPages[Page].load(std::memory_order_relaxed);
+        if (Entries == nullptr)
+        {
+            Entries = static_cast<SNameEntry**>(std::calloc(EntriesPerPage, sizeof(SNameEntry*)));
+            if (Entries == nullptr)
+            {
+                std::abort();
+            }
+            GEntryPages[Page].store(Entries, std::memory_order_release);
+        }
+        Entries[Id & (EntriesPerPage - 1)] = Entry;
+        ++GNumEntries;
+
+        // Publishes the entry, readers only reach it through this slot or a name copied from someone who did.
+        InsertSlot(Table, Hash, Id);
+        return Id;
+    }
+
+    static uint32 FindOrAdd(std::string_view Text, uint64 Hash)
+    {
+        if (Text.empty())
+        {
+            return 0;
+        }
+
+        const uint32 Id = FindInTable(GTable.load(std::memory_order_acquire), Text, Hash, false);
+        if (Id != 0)
+        {
+            return Id;
+        }
+
+        std::lock_guard<std::mutex> Lock(GWriteMutex);
+        return FindOrAddLocked(Text, Hash);
+    }
+}
+
+SName::SName(std::string_view String)
+    : Id(FindOrAdd(String, Hash::String(String)))
+{
+}
+
+SName::SName(const SNameLiteral& Literal)
+    : Id(FindOrAdd(std::string_view(Literal.Data, Literal.Length), Literal.Hash))
+{
+}
+
+SName SName::Find(std::string_view String)
+{
+    SName Name;
+    if (!String.empty())
+    {
+        Name.Id = FindInTable(GTable.load(std::memory_order_acquire), String, Hash::String(String), false);
+    }
+    return Name;
+}
+
+std::string_view SName::ToString() const
+{
+    const SNameEntry* Entry = GetEntry(Id);
+    return std::string_view(Entry->Data, Entry->Length);
+}
+
+const char* SName::GetData() const
+{
+    return GetEntry(Id)->Data;
+}
+
+bool SName::EqualsNoCase(SName Other) const
+{
+    return Id == Other.Id || GetEntry(Id)->NoCaseId == GetEntry(Other.Id)->NoCaseId;
+}
+
+SNameNoCase::SNameNoCase(SName Name)
+    : Id(GetEntry(Name.GetId())->NoCaseId)
+{
+}
+
+SNameNoCase::SNameNoCase(std::string_view String)
+{
+    // The lower case spelling usually exists already and can be found without the lock or a copy of String.
+    Id = String.empty() ? 0 : FindInTable(GTable.load(std::memory_order_acquire), String, Hash::StringNoCase(String), true);
+    if (Id == 0)
+    {
+        Id = GetEntry(SName(String).GetId())->NoCaseId;
+    }
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+#include "Core/Hash.h"
+#include "Math/MathTypes.h"
+
+/* String literal hashed at compile time, so interning it skips hashing at runtime. */
+struct SNameLiteral
+{
+    const char* Data;
+
+    uint32 Length;
+
+    uint64 Hash;
+
+    template<size_t N>
+    constexpr SNameLiteral(const char (&Literal)[N])
+        : Data(Literal), Length(static_cast<uint32>(N - 1)), Hash(Hash::String(std::string_view(Literal, N - 1)))
+    {
+    }
+};
+
+/*
+ * Interned string. Every distinct string is stored once in a global table and identified by a 32-bit id, so
+ * copying, comparing and hashing a name is O(1) and never allocates. Names are case sensitive and keep their
+ * spelling, SNameNoCase compares them ignoring ASCII case. Interned strings are never freed.
+ *
+ * Lookups of names that already exist are lock free, only adding a new string takes a lock. Id 0 is the empty
+ * string, which is also the default value.
+ */
+struct SName
+{
+    constexpr SName() = default;
+
+    SName(std::string_view String);
+    SName(const char* String)
+        : SName(std::string_view(String))
+    {
+    }
+    SName(const SNameLiteral& Literal);
+
+    // Name of String if it has been interned before, the empty name otherwise. Never adds to the table.
+    static SName Find(std::string_view String);
+
+    inline uint32 GetId() const
+    {
+        return Id;
+    }
+
+    inline bool IsNone() const
+    {
+        return Id == 0;
+    }
+
+    std::string_view ToString() const;
+
+    // The interned string is null terminated.
+    const char* GetData() const;
+
+    bool EqualsNoCase(SName Other) const;
+
+    bool operator==(SName Other) const { return Id == Other.Id; }
+    bool operator!=(SName Other) const { return Id != Other.Id; }
+
+    // Orders by id, which is stable for the process but unrelated to the strings.
+    bool operator<(SName Other) const { return Id < Other.Id; }
+
+private:
+    friend struct SNameNoCase;
+
+    uint32 Id = 0;
+};
+
+/* Name compared and hashed ignoring ASCII case. Holds the id of the lower case spelling. */
+struct SNameNoCase
+{
+    constexpr SNameNoCase() = default;
+
+    SNameNoCase(SName Name);
+    SNameNoCase(std::string_view String);
+    SNameNoCase(const char* String)
+        : SNameNoCase(std::string_view(String))
+    {
+    }
+
+    inline uint32 GetId() const
+    {
+        return Id;
+    }
+
+    inline SName GetName() const
+    {
+        SName Name;
+        Name.Id = Id;
+        return Name;
+    }
+
+    bool operator==(SNameNoCase Other) const { return Id == Other.Id; }
+    bool operator!=(SNameNoCase Other) const { return Id != Other.Id; }
+
+private:
+    uint32 Id = 0;
+};
+
+/* Name of a string literal, interned the first time the expression runs and cached afterwards. */
+#define RK_NAME(Literal) ([]() -> SName { static const SName CachedName { SNameLiteral(Literal) }; return CachedName; }())
+
+namespace std
+{
+    template <typename T> struct hash;
+
+    template<>
+    struct hash<SName>
+    {
+        std::size_t operator()(SName Name) const noexcept
+        {
+            return static_cast<std::size_t>(Hash::Mix64(Name.GetId()));
+        }
+    };
+
+    template<>
+    struct hash<SNameNoCase>
+    {
+        std::size_t operator()(SNameNoCase Name) const noexcept
+        {
+            return static_cast<std::size_t>(Hash::Mix64(Name.GetId()));
+        }
+    };
+};
+
+inline uint64 GetTypeHash(SName Name)
+{
+    return Name.GetId();
+}
+
+inline uint64 GetTypeHash(SNameNoCase Name)
+{
+    return Name.GetId();
+}
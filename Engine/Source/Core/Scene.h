@@ -1,7 +1,9 @@
 ﻿#pragma once
 
 #include "Engine.h"
+#include "TransformHierarchy.h"
 #include "Math/MathTypes.h"
+#include "Memory/Mem.h"
 #include "Memory/Memory.h"
 
 class CScene
@@ -9,14 +11,30 @@ class CScene
 public:
     void Tick(float DeltaTime)
     {
+        RK_MEMORY_SCOPE(Scene);
+
+        Transforms.Update(TransformParallelFor);
+        Metrics.UpdatedTransformCount = Transforms.GetNumUpdated();
+    }
+
+    inline CTransformHierarchy& GetTransforms()
+    {
+        return Transforms;
     }
 
     struct SMetrics
     {
         uint32 CurrentActorCount;
         uint32 TotalActorCount;
+        uint32 UpdatedTransformCount;
     };
     SMetrics Metrics;
+
+    // Set by the application to spread large transform updates over its worker threads.
+    CTransformHierarchy::FParallelFor TransformParallelFor;
+
+private:
+    CTransformHierarchy Transforms;
 };
 
 static inline CScene* GetScene()
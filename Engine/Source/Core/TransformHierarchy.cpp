@@ -0,0 +1,472 @@
+#include "EnginePCH.h"
+#include "TransformHierarchy.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "Core/Assert.h"
+
+namespace
+{
+    // Changed nodes are turned into local matrices through the batch kernel this many at a time.
+    static constexpr uint32 MaxRunLength = 64;
+
+    template<typename TNodeArray, size_t... Streams>
+    static inline void CopyNode(TNodeArray& Target, const TNodeArray& Source, size_t Index, std::index_sequence<Streams...>)
+    {
+        Target.Emplace(Source.template Get<Streams>(Index)...);
+    }
+}
+
+CTransformHierarchy::CTransformHierarchy()
+{
+    LevelStarts.Push(0);
+}
+
+STransformHandle CTransformHierarchy::Create(const STransform& LocalTransform, STransformHandle Parent)
+{
+    RK_ENGINE_ASSERT(!Parent.IsSet() || IsValid(Parent), "Parent transform handle is stale.");
+
+    uint32 SlotIndex = FreeSlots;
+    if (SlotIndex != IndexNone)
+    {
+        FreeSlots = Slots[SlotIndex].DenseIndexOrNextFree;
+    }
+    else
+    {
+        RK_ENGINE_ASSERT(Slots.GetSize() < STransformHandle::IndexMask, "Transform hierarchy is out of handles.");
+        SlotIndex = static_cast<uint32>(Slots.GetSize());
+        Slots.Push(SSlot { IndexNone, 1 });
+    }
+
+    const uint32 NodeIndex = static_cast<uint32>(Nodes.GetSize());
+    const uint32 ParentIndex = Parent.IsSet() ? GetDenseIndex(Parent) : IndexNone;
+    const uint32 Depth = ParentIndex != IndexNone ? Nodes.Get<DepthStream>(ParentIndex) + 1 : 0;
+
+    // Appending keeps the order while the node belongs at the end: on the deepest level, after the last parent.
+    const uint32 NumLevels = static_cast<uint32>(LevelStarts.GetSize() - 1);
+    if (!bOrderDirty && NodeIndex > 0)
+    {
+        const uint32 LastDepth = Nodes.Get<DepthStream>(NodeIndex - 1);
+        const uint32 LastParent = Nodes.Get<ParentStream>(NodeIndex - 1);
+        bOrderDirty = Depth < LastDepth || (Depth == LastDepth && Depth > 0 && ParentIndex < LastParent);
+    }
+
+    Nodes.Emplace(ParentIndex, SlotIndex, Depth, static_cast<uint8>(LocalDirtyFlag),
+        LocalTransform.Location.X, LocalTransform.Location.Y, LocalTransform.Location.Z,
+        LocalTransform.Rotation.X, LocalTransform.Rotation.Y, LocalTransform.Rotation.Z, LocalTransform.Rotation.W,
+        LocalTransform.Scale.X, LocalTransform.Scale.Y, LocalTransform.Scale.Z,
+        SMatrix3x4f::Identity());
+
+    if (!bOrderDirty)
+    {
+        if (Depth == NumLevels)
+        {
+            LevelStarts.Push(NodeIndex + 1);
+        }
+        else
+        {
+            LevelStarts[NumLevels] = NodeIndex + 1;
+        }
+    }
+
+    SSlot& Slot = Slots[SlotIndex];
+    Slot.DenseIndexOrNextFree = NodeIndex;
+    bNeedsUpdate = true;
+    return STransformHandle(SlotIndex, Slot.Generation);
+}
+
+bool CTransformHierarchy::Destroy(STransformHandle Handle)
+{
+    if (!IsValid(Handle))
+    {
+        return false;
+    }
+
+    // Descendants are found in one forward pass, which needs parents ahead of their children.
+    if (bOrderDirty)
+    {
+        SortNodes();
+    }
+
+    const uint32 NumNodes = static_cast<uint32>(Nodes.GetSize());
+    const uint32 NodeIndex = GetDenseIndex(Handle);
+    const uint32* Parents = Nodes.GetFieldData<ParentStream>();
+    const uint32* NodeSlots = Nodes.GetFieldData<SlotStream>();
+
+    TArray<uint8>& Removed = Scratch.Removed;
+    Removed.Empty();
+    Removed.Resize(NumNodes);
+    Removed[NodeIndex] = 1;
+
+    TArray<uint32>& Order = Scratch.Order;
+    Order.Empty();
+    Order.Reserve(NumNodes);
+    for (uint32 Index = 0; Index < NumNodes; ++Index)
+    {
+        if (Index > NodeIndex && Parents[Index] != IndexNone && Removed[Parents[Index]])
+        {
+            Removed[Index] = 1;
+        }
+
+        if (!Removed[Index])
+        {
+            Order.Push(Index);
+            continue;
+        }
+
+        // Skip generation zero so a reused slot never produces the null handle.
+        SSlot& Slot = Slots[NodeSlots[Index]];
+        Slot.Generation = (Slot.Generation + 1) & STransformHandle::GenerationMask;
+        if (Slot.Generation == 0)
+        {
+            Slot.Generation = 1;
+        }
+        Slot.DenseIndexOrNextFree = FreeSlots;
+        FreeSlots = NodeSlots[Index];
+    }
+
+    Reorder(Order);
+    return true;
+}
+
+bool CTransformHierarchy::IsValid(STransformHandle Handle) const
+{
+    const uint32 SlotIndex = Handle.GetIndex();
+    return Handle.IsSet() && SlotIndex < Slots.GetSize() && Slots[SlotIndex].Generation == Handle.GetGeneration();
+}
+
+void CTransformHierarchy::SetParent(STransformHandle Handle, STransformHandle Parent)
+{
+    RK_ENGINE_ASSERT(IsValid(Handle), "Transform handle is stale.");
+    RK_ENGINE_ASSERT(!Parent.IsSet() || IsValid(Parent), "Parent transform handle is stale.");
+
+    const uint32 NodeIndex = GetDenseIndex(Handle);
+    const uint32 ParentIndex = Parent.IsSet() ? GetDenseIndex(Parent) : IndexNone;
+
+    uint32* Parents = Nodes.GetFieldData<ParentStream>();
+    for (uint32 Ancestor = ParentIndex; Ancestor != IndexNone; Ancestor = Parents[Ancestor])
+    {
+        if (Ancestor == NodeIndex)
+        {
+            RK_ENGINE_ASSERT(false, "A transform cannot be parented to itself or one of its descendants.");
+            return;
+        }
+    }
+
+    Parents[NodeIndex] = ParentIndex;
+    Nodes.GetFieldData<FlagsStream>()[NodeIndex] |= LocalDirtyFlag;
+    bOrderDirty = true;
+    bNeedsUpdate = true;
+}
+
+STransformHandle CTransformHierarchy::GetParent(STransformHandle Handle) const
+{
+    RK_ENGINE_ASSERT(IsValid(Handle), "Transform handle is stale.");
+
+    const uint32 ParentIndex = Nodes.Get<ParentStream>(GetDenseIndex(Handle));
+    if (ParentIndex == IndexNone)
+    {
+        return STransformHandle();
+    }
+
+    const uint32 SlotIndex = Nodes.Get<SlotStream>(ParentIndex);
+    return STransformHandle(SlotIndex, Slots[SlotIndex].Generation);
+}
+
+STransform CTransformHierarchy::GetLocalTransform(STransformHandle Handle) const
+{
+    RK_ENGINE_ASSERT(IsValid(Handle), "Transform handle is stale.");
+
+    const uint32 Index = GetDenseIndex(Handle);
+    return STransform(
+        SVector3f(Nodes.Get<LocationStream>(Index), Nodes.Get<LocationStream + 1>(Index), Nodes.Get<LocationStream + 2>(Index)),
+        SQuaternion(Nodes.Get<RotationStream>(Index), Nodes.Get<RotationStream + 1>(Index), Nodes.Get<RotationStream + 2>(Index), Nodes.Get<RotationStream + 3>(Index)),
+        SVector3f(Nodes.Get<ScaleStream>(Index), Nodes.Get<ScaleStream + 1>(Index), Nodes.Get<ScaleStream + 2>(Index)));
+}
+
+void CTransformHierarchy::SetLocalTransform(STransformHandle Handle, const STransform& LocalTransform)
+{
+    RK_ENGINE_ASSERT(IsValid(Handle), "Transform handle is stale.");
+
+    const uint32 Index = GetDenseIndex(Handle);
+    Nodes.Get<LocationStream>(Index) = LocalTransform.Location.X;
+    Nodes.Get<LocationStream + 1>(Index) = LocalTransform.Location.Y;
+    Nodes.Get<LocationStream + 2>(Index) = LocalTransform.Location.Z;
+    Nodes.Get<RotationStream>(Index) = LocalTransform.Rotation.X;
+    Nodes.Get<RotationStream + 1>(Index) = LocalTransform.Rotation.Y;
+    Nodes.Get<RotationStream + 2>(Index) = LocalTransform.Rotation.Z;
+    Nodes.Get<RotationStream + 3>(Index) = LocalTransform.Rotation.W;
+    Nodes.Get<ScaleStream>(Index) = LocalTransform.Scale.X;
+    Nodes.Get<ScaleStream + 1>(Index) = LocalTransform.Scale.Y;
+    Nodes.Get<ScaleStream + 2>(Index) = LocalTransform.Scale.Z;
+    Nodes.Get<FlagsStream>(Index) |= LocalDirtyFlag;
+    bNeedsUpdate = true;
+}
+
+const SMatrix3x4f& CTransformHierarchy::GetWorldMatrix(STransformHandle Handle) const
+{
+    RK_ENGINE_ASSERT(IsValid(Handle), "Transform handle is stale.");
+    return Nodes.Get<WorldStream>(GetDenseIndex(Handle));
+}
+
+void CTransformHierarchy::Update(const FParallelFor& ParallelFor)
+{
+    NumUpdated.store(0, std::memory_order_relaxed);
+    if (!bNeedsUpdate)
+    {
+        return;
+    }
+
+    if (bOrderDirty)
+    {
+        SortNodes();
+    }
+
+    // A level only reads the flags and world matrices of the level above, so its ranges are independent.
+    for (uint32 Level = 0; Level + 1 < LevelStarts.GetSize(); ++Level)
+    {
+        const uint32 Begin = LevelStarts[Level];
+        const uint32 End = LevelStarts[Level + 1];
+        const uint32 NumTasks = std::min(MaxTasksPerLevel, (End - Begin) / MinNodesPerTask);
+        if (!ParallelFor || NumTasks < 2)
+        {
+            UpdateRange(Begin, End);
+            continue;
+        }
+
+        ParallelFor(NumTasks, FParallelTask([this, Begin, End, NumTasks](uint32 TaskIndex)
+        {
+            const uint64 NumNodes = End - Begin;
+            UpdateRange(Begin + static_cast<uint32>(NumNodes * TaskIndex / NumTasks), Begin + static_cast<uint32>(NumNodes * (TaskIndex + 1) / NumTasks));
+        }));
+    }
+
+    bNeedsUpdate = false;
+}
+
+uint32 CTransformHierarchy::GetDenseIndex(STransformHandle Handle) const
+{
+    return Slots[Handle.GetIndex()].DenseIndexOrNextFree;
+}
+
+void CTransformHierarchy::UpdateRange(uint32 Begin, uint32 End)
+{
+    const uint32* Parents = Nodes.GetFieldData<ParentStream>();
+    uint8* Flags = Nodes.GetFieldData<FlagsStream>();
+    SMatrix3x4f* World = Nodes.GetFieldData<WorldStream>();
+
+    STransformSoAView Locals;
+    Locals.Location[0] = Nodes.GetFieldData<LocationStream>();
+    Locals.Location[1] = Nodes.GetFieldData<LocationStream + 1>();
+    Locals.Location[2] = Nodes.GetFieldData<LocationStream + 2>();
+    Locals.Rotation[0] = Nodes.GetFieldData<RotationStream>();
+    Locals.Rotation[1] = Nodes.GetFieldData<RotationStream + 1>();
+    Locals.Rotation[2] = Nodes.GetFieldData<RotationStream + 2>();
+    Locals.Rotation[3] = Nodes.GetFieldData<RotationStream + 3>();
+    Locals.Scale[0] = Nodes.GetFieldData<ScaleStream>();
+    Locals.Scale[1] = Nodes.GetFieldData<ScaleStream + 1>();
+    Locals.Scale[2] = Nodes.GetFieldData<ScaleStream + 2>();
+
+    SMatrix3x4f LocalMatrices[MaxRunLength];
+    uint32 NumChanged = 0;
+
+    // Local matrices of a run of consecutive changed nodes come from one batch call, then each is parented.
+    const auto FlushRun = [&](uint32 RunBegin, uint32 RunEnd)
+    {
+        STransformSoAView Run;
+        for (uint32 Component = 0; Component < 3; ++Component)
+        {
+            Run.Location[Component] = Locals.Location[Component] + RunBegin;
+            Run.Scale[Component] = Locals.Scale[Component] + RunBegin;
+        }
+        for (uint32 Component = 0; Component < 4; ++Component)
+        {
+            Run.Rotation[Component] = Locals.Rotation[Component] + RunBegin;
+        }
+        Run.Size = RunEnd - RunBegin;
+        Math::TransformToMatrixBatch(TArrayView<SMatrix3x4f>(LocalMatrices, Run.Size), Run);
+
+        for (uint32 Index = RunBegin; Index < RunEnd; ++Index)
+        {
+            const uint32 Parent = Parents[Index];
+            const SMatrix3x4f& Local = LocalMatrices[Index - RunBegin];
+            World[Index] = Parent != IndexNone ? World[Parent].MultiplyAffine(Local) : Local;
+        }
+        NumChanged += RunEnd - RunBegin;
+    };
+
+    uint32 RunBegin = IndexNone;
+    for (uint32 Index = Begin; Index < End; ++Index)
+    {
+        // Rewriting every flag also clears the ones left from the previous Update before any child reads them.
+        const uint32 Parent = Parents[Index];
+        const bool bChanged = (Flags[Index] & LocalDirtyFlag) || (Parent != IndexNone && (Flags[Parent] & WorldChangedFlag));
+        Flags[Index] = bChanged ? WorldChangedFlag : 0;
+
+        if (bChanged && RunBegin == IndexNone)
+        {
+            RunBegin = Index;
+        }
+        else if (!bChanged && RunBegin != IndexNone)
+        {
+            FlushRun(RunBegin, Index);
+            RunBegin = IndexNone;
+        }
+
+        if (RunBegin != IndexNone && Index + 1 - RunBegin == MaxRunLength)
+        {
+            FlushRun(RunBegin, Index + 1);
+            RunBegin = IndexNone;
+        }
+    }
+    if (RunBegin != IndexNone)
+    {
+        FlushRun(RunBegin, End);
+    }
+
+    NumUpdated.fetch_add(NumChanged, std::memory_order_relaxed);
+}
+
+void CTransformHierarchy::SortNodes()
+{
+    const uint32 NumNodes = static_cast<uint32>(Nodes.GetSize());
+    const uint32* Parents = Nodes.GetFieldData<ParentStream>();
+    uint32* Depths = Nodes.GetFieldData<DepthStream>();
+
+    // Depths, walking up from each node to the closest ancestor whose depth is already known.
+    for (uint32 Index = 0; Index < NumNodes; ++Index)
+    {
+        Depths[Index] = IndexNone;
+    }
+
+    TArray<uint32>& Chain = Scratch.Chain;
+    Chain.Empty();
+    uint32 NumLevels = 0;
+    for (uint32 Index = 0; Index < NumNodes; ++Index)
+    {
+        uint32 Node = Index;
+        while (Node != IndexNone && Depths[Node] == IndexNone)
+        {
+            Chain.Push(Node);
+            Node = Parents[Node];
+        }
+
+        uint32 Depth = Node != IndexNone ? Depths[Node] + 1 : 0;
+        while (!Chain.IsEmpty())
+        {
+            Depths[Chain.Pop()] = Depth++;
+        }
+        NumLevels = std::max(NumLevels, Depth);
+    }
+
+    // Counting sort by depth, then each level by the new position of the parents placed before it.
+    TArray<uint32>& Counts = Scratch.Counts;
+    Counts.Empty();
+    Counts.Resize(NumLevels + 1);
+    for (uint32 Index = 0; Index < NumNodes; ++Index)
+    {
+        ++Counts[Depths[Index] + 1];
+    }
+    for (uint32 Level = 0; Level < NumLevels; ++Level)
+    {
+        Counts[Level + 1] += Counts[Level];
+    }
+
+    TArray<uint32>& Order = Scratch.Order;
+    Order.Resize(NumNodes);
+    for (uint32 Index = 0; Index < NumNodes; ++Index)
+    {
+        Order[Counts[Depths[Index]]++] = Index;
+    }
+
+    // The parents' level is final by the time a level is sorted, so it is counted by parent position as well.
+    TArray<uint32>& NewIndex = Scratch.NewIndex;
+    TArray<uint32>& Sorted = Scratch.Sorted;
+    NewIndex.Resize(NumNodes);
+    Sorted.Resize(NumNodes);
+    uint32* OrderData = Order.GetData();
+    uint32 ParentBegin = 0;
+    uint32 LevelBegin = 0;
+    for (uint32 Level = 0; Level < NumLevels; ++Level)
+    {
+        const uint32 LevelEnd = Counts[Level];
+        if (Level > 0)
+        {
+            TArray<uint32>& ParentCounts = Scratch.ParentCounts;
+            ParentCounts.Empty();
+            ParentCounts.Resize(LevelBegin - ParentBegin + 1);
+            for (uint32 Position = LevelBegin; Position < LevelEnd; ++Position)
+            {
+                ++ParentCounts[NewIndex[Parents[OrderData[Position]]] - ParentBegin + 1];
+            }
+            for (uint32 Parent = ParentBegin; Parent < LevelBegin; ++Parent)
+            {
+                ParentCounts[Parent - ParentBegin + 1] += ParentCounts[Parent - ParentBegin];
+            }
+            for (uint32 Position = LevelBegin; Position < LevelEnd; ++Position)
+            {
+                const uint32 Node = OrderData[Position];
+                Sorted[LevelBegin + ParentCounts[NewIndex[Parents[Node]] - ParentBegin]++] = Node;
+            }
+            std::copy(Sorted.GetData() + LevelBegin, Sorted.GetData() + LevelEnd, OrderData + LevelBegin);
+        }
+        for (uint32 Position = LevelBegin; Position < LevelEnd; ++Position)
+        {
+            NewIndex[OrderData[Position]] = Position;
+        }
+        ParentBegin = LevelBegin;
+        LevelBegin = LevelEnd;
+    }
+
+    Reorder(Order);
+}
+
+void CTransformHierarchy::Reorder(const TArray<uint32>& Order)
+{
+    const uint32 NumNodes = static_cast<uint32>(Order.GetSize());
+
+    TArray<uint32>& NewIndex = Scratch.NewIndex;
+    NewIndex.Resize(Nodes.GetSize());
+
+    TNodeArray& Ordered = Scratch.Nodes;
+    Ordered.Empty();
+    Ordered.Reserve(NumNodes);
+    for (uint32 Position = 0; Position < NumNodes; ++Position)
+    {
+        NewIndex[Order[Position]] = Position;
+        CopyNode(Ordered, Nodes, Order[Position], std::make_index_sequence<TNodeArray::NumFields>());
+    }
+
+    uint32* Parents = Ordered.GetFieldData<ParentStream>();
+    const uint32* NodeSlots = Ordered.GetFieldData<SlotStream>();
+    for (uint32 Position = 0; Position < NumNodes; ++Position)
+    {
+        if (Parents[Position] != IndexNone)
+        {
+            Parents[Position] = NewIndex[Parents[Position]];
+        }
+        Slots[NodeSlots[Position]].DenseIndexOrNextFree = Position;
+    }
+
+    // The previous streams become the next scratch array instead of being freed.
+    std::swap(Nodes, Ordered);
+    bOrderDirty = false;
+    RebuildLevelStarts();
+}
+
+void CTransformHierarchy::RebuildLevelStarts()
+{
+    const uint32 NumNodes = static_cast<uint32>(Nodes.GetSize());
+    const uint32* Depths = Nodes.GetFieldData<DepthStream>();
+
+    LevelStarts.Empty();
+    for (uint32 Index = 0; Index < NumNodes; ++Index)
+    {
+        if (Index == 0 || Depths[Index] != Depths[Index - 1])
+        {
+            LevelStarts.Push(Index);
+        }
+    }
+    LevelStarts.Push(NumNodes);
+}
\ No newline at end of file
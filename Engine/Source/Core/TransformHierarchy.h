@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+
+#include "Math/MathTypes.h"
+#include "Math/Matrix.h"
+#include "Math/Transform.h"
+#include "Memory/Function.h"
+#include "Memory/HandlePool.h"
+#include "Memory/Memory.h"
+
+struct STransformNode;
+
+using STransformHandle = THandle<STransformNode>;
+
+/*
+ * Parent/child transforms stored as flat arrays in update order: sorted by depth, and within a depth by parent,
+ * so every parent precedes its children and siblings are contiguous. Update recomputes world matrices in one
+ * linear pass per depth level, and only for nodes whose local transform changed or whose parent's world matrix
+ * was recomputed in the same pass.
+ *
+ * Nodes are referenced by generational handles, their positions in the arrays change when the hierarchy is
+ * reordered. Creating a node below the deepest level or reparenting defers a reorder to the next Update or
+ * Destroy, which costs a pass over all nodes. The hierarchy itself is not thread safe.
+ */
+class CTransformHierarchy
+{
+public:
+    using FParallelTask = TFunction<void(uint32)>;
+
+    /* Runs Task(TaskIndex) for every TaskIndex in [0, NumTasks), possibly on several threads, and returns once all have finished. */
+    using FParallelFor = TFunction<void(uint32, const FParallelTask&)>;
+
+    // Levels smaller than this are updated on the calling thread.
+    static constexpr uint32 MinNodesPerTask = 1024;
+    static constexpr uint32 MaxTasksPerLevel = 64;
+
+private:
+    static constexpr uint32 IndexNone = ~0u;
+
+    enum ENodeFlags : uint8
+    {
+        LocalDirtyFlag = 1 << 0,
+
+        // Set by Update on nodes whose world matrix it recomputed, read by their children further down the pass.
+        WorldChangedFlag = 1 << 1,
+    };
+
+    // Streams of Nodes, the local transform is split into one float stream per component for the batch kernel.
+    enum ENodeStream : size_t
+    {
+        ParentStream,
+        SlotStream,
+        DepthStream,
+        FlagsStream,
+        LocationStream,
+        RotationStream = LocationStream + 3,
+        ScaleStream = RotationStream + 4,
+        WorldStream = ScaleStream + 3,
+    };
+
+    using TNodeArray = TSoAArray<uint32, uint32, uint32, uint8,
+        float, float, float,
+        float, float, float, float,
+        float, float, float,
+        SMatrix3x4f>;
+
+    struct SSlot
+    {
+        // Index into Nodes while the slot is alive, the next free slot otherwise. Freeing bumps Generation.
+        uint32 DenseIndexOrNextFree;
+
+        uint32 Generation;
+    };
+
+    TNodeArray Nodes;
+
+    TArray<SSlot> Slots;
+
+    uint32 FreeSlots = IndexNone;
+
+    // First node of every depth level, followed by the number of nodes. Only valid while the order is.
+    TArray<uint32> LevelStarts;
+
+    bool bOrderDirty = false;
+
+    bool bNeedsUpdate = false;
+
+    std::atomic<uint32> NumUpdated { 0 };
+
+    // Buffers of SortNodes, Destroy and Reorder, kept so restoring the order stops allocating once they have grown.
+    struct SScratch
+    {
+        TArray<uint32> Order;
+        TArray<uint32> NewIndex;
+        TArray<uint32> Chain;
+        TArray<uint32> Counts;
+        TArray<uint32> ParentCounts;
+        TArray<uint32> Sorted;
+        TArray<uint8> Removed;
+        TNodeArray Nodes;
+    };
+
+    SScratch Scratch;
+
+public:
+    CTransformHierarchy();
+
+    CTransformHierarchy(const CTransformHierarchy&) = delete;
+    CTransformHierarchy& operator=(const CTransformHierarchy&) = delete;
+
+    /* New node with the given local transform, a root unless Parent is set. */
+    STransformHandle Create(const STransform& LocalTransform = STransform(), STransformHandle Parent = STransformHandle());
+
+    /* Destroys the node and all of its descendants. Returns false if the handle was already stale. */
+    bool Destroy(STransformHandle Handle);
+
+    bool IsValid(STransformHandle Handle) const;
+
+    /* Moves the node and its subtree below Parent, or to the roots if Parent is not set. The local transform is kept. */
+    void SetParent(STransformHandle Handle, STransformHandle Parent);
+
+    STransformHandle GetParent(STransformHandle Handle) const;
+
+    STransform GetLocalTransform(STransformHandle Handle) const;
+
+    void SetLocalTransform(STransformHandle Handle, const STransform& LocalTransform);
+
+    /* World matrix as of the last Update. The reference is invalidated by the next Create, Destroy or Update. */
+    const SMatrix3x4f& GetWorldMatrix(STransformHandle Handle) const;
+
+    /*
+     * Brings the world matrices up to date. With ParallelFor set, each large depth level is cut into contiguous
+     * index ranges that are updated as separate tasks, levels still run one after another. A cut may fall inside a
+     * group of siblings, which is safe because a node only reads its parent on the level above.
+     */
+    void Update(const FParallelFor& ParallelFor = nullptr);
+
+    // World matrices recomputed by the last Update.
+    inline uint32 GetNumUpdated() const
+    {
+        return NumUpdated.load(std::memory_order_relaxed);
+    }
+
+    inline size_t GetSize() const
+    {
+        return Nodes.GetSize();
+    }
+
+private:
+    uint32 GetDenseIndex(STransformHandle Handle) const;
+
+    void UpdateRange(uint32 Begin, uint32 End);
+
+    // Recomputes depths and restores the update order after reparenting or out of order creation.
+    void SortNodes();
+
+    // Rebuilds Nodes from the nodes listed in Order, which must list parents before their children.
+    void Reorder(const TArray<uint32>& Order);
+
+    void RebuildLevelStarts();
+};
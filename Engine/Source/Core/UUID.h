@@ -2,6 +2,7 @@
 
 #include <cstddef>
 
+#include "Core/Hash.h"
 #include "Math/MathTypes.h"
 
 struct SUUID 
@@ -27,7 +28,12 @@ namespace std
 	{
 		std::size_t operator()(const SUUID& UUID) const noexcept
 		{
-			return (uint64)UUID;
+			return static_cast<std::size_t>(Hash::Mix64((uint64)UUID));
 		}
 	};
-};
\ No newline at end of file
+};
+
+inline uint64 GetTypeHash(const SUUID& UUID)
+{
+	return (uint64)UUID;
+}
\ No newline at end of file
@@ -1,2 +1,68 @@
 ﻿#include "EnginePCH.h"
-#include "Math.h"
\ No newline at end of file
+#include "Math.h"
+
+#include <assert.h>
+
+#include "Memory/Memory.h"
+
+namespace
+{
+    template<bool bReciprocal, EMathAccuracy Accuracy>
+    static inline SVectorRegister SqrtKernel(SVectorRegister Values)
+    {
+        return bReciprocal ? Simd::ReciprocalSqrt(Values, Accuracy) : Simd::Sqrt(Values, Accuracy);
+    }
+
+    // The accuracy is a template argument so the tier is selected once per batch rather than per register.
+    template<bool bReciprocal, EMathAccuracy Accuracy>
+    static void SqrtBatchKernel(float* Destination, const float* Source, size_t Size)
+    {
+        size_t Index = 0;
+        for (; Index + 8 <= Size; Index += 8)
+        {
+            const SVectorRegister A = SqrtKernel<bReciprocal, Accuracy>(Simd::Load(Source + Index));
+            const SVectorRegister B = SqrtKernel<bReciprocal, Accuracy>(Simd::Load(Source + Index + 4));
+            Simd::Store(Destination + Index, A);
+            Simd::Store(Destination + Index + 4, B);
+        }
+        for (; Index + 4 <= Size; Index += 4)
+        {
+            Simd::Store(Destination + Index, SqrtKernel<bReciprocal, Accuracy>(Simd::Load(Source + Index)));
+        }
+
+        // The tail goes through a register as well, so every element gets the same result it would in a full lane.
+        for (; Index < Size; ++Index)
+        {
+            Destination[Index] = Simd::GetX(SqrtKernel<bReciprocal, Accuracy>(Simd::Splat(Source[Index])));
+        }
+    }
+
+    template<bool bReciprocal>
+    static void DispatchSqrtBatch(const TArrayView<float>& Destination, const TArrayView<float>& Source, EMathAccuracy Accuracy)
+    {
+        assert(Destination.GetSize() >= Source.GetSize() && "The destination must hold every source element.");
+
+        switch (Accuracy)
+        {
+            case EMathAccuracy::Fast:
+                SqrtBatchKernel<bReciprocal, EMathAccuracy::Fast>(Destination.GetData(), Source.GetData(), Source.GetSize());
+                break;
+            case EMathAccuracy::Estimate:
+                SqrtBatchKernel<bReciprocal, EMathAccuracy::Estimate>(Destination.GetData(), Source.GetData(), Source.GetSize());
+                break;
+            default:
+                SqrtBatchKernel<bReciprocal, EMathAccuracy::Exact>(Destination.GetData(), Source.GetData(), Source.GetSize());
+                break;
+        }
+    }
+}
+
+void Math::SqrtBatch(const TArrayView<float>& Destination, const TArrayView<float>& Source, EMathAccuracy Accuracy)
+{
+    DispatchSqrtBatch<false>(Destination, Source, Accuracy);
+}
+
+void Math::InvSqrtBatch(const TArrayView<float>& Destination, const TArrayView<float>& Source, EMathAccuracy Accuracy)
+{
+    DispatchSqrtBatch<true>(Destination, Source, Accuracy);
+}
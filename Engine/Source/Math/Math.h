@@ -1,6 +1,12 @@
 ﻿#pragma once
 
+#include <cmath>
+
 #include "MathTypes.h"
+#include "VectorRegister.h"
+
+template<typename TElement>
+class TArrayView;
 
 #define GLM_ENABLE_EXPERIMENTAL
 
@@ -80,21 +86,48 @@ namespace Math
         return bIsNegative ? 1 / Result : Result;
     }
 
-    /* https://en.wikipedia.org/wiki/Fast_inverse_square_root */
+    /* Square root at the requested accuracy, see EMathAccuracy for the error bounds of each tier. */
+    inline float Sqrt(float Value, EMathAccuracy Accuracy = EMathAccuracy::Exact)
+    {
+        if (Accuracy == EMathAccuracy::Exact)
+        {
+            return std::sqrt(Value);
+        }
+        return Simd::GetX(Simd::Sqrt(Simd::Splat(Value), Accuracy));
+    }
+
+    /* Reciprocal square root at the requested accuracy, see EMathAccuracy for the error bounds of each tier. */
+    inline float InvSqrt(float Value, EMathAccuracy Accuracy = EMathAccuracy::Exact)
+    {
+        if (Accuracy == EMathAccuracy::Exact)
+        {
+            return 1.0f / std::sqrt(Value);
+        }
+        return Simd::GetX(Simd::ReciprocalSqrt(Simd::Splat(Value), Accuracy));
+    }
+
+    /* Doubles are always computed exactly, the float tiers would lose precision. */
+    inline double Sqrt(double Value, EMathAccuracy = EMathAccuracy::Exact)
+    {
+        return std::sqrt(Value);
+    }
+
+    inline double InvSqrt(double Value, EMathAccuracy = EMathAccuracy::Exact)
+    {
+        return 1.0 / std::sqrt(Value);
+    }
+
+    /* Integer and other numeric types go through an exact double square root. */
     template<typename TNumeric>
-    static TNumeric Sqrt(TNumeric Value)
+    static TNumeric Sqrt(TNumeric Value, EMathAccuracy = EMathAccuracy::Exact)
     {
-        int32 I;
-        float X2, Y;
-        constexpr float ThreeHalfs = 1.5f;
-        X2 = Value * 0.5f;
-        Y = Value;
-        I = *reinterpret_cast<int32_t*>(&Y);          // evil floating point bit level hacking
-        I = 0x5f3759df - (I >> 1);                    // what the fuck? 
-        Y = *reinterpret_cast<float*>(&I);
-        Y = Y * (ThreeHalfs - (X2 * Y * Y));          // 1st iteration
-        // Y = Y * (ThreeHalfs - (X2 * Y * Y));       // 2nd iteration, this can be removed for better performance
-    
-        return 1.0f / Y;
+        return static_cast<TNumeric>(std::sqrt(static_cast<double>(Value)));
     }
+
+    /*
+     * Destination[I] = Sqrt(Source[I]) and Destination[I] = InvSqrt(Source[I]) for every element of Source, four
+     * lanes at a time. Destination may be Source itself and must hold at least as many elements.
+     */
+    void SqrtBatch(const TArrayView<float>& Destination, const TArrayView<float>& Source, EMathAccuracy Accuracy = EMathAccuracy::Exact);
+    void InvSqrtBatch(const TArrayView<float>& Destination, const TArrayView<float>& Source, EMathAccuracy Accuracy = EMathAccuracy::Exact);
 }
@@ -14,4 +14,19 @@ typedef uint16_t uint16;
 typedef int8_t int8;
 typedef uint8_t uint8;
 
-#define PI 3.1415926535f
\ No newline at end of file
+#define PI 3.1415926535f
+
+/*
+ * Accuracy tier of the square root kernels. Bounds are maximum relative errors for positive, normal inputs.
+ * Exact: correctly rounded square root, reciprocal within 1 ulp.
+ * Fast: hardware estimate plus one Newton-Raphson step, within 2^-21 (about 4.8e-7).
+ * Estimate: hardware estimate only (refined once on NEON, whose estimate is coarser), within 2^-11 (about 4.9e-4).
+ * The Fast and Estimate tiers return 0 for Sqrt(0) and infinity for InvSqrt(0), other non-finite inputs are
+ * unspecified. The scalar backend computes every tier exactly.
+ */
+enum class EMathAccuracy : uint8
+{
+    Exact,
+    Fast,
+    Estimate
+};
@@ -1,2 +1,80 @@
 ﻿#include "EnginePCH.h"
 #include "Matrix.h"
+
+#include <assert.h>
+
+#include "Memory/Memory.h"
+
+void Math::MultiplyBatch(const TArrayView<SMatrix4x4f>& Destination, const TArrayView<SMatrix4x4f>& Left, const TArrayView<SMatrix4x4f>& Right)
+{
+    assert(Left.GetSize() == Right.GetSize() && "Both sides must hold the same number of matrices.");
+    assert(Destination.GetSize() >= Left.GetSize() && "The destination must hold every product.");
+
+    for (size_t Index = 0; Index < Left.GetSize(); ++Index)
+    {
+        MatrixInternals::Multiply(Destination.GetData()[Index].M, Left.GetData()[Index].M, Right.GetData()[Index].M);
+    }
+}
+
+void Math::MultiplyAffineBatch(const TArrayView<SMatrix3x4f>& Destination, const TArrayView<SMatrix3x4f>& Left, const TArrayView<SMatrix3x4f>& Right)
+{
+    assert(Left.GetSize() == Right.GetSize() && "Both sides must hold the same number of matrices.");
+    assert(Destination.GetSize() >= Left.GetSize() && "The destination must hold every product.");
+
+    for (size_t Index = 0; Index < Left.GetSize(); ++Index)
+    {
+        MatrixInternals::Multiply(Destination.GetData()[Index].M, Left.GetData()[Index].M, Right.GetData()[Index].M);
+    }
+}
+
+void Math::TransformBatch(const TArrayView<SVector4f>& Destination, const SMatrix4x4f& Matrix, const TArrayView<SVector4f>& Source)
+{
+    assert(Destination.GetSize() >= Source.GetSize() && "The destination must hold every source vector.");
+
+    SVectorRegister Columns[4];
+    MatrixInternals::LoadColumns(Columns, Matrix.M);
+
+    SVector4f* Output = Destination.GetData();
+    const SVector4f* Input = Source.GetData();
+    const size_t Size = Source.GetSize();
+
+    // Two independent vectors per iteration hide the latency of the multiply-add chains.
+    size_t Index = 0;
+    for (; Index + 2 <= Size; Index += 2)
+    {
+        const SVectorRegister A = MatrixInternals::TransformByColumns(Columns, Input[Index].GetRegister());
+        const SVectorRegister B = MatrixInternals::TransformByColumns(Columns, Input[Index + 1].GetRegister());
+        Simd::StoreAligned(&Output[Index].X, A);
+        Simd::StoreAligned(&Output[Index + 1].X, B);
+    }
+    if (Index < Size)
+    {
+        Simd::StoreAligned(&Output[Index].X, MatrixInternals::TransformByColumns(Columns, Input[Index].GetRegister()));
+    }
+}
+
+void Math::TransformPointBatch(const TArrayView<SVector3f>& Destination, const SMatrix3x4f& Matrix, const TArrayView<SVector3f>& Source)
+{
+    assert(Destination.GetSize() >= Source.GetSize() && "The destination must hold every source point.");
+
+    SVectorRegister Columns[4];
+    MatrixInternals::LoadColumns(Columns, Matrix.M);
+
+    SVector3f* Output = Destination.GetData();
+    const SVector3f* Input = Source.GetData();
+    const size_t Size = Source.GetSize();
+
+    // The columns of a 3x4 matrix have W = 0, so the results keep the zero padding of SVector3f.
+    size_t Index = 0;
+    for (; Index + 2 <= Size; Index += 2)
+    {
+        const SVectorRegister A = MatrixInternals::TransformPointByColumns(Columns, Input[Index].GetRegister());
+        const SVectorRegister B = MatrixInternals::TransformPointByColumns(Columns, Input[Index + 1].GetRegister());
+        Simd::StoreAligned(&Output[Index].X, A);
+        Simd::StoreAligned(&Output[Index + 1].X, B);
+    }
+    if (Index < Size)
+    {
+        Simd::StoreAligned(&Output[Index].X, MatrixInternals::TransformPointByColumns(Columns, Input[Index].GetRegister()));
+    }
+}
\ No newline at end of file
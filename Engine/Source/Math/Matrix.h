@@ -1,49 +1,652 @@
 ﻿#pragma once
 
+#include <type_traits>
+
 #include "MathTypes.h"
-#include "Memory/Memory.h"
+#include "Vector3.h"
+#include "Vector4.h"
+#include "VectorRegister.h"
+
+template<typename TElement>
+class TArrayView;
+
+template<typename TNumeric, uint32 NumRows, uint32 NumColumns>
+struct TMatrix;
 
-template<typename TNumeric>
-class TMatrix
+namespace MatrixInternals
 {
-private:
-    uint32 Rows;
+    // Float matrices with four columns keep each row in one register, at runtime they go through the Simd kernels below.
+    template<typename TNumeric, uint32 NumColumns>
+    static constexpr bool bUseRegisters = std::is_same_v<TNumeric, float> && NumColumns == 4;
+
+    template<typename TNumeric>
+    constexpr TNumeric Abs(TNumeric Value)
+    {
+        return Value < TNumeric(0) ? -Value : Value;
+    }
+
+    template<uint32 NumRows>
+    inline void LoadRows(SVectorRegister (&Registers)[NumRows], const float (&Rows)[NumRows][4])
+    {
+        for (uint32 Row = 0; Row < NumRows; ++Row)
+        {
+            Registers[Row] = Simd::LoadAligned(Rows[Row]);
+        }
+    }
 
-    uint32 Columns;
+    // Row * Right, a linear combination of the rows of Right weighted by the lanes of Row.
+    inline SVectorRegister MultiplyRow(SVectorRegister Row, const SVectorRegister (&Right)[4])
+    {
+        SVectorRegister Result = Simd::Multiply(Simd::Replicate<0>(Row), Right[0]);
+        Result = Simd::MultiplyAdd(Simd::Replicate<1>(Row), Right[1], Result);
+        Result = Simd::MultiplyAdd(Simd::Replicate<2>(Row), Right[2], Result);
+        return Simd::MultiplyAdd(Simd::Replicate<3>(Row), Right[3], Result);
+    }
+
+    // Left * Right where Right has NumRightRows rows and, for three, the implicit affine row (0, 0, 0, 1).
+    template<uint32 NumRows, uint32 NumRightRows>
+    inline void Multiply(float (&Result)[NumRows][4], const float (&Left)[NumRows][4], const float (&Right)[NumRightRows][4])
+    {
+        static_assert(NumRightRows == 4 || NumRightRows == 3, "The right matrix is 4x4 or 3x4 affine.");
 
-    TArray<TNumeric> Data;
+        SVectorRegister RightRows[4];
+        RightRows[3] = Simd::Set(0.0f, 0.0f, 0.0f, 1.0f);
+        for (uint32 Row = 0; Row < NumRightRows; ++Row)
+        {
+            RightRows[Row] = Simd::LoadAligned(Right[Row]);
+        }
 
-public:
-    TMatrix()
-        : Rows(1), Columns(1), Data()
+        for (uint32 Row = 0; Row < NumRows; ++Row)
+        {
+            Simd::StoreAligned(Result[Row], MultiplyRow(Simd::LoadAligned(Left[Row]), RightRows));
+        }
+    }
+
+    inline void Transpose4x4(float (&Result)[4][4], const float (&Rows)[4][4])
     {
+        SVectorRegister Registers[4];
+        LoadRows(Registers, Rows);
+        Simd::Transpose4(Registers[0], Registers[1], Registers[2], Registers[3]);
+        for (uint32 Row = 0; Row < 4; ++Row)
+        {
+            Simd::StoreAligned(Result[Row], Registers[Row]);
+        }
     }
 
-    TMatrix(uint32 NumOfRows, uint32 NumOfColumns)
-        : Rows(NumOfRows), Columns(NumOfColumns)
+    /*
+     * Columns of a 4x4 or 3x4 matrix, the missing fourth row of a 3x4 matrix reads as zero. Transforming many
+     * vectors by one matrix transposes it once, after which each vector is four multiply-adds.
+     */
+    template<uint32 NumRows>
+    inline void LoadColumns(SVectorRegister (&Columns)[4], const float (&Rows)[NumRows][4])
     {
-        Data.Init(Rows * Columns, TNumeric());
+        static_assert(NumRows == 4 || NumRows == 3, "Columns are loaded from 4x4 and 3x4 matrices.");
+
+        Columns[0] = Simd::LoadAligned(Rows[0]);
+        Columns[1] = Simd::LoadAligned(Rows[1]);
+        Columns[2] = Simd::LoadAligned(Rows[2]);
+        if constexpr (NumRows == 4)
+        {
+            Columns[3] = Simd::LoadAligned(Rows[3]);
+        }
+        else
+        {
+            Columns[3] = Simd::Zero();
+        }
+        Simd::Transpose4(Columns[0], Columns[1], Columns[2], Columns[3]);
     }
 
-    ~TMatrix()
+    inline SVectorRegister TransformByColumns(const SVectorRegister (&Columns)[4], SVectorRegister Vector)
     {
+        SVectorRegister Result = Simd::Multiply(Simd::Replicate<0>(Vector), Columns[0]);
+        Result = Simd::MultiplyAdd(Simd::Replicate<1>(Vector), Columns[1], Result);
+        Result = Simd::MultiplyAdd(Simd::Replicate<2>(Vector), Columns[2], Result);
+        return Simd::MultiplyAdd(Simd::Replicate<3>(Vector), Columns[3], Result);
     }
 
-    inline TNumeric GetValue(const uint32 Row, const uint32 Column) const
+    // X, Y and Z transformed as a point, W of the result is not meaningful.
+    inline SVectorRegister TransformPointByColumns(const SVectorRegister (&Columns)[4], SVectorRegister Point)
     {
-        return Data[Row * Columns + Column];
+        SVectorRegister Result = Simd::MultiplyAdd(Simd::Replicate<0>(Point), Columns[0], Columns[3]);
+        Result = Simd::MultiplyAdd(Simd::Replicate<1>(Point), Columns[1], Result);
+        return Simd::MultiplyAdd(Simd::Replicate<2>(Point), Columns[2], Result);
     }
 
-    inline void SetValue(const uint32 Row, const uint32 Column, TNumeric Value)
+    inline SVectorRegister TransformVectorByColumns(const SVectorRegister (&Columns)[4], SVectorRegister Vector)
     {
-        Data[Row * Columns + Column] = Value;
+        SVectorRegister Result = Simd::Multiply(Simd::Replicate<0>(Vector), Columns[0]);
+        Result = Simd::MultiplyAdd(Simd::Replicate<1>(Vector), Columns[1], Result);
+        return Simd::MultiplyAdd(Simd::Replicate<2>(Vector), Columns[2], Result);
     }
-    
+
+    // Products of 2x2 matrices packed row-major into one register: A * B, Adjugate(A) * B and A * Adjugate(B).
+    inline SVectorRegister Multiply2x2(SVectorRegister A, SVectorRegister B)
+    {
+        return Simd::MultiplyAdd(A, Simd::Swizzle<0, 3, 0, 3>(B), Simd::Multiply(Simd::Swizzle<1, 0, 3, 2>(A), Simd::Swizzle<2, 1, 2, 1>(B)));
+    }
+
+    inline SVectorRegister AdjugateMultiply2x2(SVectorRegister A, SVectorRegister B)
+    {
+        return Simd::Subtract(Simd::Multiply(Simd::Swizzle<3, 3, 0, 0>(A), B), Simd::Multiply(Simd::Swizzle<1, 1, 2, 2>(A), Simd::Swizzle<2, 3, 0, 1>(B)));
+    }
+
+    inline SVectorRegister MultiplyAdjugate2x2(SVectorRegister A, SVectorRegister B)
+    {
+        return Simd::Subtract(Simd::Multiply(A, Simd::Swizzle<3, 0, 3, 0>(B)), Simd::Multiply(Simd::Swizzle<1, 0, 3, 2>(A), Simd::Swizzle<2, 1, 2, 1>(B)));
+    }
+
+    /*
+     * Inverse of a 4x4 matrix through its 2x2 blocks | A B ; C D |, which needs no scalar code or divisions beyond
+     * the reciprocal of the determinant.
+     */
+    inline void Inverse4x4(float (&Result)[4][4], const float (&Rows)[4][4])
+    {
+        SVectorRegister Registers[4];
+        LoadRows(Registers, Rows);
+
+        const SVectorRegister A = Simd::Shuffle<0, 1, 0, 1>(Registers[0], Registers[1]);
+        const SVectorRegister B = Simd::Shuffle<2, 3, 2, 3>(Registers[0], Registers[1]);
+        const SVectorRegister C = Simd::Shuffle<0, 1, 0, 1>(Registers[2], Registers[3]);
+        const SVectorRegister D = Simd::Shuffle<2, 3, 2, 3>(Registers[2], Registers[3]);
+
+        // Determinants of A, B, C and D in the four lanes.
+        const SVectorRegister BlockDeterminants = Simd::Subtract(
+            Simd::Multiply(Simd::Shuffle<0, 2, 0, 2>(Registers[0], Registers[2]), Simd::Shuffle<1, 3, 1, 3>(Registers[1], Registers[3])),
+            Simd::Multiply(Simd::Shuffle<1, 3, 1, 3>(Registers[0], Registers[2]), Simd::Shuffle<0, 2, 0, 2>(Registers[1], Registers[3])));
+        const SVectorRegister DeterminantA = Simd::Replicate<0>(BlockDeterminants);
+        const SVectorRegister DeterminantB = Simd::Replicate<1>(BlockDeterminants);
+        const SVectorRegister DeterminantC = Simd::Replicate<2>(BlockDeterminants);
+        const SVectorRegister DeterminantD = Simd::Replicate<3>(BlockDeterminants);
+
+        const SVectorRegister AdjugateDC = AdjugateMultiply2x2(D, C);
+        const SVectorRegister AdjugateAB = AdjugateMultiply2x2(A, B);
+
+        // Adjugates of the blocks of the inverse, scaled by the determinant.
+        SVectorRegister X = Simd::Subtract(Simd::Multiply(DeterminantD, A), Multiply2x2(B, AdjugateDC));
+        SVectorRegister W = Simd::Subtract(Simd::Multiply(DeterminantA, D), Multiply2x2(C, AdjugateAB));
+        SVectorRegister Y = Simd::Subtract(Simd::Multiply(DeterminantB, C), MultiplyAdjugate2x2(D, AdjugateAB));
+        SVectorRegister Z = Simd::Subtract(Simd::Multiply(DeterminantC, B), MultiplyAdjugate2x2(A, AdjugateDC));
+
+        // |M| = |A| |D| + |B| |C| - Trace(Adjugate(A) B Adjugate(D) C)
+        const SVectorRegister Trace = Simd::HorizontalAdd(Simd::Multiply(AdjugateAB, Simd::Swizzle<0, 2, 1, 3>(AdjugateDC)));
+        const SVectorRegister Determinant = Simd::Subtract(Simd::MultiplyAdd(DeterminantB, DeterminantC, Simd::Multiply(DeterminantA, DeterminantD)), Trace);
+
+        // The signs undo the adjugate of each block, the shuffles below swap its diagonal.
+        const SVectorRegister ReciprocalDeterminant = Simd::Divide(Simd::Set(1.0f, -1.0f, -1.0f, 1.0f), Determinant);
+        X = Simd::Multiply(X, ReciprocalDeterminant);
+        Y = Simd::Multiply(Y, ReciprocalDeterminant);
+        Z = Simd::Multiply(Z, ReciprocalDeterminant);
+        W = Simd::Multiply(W, ReciprocalDeterminant);
+
+        Simd::StoreAligned(Result[0], Simd::Shuffle<3, 1, 3, 1>(X, Y));
+        Simd::StoreAligned(Result[1], Simd::Shuffle<2, 0, 2, 0>(X, Y));
+        Simd::StoreAligned(Result[2], Simd::Shuffle<3, 1, 3, 1>(Z, W));
+        Simd::StoreAligned(Result[3], Simd::Shuffle<2, 0, 2, 0>(Z, W));
+    }
+
+    /*
+     * Inverse of a 3x4 affine matrix. The columns of the inverse of the 3x3 part are the cross products of its rows
+     * over the determinant, the translation is the negated inverse applied to the original one.
+     */
+    inline void InverseAffine3x4(float (&Result)[3][4], const float (&Rows)[3][4])
+    {
+        SVectorRegister Registers[3];
+        LoadRows(Registers, Rows);
+
+        const SVectorRegister Row0 = Simd::ClearW(Registers[0]);
+        const SVectorRegister Row1 = Simd::ClearW(Registers[1]);
+        const SVectorRegister Row2 = Simd::ClearW(Registers[2]);
+
+        SVectorRegister Column0 = Simd::Cross3(Row1, Row2);
+        SVectorRegister Column1 = Simd::Cross3(Row2, Row0);
+        SVectorRegister Column2 = Simd::Cross3(Row0, Row1);
+
+        const SVectorRegister ReciprocalDeterminant = Simd::Divide(Simd::Splat(1.0f), Simd::Dot3(Row0, Column0));
+        Column0 = Simd::ClearW(Simd::Multiply(Column0, ReciprocalDeterminant));
+        Column1 = Simd::ClearW(Simd::Multiply(Column1, ReciprocalDeterminant));
+        Column2 = Simd::ClearW(Simd::Multiply(Column2, ReciprocalDeterminant));
+
+        SVectorRegister Translation = Simd::Multiply(Simd::Replicate<3>(Registers[0]), Column0);
+        Translation = Simd::MultiplyAdd(Simd::Replicate<3>(Registers[1]), Column1, Translation);
+        Translation = Simd::Negate(Simd::MultiplyAdd(Simd::Replicate<3>(Registers[2]), Column2, Translation));
+
+        Simd::Transpose4(Column0, Column1, Column2, Translation);
+        Simd::StoreAligned(Result[0], Column0);
+        Simd::StoreAligned(Result[1], Column1);
+        Simd::StoreAligned(Result[2], Column2);
+    }
+}
+
+/*
+ * Row-major matrix with its dimensions fixed at compile time. The elements are stored inline, so a matrix never
+ * allocates and copies like a plain array. Vectors are columns: Matrix * Vector transforms the vector, and A * B
+ * applies B first. A 3x4 matrix is an affine transform whose fourth row is implicitly (0, 0, 0, 1).
+ *
+ * Every operation is constexpr, with loops over the fixed dimensions the compiler unrolls. At runtime float
+ * matrices with four columns keep each row in a SIMD register, which covers the 4x4 and 3x4 transforms.
+ */
+template<typename TNumeric, uint32 NumRows, uint32 NumColumns>
+struct alignas(MatrixInternals::bUseRegisters<TNumeric, NumColumns> ? 16 : alignof(TNumeric)) TMatrix
+{
+    static_assert(NumRows > 0 && NumColumns > 0, "A matrix has at least one row and one column.");
+
+    static constexpr uint32 Rows = NumRows;
+    static constexpr uint32 Columns = NumColumns;
+
+    TNumeric M[NumRows][NumColumns];
+
+    constexpr TMatrix()
+        : M {}
+    {
+    }
+
+    /* Elements in row-major order, one per element of the matrix. */
+    template<typename... TValues, typename = std::enable_if_t<sizeof...(TValues) == NumRows * NumColumns && (std::is_arithmetic_v<TValues> && ...)>>
+    constexpr TMatrix(TValues... Values)
+        : M { static_cast<TNumeric>(Values)... }
+    {
+    }
+
+    /* Ones on the diagonal, which for a 3x4 matrix is the affine identity. */
+    static constexpr TMatrix Identity()
+    {
+        TMatrix Result;
+        for (uint32 Index = 0; Index < NumRows && Index < NumColumns; ++Index)
+        {
+            Result.M[Index][Index] = TNumeric(1);
+        }
+        return Result;
+    }
+
+    static constexpr TMatrix Zero()
+    {
+        return TMatrix();
+    }
+
+    constexpr TNumeric& operator()(uint32 Row, uint32 Column) { return M[Row][Column]; }
+    constexpr TNumeric operator()(uint32 Row, uint32 Column) const { return M[Row][Column]; }
+
+    constexpr TNumeric GetValue(uint32 Row, uint32 Column) const
+    {
+        return M[Row][Column];
+    }
+
+    constexpr void SetValue(uint32 Row, uint32 Column, TNumeric Value)
+    {
+        M[Row][Column] = Value;
+    }
+
+    constexpr TMatrix operator+(const TMatrix& Other) const
+    {
+        TMatrix Result;
+        for (uint32 Row = 0; Row < NumRows; ++Row)
+        {
+            for (uint32 Column = 0; Column < NumColumns; ++Column)
+            {
+                Result.M[Row][Column] = M[Row][Column] + Other.M[Row][Column];
+            }
+        }
+        return Result;
+    }
+
+    constexpr TMatrix operator-(const TMatrix& Other) const
+    {
+        TMatrix Result;
+        for (uint32 Row = 0; Row < NumRows; ++Row)
+        {
+            for (uint32 Column = 0; Column < NumColumns; ++Column)
+            {
+                Result.M[Row][Column] = M[Row][Column] - Other.M[Row][Column];
+            }
+        }
+        return Result;
+    }
+
+    constexpr TMatrix operator*(TNumeric Scalar) const
+    {
+        TMatrix Result;
+        for (uint32 Row = 0; Row < NumRows; ++Row)
+        {
+            for (uint32 Column = 0; Column < NumColumns; ++Column)
+            {
+                Result.M[Row][Column] = M[Row][Column] * Scalar;
+            }
+        }
+        return Result;
+    }
+
+    template<uint32 OtherColumns>
+    constexpr TMatrix<TNumeric, NumRows, OtherColumns> operator*(const TMatrix<TNumeric, NumColumns, OtherColumns>& Other) const
+    {
+        TMatrix<TNumeric, NumRows, OtherColumns> Result;
+        if constexpr (MatrixInternals::bUseRegisters<TNumeric, NumColumns> && OtherColumns == 4)
+        {
+            if (!RK_IS_CONSTANT_EVALUATED())
+            {
+                MatrixInternals::Multiply(Result.M, M, Other.M);
+                return Result;
+            }
+        }
+
+        for (uint32 Row = 0; Row < NumRows; ++Row)
+        {
+            for (uint32 Column = 0; Column < OtherColumns; ++Column)
+            {
+                TNumeric Sum = TNumeric(0);
+                for (uint32 Index = 0; Index < NumColumns; ++Index)
+                {
+                    Sum += M[Row][Index] * Other.M[Index][Column];
+                }
+                Result.M[Row][Column] = Sum;
+            }
+        }
+        return Result;
+    }
+
+    constexpr TMatrix& operator+=(const TMatrix& Other) { return *this = *this + Other; }
+    constexpr TMatrix& operator-=(const TMatrix& Other) { return *this = *this - Other; }
+    constexpr TMatrix& operator*=(TNumeric Scalar) { return *this = *this * Scalar; }
+
+    /* Only for square matrices, where the product keeps the dimensions. */
+    constexpr TMatrix& operator*=(const TMatrix& Other) { return *this = *this * Other; }
+
+    constexpr bool operator==(const TMatrix& Other) const
+    {
+        for (uint32 Row = 0; Row < NumRows; ++Row)
+        {
+            for (uint32 Column = 0; Column < NumColumns; ++Column)
+            {
+                if (M[Row][Column] != Other.M[Row][Column])
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    constexpr bool operator!=(const TMatrix& Other) const
+    {
+        return !(*this == Other);
+    }
+
+    constexpr TMatrix<TNumeric, NumColumns, NumRows> GetTransposed() const
+    {
+        TMatrix<TNumeric, NumColumns, NumRows> Result;
+        if constexpr (MatrixInternals::bUseRegisters<TNumeric, NumColumns> && NumRows == 4)
+        {
+            if (!RK_IS_CONSTANT_EVALUATED())
+            {
+                MatrixInternals::Transpose4x4(Result.M, M);
+                return Result;
+            }
+        }
+
+        for (uint32 Row = 0; Row < NumRows; ++Row)
+        {
+            for (uint32 Column = 0; Column < NumColumns; ++Column)
+            {
+                Result.M[Column][Row] = M[Row][Column];
+            }
+        }
+        return Result;
+    }
+
+    constexpr TNumeric GetDeterminant() const
+    {
+        static_assert(NumRows == NumColumns, "Only square matrices have a determinant.");
+
+        // Gaussian elimination with partial pivoting, the determinant is the product of the pivots.
+        TMatrix Work = *this;
+        TNumeric Determinant = TNumeric(1);
+        for (uint32 Pivot = 0; Pivot < NumRows; ++Pivot)
+        {
+            const uint32 PivotRow = Work.FindPivotRow(Pivot);
+            if (Work.M[PivotRow][Pivot] == TNumeric(0))
+            {
+                return TNumeric(0);
+            }
+            if (PivotRow != Pivot)
+            {
+                Work.SwapRows(PivotRow, Pivot);
+                Determinant = -Determinant;
+            }
+
+            Determinant *= Work.M[Pivot][Pivot];
+            for (uint32 Row = Pivot + 1; Row < NumRows; ++Row)
+            {
+                const TNumeric Factor = Work.M[Row][Pivot] / Work.M[Pivot][Pivot];
+                for (uint32 Column = Pivot; Column < NumColumns; ++Column)
+                {
+                    Work.M[Row][Column] -= Factor * Work.M[Pivot][Column];
+                }
+            }
+        }
+        return Determinant;
+    }
+
+    /* Inverse of a square matrix. Singular matrices have no inverse, their result is not finite. */
+    constexpr TMatrix GetInverse() const
+    {
+        static_assert(NumRows == NumColumns, "Only square matrices have an inverse, see GetAffineInverse for 3x4.");
+
+        if constexpr (MatrixInternals::bUseRegisters<TNumeric, NumColumns>)
+        {
+            if (!RK_IS_CONSTANT_EVALUATED())
+            {
+                TMatrix Result;
+                MatrixInternals::Inverse4x4(Result.M, M);
+                return Result;
+            }
+        }
+
+        // Gauss-Jordan elimination with partial pivoting, applying the same row operations to the identity.
+        TMatrix Work = *this;
+        TMatrix Result = Identity();
+        for (uint32 Pivot = 0; Pivot < NumRows; ++Pivot)
+        {
+            const uint32 PivotRow = Work.FindPivotRow(Pivot);
+            Work.SwapRows(PivotRow, Pivot);
+            Result.SwapRows(PivotRow, Pivot);
+
+            const TNumeric Scale = TNumeric(1) / Work.M[Pivot][Pivot];
+            for (uint32 Column = 0; Column < NumColumns; ++Column)
+            {
+                Work.M[Pivot][Column] *= Scale;
+                Result.M[Pivot][Column] *= Scale;
+            }
+
+            for (uint32 Row = 0; Row < NumRows; ++Row)
+            {
+                if (Row == Pivot)
+                {
+                    continue;
+                }
+
+                const TNumeric Factor = Work.M[Row][Pivot];
+                for (uint32 Column = 0; Column < NumColumns; ++Column)
+                {
+                    Work.M[Row][Column] -= Factor * Work.M[Pivot][Column];
+                    Result.M[Row][Column] -= Factor * Result.M[Pivot][Column];
+                }
+            }
+        }
+        return Result;
+    }
+
+    /*
+     * This affine matrix followed by Other, i.e. this * Other with the implicit last row of both. Affine matrices
+     * have one more column than rows.
+     */
+    constexpr TMatrix MultiplyAffine(const TMatrix& Other) const
+    {
+        static_assert(NumRows + 1 == NumColumns, "Affine matrices have one more column than rows.");
+
+        TMatrix Result;
+        if constexpr (MatrixInternals::bUseRegisters<TNumeric, NumColumns>)
+        {
+            if (!RK_IS_CONSTANT_EVALUATED())
+            {
+                MatrixInternals::Multiply(Result.M, M, Other.M);
+                return Result;
+            }
+        }
+
+        for (uint32 Row = 0; Row < NumRows; ++Row)
+        {
+            for (uint32 Column = 0; Column < NumColumns; ++Column)
+            {
+                // The implicit row contributes only to the translation column.
+                TNumeric Sum = Column == NumRows ? M[Row][NumRows] : TNumeric(0);
+                for (uint32 Index = 0; Index < NumRows; ++Index)
+                {
+                    Sum += M[Row][Index] * Other.M[Index][Column];
+                }
+                Result.M[Row][Column] = Sum;
+            }
+        }
+        return Result;
+    }
+
+    /* Inverse of an affine matrix, cheaper than inverting the full square matrix. Not finite if it is singular. */
+    constexpr TMatrix GetAffineInverse() const
+    {
+        static_assert(NumRows + 1 == NumColumns, "Affine matrices have one more column than rows.");
+
+        TMatrix Result;
+        if constexpr (MatrixInternals::bUseRegisters<TNumeric, NumColumns>)
+        {
+            if (!RK_IS_CONSTANT_EVALUATED())
+            {
+                MatrixInternals::InverseAffine3x4(Result.M, M);
+                return Result;
+            }
+        }
+
+        TMatrix<TNumeric, NumRows, NumRows> Linear;
+        for (uint32 Row = 0; Row < NumRows; ++Row)
+        {
+            for (uint32 Column = 0; Column < NumRows; ++Column)
+            {
+                Linear.M[Row][Column] = M[Row][Column];
+            }
+        }
+
+        const TMatrix<TNumeric, NumRows, NumRows> InverseLinear = Linear.GetInverse();
+        for (uint32 Row = 0; Row < NumRows; ++Row)
+        {
+            TNumeric Translation = TNumeric(0);
+            for (uint32 Column = 0; Column < NumRows; ++Column)
+            {
+                Result.M[Row][Column] = InverseLinear.M[Row][Column];
+                Translation -= InverseLinear.M[Row][Column] * M[Column][NumRows];
+            }
+            Result.M[Row][NumRows] = Translation;
+        }
+        return Result;
+    }
+
+    /* Point transformed by a 4x4 or 3x4 matrix, with W taken as one. The fourth row of a 4x4 matrix is ignored. */
+    inline TVector3<TNumeric> TransformPoint(const TVector3<TNumeric>& Point) const
+    {
+        static_assert(NumColumns == 4 && (NumRows == 3 || NumRows == 4), "Points are transformed by 4x4 and 3x4 matrices.");
+
+        if constexpr (MatrixInternals::bUseRegisters<TNumeric, NumColumns>)
+        {
+            SVectorRegister MatrixColumns[4];
+            MatrixInternals::LoadColumns(MatrixColumns, M);
+            return TVector3<TNumeric>(MatrixInternals::TransformPointByColumns(MatrixColumns, Point.GetRegister()));
+        }
+        else
+        {
+            return TVector3<TNumeric>(
+                M[0][0] * Point.X + M[0][1] * Point.Y + M[0][2] * Point.Z + M[0][3],
+                M[1][0] * Point.X + M[1][1] * Point.Y + M[1][2] * Point.Z + M[1][3],
+                M[2][0] * Point.X + M[2][1] * Point.Y + M[2][2] * Point.Z + M[2][3]);
+        }
+    }
+
+    /* Direction transformed by a 4x4 or 3x4 matrix, with W taken as zero so the translation does not apply. */
+    inline TVector3<TNumeric> TransformVector(const TVector3<TNumeric>& Vector) const
+    {
+        static_assert(NumColumns == 4 && (NumRows == 3 || NumRows == 4), "Vectors are transformed by 4x4 and 3x4 matrices.");
+
+        if constexpr (MatrixInternals::bUseRegisters<TNumeric, NumColumns>)
+        {
+            SVectorRegister MatrixColumns[4];
+            MatrixInternals::LoadColumns(MatrixColumns, M);
+            return TVector3<TNumeric>(MatrixInternals::TransformVectorByColumns(MatrixColumns, Vector.GetRegister()));
+        }
+        else
+        {
+            return TVector3<TNumeric>(
+                M[0][0] * Vector.X + M[0][1] * Vector.Y + M[0][2] * Vector.Z,
+                M[1][0] * Vector.X + M[1][1] * Vector.Y + M[1][2] * Vector.Z,
+                M[2][0] * Vector.X + M[2][1] * Vector.Y + M[2][2] * Vector.Z);
+        }
+    }
+
 private:
-    
+    template<typename, uint32, uint32>
+    friend struct TMatrix;
+
+    // Row at or below Column with the largest magnitude in Column.
+    constexpr uint32 FindPivotRow(uint32 Column) const
+    {
+        uint32 PivotRow = Column;
+        for (uint32 Row = Column + 1; Row < NumRows; ++Row)
+        {
+            if (MatrixInternals::Abs(M[Row][Column]) > MatrixInternals::Abs(M[PivotRow][Column]))
+            {
+                PivotRow = Row;
+            }
+        }
+        return PivotRow;
+    }
+
+    constexpr void SwapRows(uint32 RowA, uint32 RowB)
+    {
+        for (uint32 Column = 0; Column < NumColumns; ++Column)
+        {
+            const TNumeric Value = M[RowA][Column];
+            M[RowA][Column] = M[RowB][Column];
+            M[RowB][Column] = Value;
+        }
+    }
 };
 
-//using SMatrix1x1f = TMatrix<float, 1, 1>;
-//using SMatrix2x2f = TMatrix<float, 2, 2>;
-//using SMatrix3x3f = TMatrix<float, 3, 3>;
-//using SMatrix4x4f = TMatrix<float, 4, 4>;
+template<typename TNumeric, uint32 NumRows, uint32 NumColumns>
+constexpr TMatrix<TNumeric, NumRows, NumColumns> operator*(TNumeric Scalar, const TMatrix<TNumeric, NumRows, NumColumns>& Matrix)
+{
+    return Matrix * Scalar;
+}
+
+using SMatrix2x2f = TMatrix<float, 2, 2>;
+using SMatrix3x3f = TMatrix<float, 3, 3>;
+using SMatrix3x4f = TMatrix<float, 3, 4>;
+using SMatrix4x4f = TMatrix<float, 4, 4>;
+using SMatrix4x4d = TMatrix<double, 4, 4>;
+
+inline SVector4f operator*(const SMatrix4x4f& Matrix, const SVector4f& Vector)
+{
+    SVectorRegister Columns[4];
+    MatrixInternals::LoadColumns(Columns, Matrix.M);
+    return SVector4f(MatrixInternals::TransformByColumns(Columns, Vector.GetRegister()));
+}
+
+namespace Math
+{
+    /*
+     * Batch kernels over arrays of matrices and vectors. Each Destination must hold at least as many elements as
+     * the sources, and may alias one of them.
+     *
+     * MultiplyBatch:           Destination[I] = Left[I] * Right[I]
+     * MultiplyAffineBatch:     Destination[I] = Left[I].MultiplyAffine(Right[I])
+     * TransformBatch:          Destination[I] = Matrix * Source[I]
+     * TransformPointBatch:     Destination[I] = Matrix.TransformPoint(Source[I])
+     */
+    void MultiplyBatch(const TArrayView<SMatrix4x4f>& Destination, const TArrayView<SMatrix4x4f>& Left, const TArrayView<SMatrix4x4f>& Right);
+    void MultiplyAffineBatch(const TArrayView<SMatrix3x4f>& Destination, const TArrayView<SMatrix3x4f>& Left, const TArrayView<SMatrix3x4f>& Right);
+    void TransformBatch(const TArrayView<SVector4f>& Destination, const SMatrix4x4f& Matrix, const TArrayView<SVector4f>& Source);
+    void TransformPointBatch(const TArrayView<SVector3f>& Destination, const SMatrix3x4f& Matrix, const TArrayView<SVector3f>& Source);
+}
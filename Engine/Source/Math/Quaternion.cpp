@@ -0,0 +1,2 @@
+#include "EnginePCH.h"
+#include "Quaternion.h"
\ No newline at end of file
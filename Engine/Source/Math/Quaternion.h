@@ -0,0 +1,189 @@
+#pragma once
+
+#include <cmath>
+
+#include "MathTypes.h"
+#include "Vector3.h"
+#include "VectorRegister.h"
+
+/*
+ * Rotation as a unit quaternion, X, Y and Z being the vector part and W the scalar part. Like the matrices, A * B
+ * rotates by B first and then by A. Operations that build or combine rotations expect unit quaternions.
+ */
+struct alignas(16) SQuaternion
+{
+    float X;
+
+    float Y;
+
+    float Z;
+
+    float W;
+
+    SQuaternion()
+        : X(0.0f), Y(0.0f), Z(0.0f), W(1.0f)
+    {
+    }
+
+    SQuaternion(float InX, float InY, float InZ, float InW)
+        : X(InX), Y(InY), Z(InZ), W(InW)
+    {
+    }
+
+    explicit SQuaternion(SVectorRegister Register)
+    {
+        Simd::StoreAligned(&X, Register);
+    }
+
+    inline SVectorRegister GetRegister() const
+    {
+        return Simd::LoadAligned(&X);
+    }
+
+    static inline SQuaternion Identity()
+    {
+        return SQuaternion();
+    }
+
+    /* Rotation by Angle radians around Axis, which must be of unit length. */
+    static inline SQuaternion FromAxisAngle(const SVector3f& Axis, float Angle)
+    {
+        const float HalfAngle = 0.5f * Angle;
+        const float Sine = std::sin(HalfAngle);
+        return SQuaternion(Axis.X * Sine, Axis.Y * Sine, Axis.Z * Sine, std::cos(HalfAngle));
+    }
+
+    /* Rotation by Angles radians around X, then around Y, then around Z. */
+    static inline SQuaternion FromEuler(const SVector3f& Angles)
+    {
+        const float SinX = std::sin(0.5f * Angles.X), CosX = std::cos(0.5f * Angles.X);
+        const float SinY = std::sin(0.5f * Angles.Y), CosY = std::cos(0.5f * Angles.Y);
+        const float SinZ = std::sin(0.5f * Angles.Z), CosZ = std::cos(0.5f * Angles.Z);
+        return SQuaternion(
+            SinX * CosY * CosZ - CosX * SinY * SinZ,
+            CosX * SinY * CosZ + SinX * CosY * SinZ,
+            CosX * CosY * SinZ - SinX * SinY * CosZ,
+            CosX * CosY * CosZ + SinX * SinY * SinZ);
+    }
+
+    /* Rotation by Other followed by this one. */
+    inline SQuaternion operator*(const SQuaternion& Other) const
+    {
+        const SVectorRegister A = GetRegister();
+        const SVectorRegister B = Other.GetRegister();
+
+        // Hamilton product, one register per component of A with the signs folded into constants.
+        SVectorRegister Result = Simd::Multiply(Simd::Replicate<3>(A), B);
+        Result = Simd::MultiplyAdd(Simd::Multiply(Simd::Replicate<0>(A), Simd::Set(1.0f, -1.0f, 1.0f, -1.0f)), Simd::Swizzle<3, 2, 1, 0>(B), Result);
+        Result = Simd::MultiplyAdd(Simd::Multiply(Simd::Replicate<1>(A), Simd::Set(1.0f, 1.0f, -1.0f, -1.0f)), Simd::Swizzle<2, 3, 0, 1>(B), Result);
+        Result = Simd::MultiplyAdd(Simd::Multiply(Simd::Replicate<2>(A), Simd::Set(-1.0f, 1.0f, 1.0f, -1.0f)), Simd::Swizzle<1, 0, 3, 2>(B), Result);
+        return SQuaternion(Result);
+    }
+
+    inline SQuaternion& operator*=(const SQuaternion& Other) { return *this = *this * Other; }
+
+    /* Same rotation, the other sign of the quaternion. */
+    inline SQuaternion operator-() const { return SQuaternion(Simd::Negate(GetRegister())); }
+
+    inline bool operator==(const SQuaternion& Other) const
+    {
+        return Simd::GetMaskBits(Simd::CompareEqual(GetRegister(), Other.GetRegister())) == 0xF;
+    }
+
+    inline bool operator!=(const SQuaternion& Other) const
+    {
+        return !(*this == Other);
+    }
+
+    inline SQuaternion GetConjugate() const
+    {
+        return SQuaternion(Simd::Multiply(GetRegister(), Simd::Set(-1.0f, -1.0f, -1.0f, 1.0f)));
+    }
+
+    /* Inverse rotation. For unit quaternions this is the conjugate, which is cheaper. */
+    inline SQuaternion GetInverse() const
+    {
+        const SVectorRegister Quaternion = GetRegister();
+        return SQuaternion(Simd::Divide(GetConjugate().GetRegister(), Simd::Dot4(Quaternion, Quaternion)));
+    }
+
+    inline SVector3f RotateVector(const SVector3f& Vector) const
+    {
+        const SVectorRegister Quaternion = GetRegister();
+        const SVectorRegister Value = Vector.GetRegister();
+
+        // V + 2W (Q x V) + Q x 2 (Q x V), with Q the vector part.
+        SVectorRegister Twice = Simd::Cross3(Quaternion, Value);
+        Twice = Simd::Add(Twice, Twice);
+        const SVectorRegister Result = Simd::MultiplyAdd(Simd::Replicate<3>(Quaternion), Twice, Simd::Add(Value, Simd::Cross3(Quaternion, Twice)));
+        return SVector3f(Result);
+    }
+
+    inline SVector3f UnrotateVector(const SVector3f& Vector) const
+    {
+        return GetConjugate().RotateVector(Vector);
+    }
+
+    inline float MagnitudeSquared() const
+    {
+        return Simd::GetX(Simd::Dot4(GetRegister(), GetRegister()));
+    }
+
+    /* This quaternion scaled to unit length, or the identity if it has no length. */
+    inline SQuaternion GetNormalized(EMathAccuracy Accuracy = EMathAccuracy::Exact) const
+    {
+        const SVectorRegister Quaternion = GetRegister();
+        const SVectorRegister LengthSquared = Simd::Dot4(Quaternion, Quaternion);
+        const SVectorRegister Normalized = Simd::Multiply(Quaternion, Simd::ReciprocalSqrt(LengthSquared, Accuracy));
+        return SQuaternion(Simd::Select(Simd::CompareGreater(LengthSquared, Simd::Zero()), Normalized, Identity().GetRegister()));
+    }
+
+    inline void Normalize(EMathAccuracy Accuracy = EMathAccuracy::Exact)
+    {
+        *this = GetNormalized(Accuracy);
+    }
+
+    static inline float Dot(const SQuaternion& A, const SQuaternion& B)
+    {
+        return Simd::GetX(Simd::Dot4(A.GetRegister(), B.GetRegister()));
+    }
+
+    /*
+     * Normalized linear interpolation along the shorter arc. Cheaper than Slerp, but the angular speed is not
+     * constant between A and B.
+     */
+    static inline SQuaternion Nlerp(const SQuaternion& A, const SQuaternion& B, float Alpha, EMathAccuracy Accuracy = EMathAccuracy::Exact)
+    {
+        const SVectorRegister Start = A.GetRegister();
+        const SVectorRegister End = ShorterArcEnd(Start, B.GetRegister());
+        const SVectorRegister Blended = Simd::MultiplyAdd(Simd::Splat(Alpha), Simd::Subtract(End, Start), Start);
+        return SQuaternion(Blended).GetNormalized(Accuracy);
+    }
+
+    /* Spherical linear interpolation along the shorter arc, at constant angular speed. */
+    static inline SQuaternion Slerp(const SQuaternion& A, const SQuaternion& B, float Alpha)
+    {
+        const SVectorRegister Start = A.GetRegister();
+        const SVectorRegister End = ShorterArcEnd(Start, B.GetRegister());
+
+        // Nearly parallel rotations divide by a vanishing sine, their interpolation is linear to float precision.
+        const float Cosine = Simd::GetX(Simd::Dot4(Start, End));
+        if (Cosine > 0.9995f)
+        {
+            return Nlerp(A, SQuaternion(End), Alpha);
+        }
+
+        const float Angle = std::acos(Cosine);
+        const float InverseSine = 1.0f / std::sin(Angle);
+        const SVectorRegister StartWeight = Simd::Splat(std::sin((1.0f - Alpha) * Angle) * InverseSine);
+        const SVectorRegister EndWeight = Simd::Splat(std::sin(Alpha * Angle) * InverseSine);
+        return SQuaternion(Simd::MultiplyAdd(EndWeight, End, Simd::Multiply(StartWeight, Start)));
+    }
+
+private:
+    // End or its negation, whichever is closer to Start. Both describe the same rotation.
+    static inline SVectorRegister ShorterArcEnd(SVectorRegister Start, SVectorRegister End)
+    {
+        return Simd::Select(Simd::CompareGreater(Simd::Zero(), Simd::Dot4(Start, End)), Simd::Negate(End), End);
+    }
+};
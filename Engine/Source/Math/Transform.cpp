@@ -1,2 +1,132 @@
 ﻿#include "EnginePCH.h"
 #include "Transform.h"
+
+#include <assert.h>
+
+#include "Memory/Memory.h"
+
+namespace
+{
+    // One component of four transforms per register. Named members rather than arrays keep it all in registers.
+    struct STransformLanes
+    {
+        SVectorRegister LocationX, LocationY, LocationZ;
+
+        SVectorRegister RotationX, RotationY, RotationZ, RotationW;
+
+        SVectorRegister ScaleX, ScaleY, ScaleZ;
+    };
+
+    static inline STransformLanes LoadLanes(const STransformSoAView& Transforms, size_t Index)
+    {
+        return STransformLanes
+        {
+            Simd::Load(Transforms.Location[0] + Index), Simd::Load(Transforms.Location[1] + Index), Simd::Load(Transforms.Location[2] + Index),
+            Simd::Load(Transforms.Rotation[0] + Index), Simd::Load(Transforms.Rotation[1] + Index), Simd::Load(Transforms.Rotation[2] + Index), Simd::Load(Transforms.Rotation[3] + Index),
+            Simd::Load(Transforms.Scale[0] + Index), Simd::Load(Transforms.Scale[1] + Index), Simd::Load(Transforms.Scale[2] + Index),
+        };
+    }
+
+    // Transposing the four registers of one row's elements gives that row of each of the four matrices.
+    static inline void StoreRow(SMatrix3x4f* Destination, uint32 Row, SVectorRegister Column0, SVectorRegister Column1, SVectorRegister Column2, SVectorRegister Column3)
+    {
+        Simd::Transpose4(Column0, Column1, Column2, Column3);
+        Simd::StoreAligned(Destination[0].M[Row], Column0);
+        Simd::StoreAligned(Destination[1].M[Row], Column1);
+        Simd::StoreAligned(Destination[2].M[Row], Column2);
+        Simd::StoreAligned(Destination[3].M[Row], Column3);
+    }
+
+    // Same arithmetic as STransform::ToMatrix, for four transforms at once.
+    static inline void TransformToMatrix4(SMatrix3x4f* Destination, const STransformLanes& Lanes)
+    {
+        const SVectorRegister X2 = Simd::Add(Lanes.RotationX, Lanes.RotationX);
+        const SVectorRegister Y2 = Simd::Add(Lanes.RotationY, Lanes.RotationY);
+        const SVectorRegister Z2 = Simd::Add(Lanes.RotationZ, Lanes.RotationZ);
+
+        const SVectorRegister XX = Simd::Multiply(Lanes.RotationX, X2);
+        const SVectorRegister YY = Simd::Multiply(Lanes.RotationY, Y2);
+        const SVectorRegister ZZ = Simd::Multiply(Lanes.RotationZ, Z2);
+        const SVectorRegister XY = Simd::Multiply(Lanes.RotationX, Y2);
+        const SVectorRegister XZ = Simd::Multiply(Lanes.RotationX, Z2);
+        const SVectorRegister YZ = Simd::Multiply(Lanes.RotationY, Z2);
+        const SVectorRegister WX = Simd::Multiply(Lanes.RotationW, X2);
+        const SVectorRegister WY = Simd::Multiply(Lanes.RotationW, Y2);
+        const SVectorRegister WZ = Simd::Multiply(Lanes.RotationW, Z2);
+        const SVectorRegister One = Simd::Splat(1.0f);
+
+        StoreRow(Destination, 0,
+            Simd::Multiply(Simd::Subtract(One, Simd::Add(YY, ZZ)), Lanes.ScaleX),
+            Simd::Multiply(Simd::Subtract(XY, WZ), Lanes.ScaleY),
+            Simd::Multiply(Simd::Add(XZ, WY), Lanes.ScaleZ),
+            Lanes.LocationX);
+        StoreRow(Destination, 1,
+            Simd::Multiply(Simd::Add(XY, WZ), Lanes.ScaleX),
+            Simd::Multiply(Simd::Subtract(One, Simd::Add(XX, ZZ)), Lanes.ScaleY),
+            Simd::Multiply(Simd::Subtract(YZ, WX), Lanes.ScaleZ),
+            Lanes.LocationY);
+        StoreRow(Destination, 2,
+            Simd::Multiply(Simd::Subtract(XZ, WY), Lanes.ScaleX),
+            Simd::Multiply(Simd::Add(YZ, WX), Lanes.ScaleY),
+            Simd::Multiply(Simd::Subtract(One, Simd::Add(XX, YY)), Lanes.ScaleZ),
+            Lanes.LocationZ);
+    }
+}
+
+SMatrix3x4f STransform::ToMatrix() const
+{
+    const float X2 = Rotation.X + Rotation.X;
+    const float Y2 = Rotation.Y + Rotation.Y;
+    const float Z2 = Rotation.Z + Rotation.Z;
+    const float XX = Rotation.X * X2, YY = Rotation.Y * Y2, ZZ = Rotation.Z * Z2;
+    const float XY = Rotation.X * Y2, XZ = Rotation.X * Z2, YZ = Rotation.Y * Z2;
+    const float WX = Rotation.W * X2, WY = Rotation.W * Y2, WZ = Rotation.W * Z2;
+
+    return SMatrix3x4f(
+        (1.0f - (YY + ZZ)) * Scale.X, (XY - WZ) * Scale.Y, (XZ + WY) * Scale.Z, Location.X,
+        (XY + WZ) * Scale.X, (1.0f - (XX + ZZ)) * Scale.Y, (YZ - WX) * Scale.Z, Location.Y,
+        (XZ - WY) * Scale.X, (YZ + WX) * Scale.Y, (1.0f - (XX + YY)) * Scale.Z, Location.Z);
+}
+
+void Math::TransformToMatrixBatch(const TArrayView<SMatrix3x4f>& Destination, const STransformSoAView& Transforms)
+{
+    assert(Destination.GetSize() >= Transforms.Size && "The destination must hold a matrix per transform.");
+
+    SMatrix3x4f* Matrices = Destination.GetData();
+
+    size_t Index = 0;
+    for (; Index + 4 <= Transforms.Size; Index += 4)
+    {
+        TransformToMatrix4(Matrices + Index, LoadLanes(Transforms, Index));
+    }
+
+    // The tail is padded with identity transforms and goes through the same kernel, so every transform gets the
+    // same matrix it would in a full batch.
+    const size_t NumRemaining = Transforms.Size - Index;
+    if (NumRemaining > 0)
+    {
+        const auto LoadTail = [Index, NumRemaining](const float* Source, float Padding)
+        {
+            alignas(16) float Lanes[4] = { Padding, Padding, Padding, Padding };
+            for (size_t Lane = 0; Lane < NumRemaining; ++Lane)
+            {
+                Lanes[Lane] = Source[Index + Lane];
+            }
+            return Simd::LoadAligned(Lanes);
+        };
+
+        const STransformLanes Lanes
+        {
+            LoadTail(Transforms.Location[0], 0.0f), LoadTail(Transforms.Location[1], 0.0f), LoadTail(Transforms.Location[2], 0.0f),
+            LoadTail(Transforms.Rotation[0], 0.0f), LoadTail(Transforms.Rotation[1], 0.0f), LoadTail(Transforms.Rotation[2], 0.0f), LoadTail(Transforms.Rotation[3], 1.0f),
+            LoadTail(Transforms.Scale[0], 1.0f), LoadTail(Transforms.Scale[1], 1.0f), LoadTail(Transforms.Scale[2], 1.0f),
+        };
+
+        SMatrix3x4f Padded[4];
+        TransformToMatrix4(Padded, Lanes);
+        for (size_t Lane = 0; Lane < NumRemaining; ++Lane)
+        {
+            Matrices[Index + Lane] = Padded[Lane];
+        }
+    }
+}
\ No newline at end of file
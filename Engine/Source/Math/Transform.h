@@ -1,10 +1,87 @@
 ﻿#pragma once
 
-#include <glm/vec3.hpp>
+#include "MathTypes.h"
+#include "Matrix.h"
+#include "Quaternion.h"
+#include "Vector3.h"
 
+template<typename TElement>
+class TArrayView;
+
+/*
+ * Scale, then rotation, then translation. The rotation is a quaternion, so building the matrix needs no
+ * trigonometry. Composing transforms with non-uniform scale under a rotation would shear, which a TRS transform
+ * cannot represent; compose their matrices instead where that matters.
+ */
 struct STransform
 {
-    glm::vec3 Location;
-    glm::vec3 Rotation;
-    glm::vec3 Scale;
+    SVector3f Location;
+
+    SQuaternion Rotation;
+
+    SVector3f Scale;
+
+    STransform()
+        : Location(0.0f), Rotation(), Scale(1.0f)
+    {
+    }
+
+    STransform(const SVector3f& InLocation, const SQuaternion& InRotation = SQuaternion(), const SVector3f& InScale = SVector3f(1.0f))
+        : Location(InLocation), Rotation(InRotation), Scale(InScale)
+    {
+    }
+
+    static inline STransform Identity()
+    {
+        return STransform();
+    }
+
+    inline SVector3f TransformPoint(const SVector3f& Point) const
+    {
+        return Rotation.RotateVector(Scale * Point) + Location;
+    }
+
+    inline SVector3f TransformVector(const SVector3f& Vector) const
+    {
+        return Rotation.RotateVector(Scale * Vector);
+    }
+
+    /* Other followed by this transform, e.g. Parent * Child for the child relative to the parent's space. */
+    inline STransform operator*(const STransform& Other) const
+    {
+        return STransform(TransformPoint(Other.Location), Rotation * Other.Rotation, Scale * Other.Scale);
+    }
+
+    /* Inverse of the transform, exact when the scale is uniform. */
+    inline STransform GetInverse() const
+    {
+        const SVector3f InverseScale = SVector3f(1.0f) / Scale;
+        const SQuaternion InverseRotation = Rotation.GetConjugate();
+        return STransform(InverseScale * InverseRotation.RotateVector(-Location), InverseRotation, InverseScale);
+    }
+
+    /* Affine matrix of the transform, the rotation is expected to be a unit quaternion. */
+    SMatrix3x4f ToMatrix() const;
 };
+
+/*
+ * Size transforms in structure-of-arrays layout, one array per component, e.g. Rotation[3] holds the W of every
+ * rotation. The batch kernels then fill a register with one component of four transforms instead of
+ * shuffling the components of one transform.
+ */
+struct STransformSoAView
+{
+    const float* Location[3];
+
+    const float* Rotation[4];
+
+    const float* Scale[3];
+
+    size_t Size;
+};
+
+namespace Math
+{
+    /* Destination[I] = the matrix of transform I, four transforms at a time. Destination must hold Transforms.Size matrices. */
+    void TransformToMatrixBatch(const TArrayView<SMatrix3x4f>& Destination, const STransformSoAView& Transforms);
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Math.h"
+#include "VectorRegister.h"
 
 template<typename T>
 struct TVector3
@@ -19,13 +20,13 @@ struct TVector3
 
     TVector3(const TVector3<T>& Other);
 
-    inline TVector3<T> operator+(T Other);
+    inline TVector3<T> operator+(T Other) const;
 
-    inline TVector3<T> operator-(T Other);
+    inline TVector3<T> operator-(T Other) const;
 
-    inline TVector3<T> operator*(T Other);
+    inline TVector3<T> operator*(T Other) const;
 
-    inline TVector3<T> operator/(T Other);
+    inline TVector3<T> operator/(T Other) const;
 
     inline TVector3<T> operator+(const TVector3<T>& Other) const;
 
@@ -51,15 +52,21 @@ struct TVector3
 
     inline TVector3<T>& operator/=(const TVector3<T>& Other);
 
-    inline TVector3<T> Zero() const;
+    static inline TVector3<T> Zero();
 
-    inline TVector3<T> One() const;
+    static inline TVector3<T> One();
     
-    void Normalize();
+    void Normalize(EMathAccuracy Accuracy = EMathAccuracy::Exact);
 
-    T Magnitude();
+    T Magnitude(EMathAccuracy Accuracy = EMathAccuracy::Exact) const;
+
+    T MagnitudeSquared() const;
     
-    static T Distance(const TVector3<T>& Left, const TVector3<T>& Right);
+    static T Distance(const TVector3<T>& Left, const TVector3<T>& Right, EMathAccuracy Accuracy = EMathAccuracy::Exact);
+
+    static T Dot(const TVector3<T>& A, const TVector3<T>& B);
+
+    static TVector3<T> Cross(const TVector3<T>& A, const TVector3<T>& B);
 };
 
 template <typename T>
@@ -83,25 +90,25 @@ inline TVector3<T>::TVector3(const TVector3<T>& Other) : X(Other.X), Y(Other.Y),
 }
 
 template <typename T>
-inline TVector3<T> TVector3<T>::operator+(T Other)
+inline TVector3<T> TVector3<T>::operator+(T Other) const
 {
     return TVector3<T>(X + Other, Y + Other, Z + Other);
 }
 
 template <typename T>
-inline TVector3<T> TVector3<T>::operator-(T Other)
+inline TVector3<T> TVector3<T>::operator-(T Other) const
 {
     return TVector3<T>(X - Other, Y - Other, Z - Other);
 }
 
 template <typename T>
-inline TVector3<T> TVector3<T>::operator*(T Other)
+inline TVector3<T> TVector3<T>::operator*(T Other) const
 {
     return TVector3<T>(X * Other, Y * Other, Z * Other);
 }
 
 template <typename T>
-inline TVector3<T> TVector3<T>::operator/(T Other)
+inline TVector3<T> TVector3<T>::operator/(T Other) const
 {
     return TVector3<T>(X / Other, Y / Other, Z / Other);
 }
@@ -203,21 +210,21 @@ inline TVector3<T>& TVector3<T>::operator/=(const TVector3<T>& Other)
 }
 
 template <typename T>
-inline TVector3<T> TVector3<T>::Zero() const
+inline TVector3<T> TVector3<T>::Zero()
 {
-    return TVector<T>(0, 0, 0);
+    return TVector3<T>(0, 0, 0);
 }
 
 template <typename T>
-inline TVector3<T> TVector3<T>::One() const
+inline TVector3<T> TVector3<T>::One()
 {
-    return TVector<T>(1, 1, 1);
+    return TVector3<T>(1, 1, 1);
 }
 
 template <typename T>
-void TVector3<T>::Normalize()
+void TVector3<T>::Normalize(EMathAccuracy Accuracy)
 {
-    T Mag = Magnitude();
+    T Mag = Magnitude(Accuracy);
 
     if (Mag > 0)
     {
@@ -228,19 +235,167 @@ void TVector3<T>::Normalize()
 }
 
 template <typename T>
-T TVector3<T>::Magnitude()
+T TVector3<T>::Magnitude(EMathAccuracy Accuracy) const
+{
+    return Math::Sqrt(MagnitudeSquared(), Accuracy);
+}
+
+template <typename T>
+T TVector3<T>::MagnitudeSquared() const
 {
-    return Math::Sqrt(X * X + Y * Y + Z * Z);
+    return X * X + Y * Y + Z * Z;
 }
 
 template <typename T>
-T TVector3<T>::Distance(const TVector3<T>& Left, const TVector3<T>& Right)
+T TVector3<T>::Distance(const TVector3<T>& Left, const TVector3<T>& Right, EMathAccuracy Accuracy)
 {
-    return Math::Sqrt(Math::Pow(Right.X - Left.X, 2) +
-            Math::Pow(Right.Y - Left.Y, 2) +
-            Math::Pow(Right.Z - Left.Z, 2));
+    return (Right - Left).Magnitude(Accuracy);
 }
 
+template <typename T>
+T TVector3<T>::Dot(const TVector3<T>& A, const TVector3<T>& B)
+{
+    return A.X * B.X + A.Y * B.Y + A.Z * B.Z;
+}
+
+template <typename T>
+TVector3<T> TVector3<T>::Cross(const TVector3<T>& A, const TVector3<T>& B)
+{
+    return TVector3<T>(A.Y * B.Z - A.Z * B.Y, A.Z * B.X - A.X * B.Z, A.X * B.Y - A.Y * B.X);
+}
+
+/*
+ * Float vectors are padded to four lanes and aligned, so every operation runs on one SIMD register. The padding
+ * lane is kept at zero, which lets dot products and lengths use the full register.
+ */
+template<>
+struct alignas(16) TVector3<float>
+{
+    float X;
+
+    float Y;
+
+    float Z;
+
+private:
+    float Padding;
+
+public:
+    TVector3()
+        : X(0.0f), Y(0.0f), Z(0.0f), Padding(0.0f)
+    {
+    }
+
+    TVector3(float Scalar)
+        : X(Scalar), Y(Scalar), Z(Scalar), Padding(0.0f)
+    {
+    }
+
+    TVector3(float InX, float InY, float InZ)
+        : X(InX), Y(InY), Z(InZ), Padding(0.0f)
+    {
+    }
+
+    // W of Register is discarded.
+    explicit TVector3(SVectorRegister Register)
+    {
+        Simd::StoreAligned(&X, Simd::ClearW(Register));
+    }
+
+    inline SVectorRegister GetRegister() const
+    {
+        return Simd::LoadAligned(&X);
+    }
+
+    inline float& operator[](uint32 Index) { return (&X)[Index]; }
+    inline float operator[](uint32 Index) const { return (&X)[Index]; }
+
+    inline TVector3 operator-() const { return TVector3(Simd::Negate(GetRegister())); }
+
+    inline TVector3 operator+(const TVector3& Other) const { return TVector3(Simd::Add(GetRegister(), Other.GetRegister())); }
+    inline TVector3 operator-(const TVector3& Other) const { return TVector3(Simd::Subtract(GetRegister(), Other.GetRegister())); }
+    inline TVector3 operator*(const TVector3& Other) const { return TVector3(Simd::Multiply(GetRegister(), Other.GetRegister())); }
+    inline TVector3 operator/(const TVector3& Other) const { return TVector3(Simd::Divide(GetRegister(), Other.GetRegister())); }
+
+    inline TVector3 operator+(float Scalar) const { return TVector3(Simd::Add(GetRegister(), Simd::Splat(Scalar))); }
+    inline TVector3 operator-(float Scalar) const { return TVector3(Simd::Subtract(GetRegister(), Simd::Splat(Scalar))); }
+    inline TVector3 operator*(float Scalar) const { return TVector3(Simd::Multiply(GetRegister(), Simd::Splat(Scalar))); }
+    inline TVector3 operator/(float Scalar) const { return TVector3(Simd::Divide(GetRegister(), Simd::Splat(Scalar))); }
+
+    inline TVector3& operator+=(const TVector3& Other) { return *this = *this + Other; }
+    inline TVector3& operator-=(const TVector3& Other) { return *this = *this - Other; }
+    inline TVector3& operator*=(const TVector3& Other) { return *this = *this * Other; }
+    inline TVector3& operator/=(const TVector3& Other) { return *this = *this / Other; }
+
+    inline TVector3& operator+=(float Scalar) { return *this = *this + Scalar; }
+    inline TVector3& operator-=(float Scalar) { return *this = *this - Scalar; }
+    inline TVector3& operator*=(float Scalar) { return *this = *this * Scalar; }
+    inline TVector3& operator/=(float Scalar) { return *this = *this / Scalar; }
+
+    inline bool operator==(const TVector3& Other) const
+    {
+        return (Simd::GetMaskBits(Simd::CompareEqual(GetRegister(), Other.GetRegister())) & 0x7) == 0x7;
+    }
+
+    inline bool operator!=(const TVector3& Other) const
+    {
+        return !(*this == Other);
+    }
+
+    /* Components of the result are the components IndexX..IndexZ of this vector, e.g. Swizzle<2, 1, 0>() for ZYX. */
+    template<uint32 IndexX, uint32 IndexY, uint32 IndexZ>
+    inline TVector3 Swizzle() const
+    {
+        static_assert(IndexX < 3 && IndexY < 3 && IndexZ < 3, "Swizzle indices select X, Y or Z.");
+        return TVector3(Simd::Swizzle<IndexX, IndexY, IndexZ, 3>(GetRegister()));
+    }
+
+    inline float MagnitudeSquared() const
+    {
+        return Simd::GetX(Simd::Dot3(GetRegister(), GetRegister()));
+    }
+
+    inline float Magnitude(EMathAccuracy Accuracy = EMathAccuracy::Exact) const
+    {
+        return Simd::GetX(Simd::Sqrt(Simd::Dot3(GetRegister(), GetRegister()), Accuracy));
+    }
+
+    /* This vector scaled to unit length, or zero if it has no length. */
+    inline TVector3 GetNormalized(EMathAccuracy Accuracy = EMathAccuracy::Exact) const
+    {
+        const SVectorRegister Vector = GetRegister();
+        const SVectorRegister LengthSquared = Simd::Dot3(Vector, Vector);
+        const SVectorRegister Normalized = Simd::Multiply(Vector, Simd::ReciprocalSqrt(LengthSquared, Accuracy));
+        return TVector3(Simd::Select(Simd::CompareGreater(LengthSquared, Simd::Zero()), Normalized, Simd::Zero()));
+    }
+
+    inline void Normalize(EMathAccuracy Accuracy = EMathAccuracy::Exact)
+    {
+        *this = GetNormalized(Accuracy);
+    }
+
+    static inline TVector3 Zero() { return TVector3(0.0f); }
+    static inline TVector3 One() { return TVector3(1.0f); }
+
+    static inline float Distance(const TVector3& Left, const TVector3& Right, EMathAccuracy Accuracy = EMathAccuracy::Exact)
+    {
+        return (Right - Left).Magnitude(Accuracy);
+    }
+
+    static inline float Dot(const TVector3& A, const TVector3& B)
+    {
+        return Simd::GetX(Simd::Dot3(A.GetRegister(), B.GetRegister()));
+    }
+
+    static inline TVector3 Cross(const TVector3& A, const TVector3& B)
+    {
+        return TVector3(Simd::Cross3(A.GetRegister(), B.GetRegister()));
+    }
+
+    static inline TVector3 Min(const TVector3& A, const TVector3& B) { return TVector3(Simd::Min(A.GetRegister(), B.GetRegister())); }
+    static inline TVector3 Max(const TVector3& A, const TVector3& B) { return TVector3(Simd::Max(A.GetRegister(), B.GetRegister())); }
+};
+
 typedef TVector3<int> SVector3i;
 typedef TVector3<float> SVector3f;
 typedef TVector3<double> SVector3d;
\ No newline at end of file
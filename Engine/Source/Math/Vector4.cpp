@@ -0,0 +1,2 @@
+#include "EnginePCH.h"
+#include "Vector4.h"
\ No newline at end of file
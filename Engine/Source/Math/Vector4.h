@@ -0,0 +1,123 @@
+#pragma once
+
+#include "MathTypes.h"
+#include "VectorRegister.h"
+
+/* Four-component float vector, aligned to be loaded into a single SIMD register. */
+struct alignas(16) SVector4f
+{
+    float X;
+
+    float Y;
+
+    float Z;
+
+    float W;
+
+    SVector4f()
+        : X(0.0f), Y(0.0f), Z(0.0f), W(0.0f)
+    {
+    }
+
+    SVector4f(float Scalar)
+        : X(Scalar), Y(Scalar), Z(Scalar), W(Scalar)
+    {
+    }
+
+    SVector4f(float InX, float InY, float InZ, float InW)
+        : X(InX), Y(InY), Z(InZ), W(InW)
+    {
+    }
+
+    explicit SVector4f(SVectorRegister Register)
+    {
+        Simd::StoreAligned(&X, Register);
+    }
+
+    inline SVectorRegister GetRegister() const
+    {
+        return Simd::LoadAligned(&X);
+    }
+
+    inline float& operator[](uint32 Index) { return (&X)[Index]; }
+    inline float operator[](uint32 Index) const { return (&X)[Index]; }
+
+    inline SVector4f operator-() const { return SVector4f(Simd::Negate(GetRegister())); }
+
+    inline SVector4f operator+(const SVector4f& Other) const { return SVector4f(Simd::Add(GetRegister(), Other.GetRegister())); }
+    inline SVector4f operator-(const SVector4f& Other) const { return SVector4f(Simd::Subtract(GetRegister(), Other.GetRegister())); }
+    inline SVector4f operator*(const SVector4f& Other) const { return SVector4f(Simd::Multiply(GetRegister(), Other.GetRegister())); }
+    inline SVector4f operator/(const SVector4f& Other) const { return SVector4f(Simd::Divide(GetRegister(), Other.GetRegister())); }
+
+    inline SVector4f operator+(float Scalar) const { return SVector4f(Simd::Add(GetRegister(), Simd::Splat(Scalar))); }
+    inline SVector4f operator-(float Scalar) const { return SVector4f(Simd::Subtract(GetRegister(), Simd::Splat(Scalar))); }
+    inline SVector4f operator*(float Scalar) const { return SVector4f(Simd::Multiply(GetRegister(), Simd::Splat(Scalar))); }
+    inline SVector4f operator/(float Scalar) const { return SVector4f(Simd::Divide(GetRegister(), Simd::Splat(Scalar))); }
+
+    inline SVector4f& operator+=(const SVector4f& Other) { return *this = *this + Other; }
+    inline SVector4f& operator-=(const SVector4f& Other) { return *this = *this - Other; }
+    inline SVector4f& operator*=(const SVector4f& Other) { return *this = *this * Other; }
+    inline SVector4f& operator/=(const SVector4f& Other) { return *this = *this / Other; }
+
+    inline SVector4f& operator+=(float Scalar) { return *this = *this + Scalar; }
+    inline SVector4f& operator-=(float Scalar) { return *this = *this - Scalar; }
+    inline SVector4f& operator*=(float Scalar) { return *this = *this * Scalar; }
+    inline SVector4f& operator/=(float Scalar) { return *this = *this / Scalar; }
+
+    inline bool operator==(const SVector4f& Other) const
+    {
+        return Simd::GetMaskBits(Simd::CompareEqual(GetRegister(), Other.GetRegister())) == 0xF;
+    }
+
+    inline bool operator!=(const SVector4f& Other) const
+    {
+        return !(*this == Other);
+    }
+
+    /* Lanes of the result are the lanes IndexX..IndexW of this vector, e.g. Swizzle<2, 1, 0, 3>() for ZYXW. */
+    template<uint32 IndexX, uint32 IndexY, uint32 IndexZ, uint32 IndexW>
+    inline SVector4f Swizzle() const
+    {
+        return SVector4f(Simd::Swizzle<IndexX, IndexY, IndexZ, IndexW>(GetRegister()));
+    }
+
+    inline float MagnitudeSquared() const
+    {
+        return Simd::GetX(Simd::Dot4(GetRegister(), GetRegister()));
+    }
+
+    inline float Magnitude(EMathAccuracy Accuracy = EMathAccuracy::Exact) const
+    {
+        return Simd::GetX(Simd::Sqrt(Simd::Dot4(GetRegister(), GetRegister()), Accuracy));
+    }
+
+    /* This vector scaled to unit length, or zero if it has no length. */
+    inline SVector4f GetNormalized(EMathAccuracy Accuracy = EMathAccuracy::Exact) const
+    {
+        const SVectorRegister Vector = GetRegister();
+        const SVectorRegister LengthSquared = Simd::Dot4(Vector, Vector);
+        const SVectorRegister Normalized = Simd::Multiply(Vector, Simd::ReciprocalSqrt(LengthSquared, Accuracy));
+        return SVector4f(Simd::Select(Simd::CompareGreater(LengthSquared, Simd::Zero()), Normalized, Simd::Zero()));
+    }
+
+    inline void Normalize(EMathAccuracy Accuracy = EMathAccuracy::Exact)
+    {
+        *this = GetNormalized(Accuracy);
+    }
+
+    static inline SVector4f Zero() { return SVector4f(0.0f); }
+    static inline SVector4f One() { return SVector4f(1.0f); }
+
+    static inline float Dot(const SVector4f& A, const SVector4f& B)
+    {
+        return Simd::GetX(Simd::Dot4(A.GetRegister(), B.GetRegister()));
+    }
+
+    static inline SVector4f Min(const SVector4f& A, const SVector4f& B) { return SVector4f(Simd::Min(A.GetRegister(), B.GetRegister())); }
+    static inline SVector4f Max(const SVector4f& A, const SVector4f& B) { return SVector4f(Simd::Max(A.GetRegister(), B.GetRegister())); }
+};
+
+inline SVector4f operator*(float Scalar, const SVector4f& Vector)
+{
+    return Vector * Scalar;
+}
@@ -0,0 +1,2 @@
+#include "EnginePCH.h"
+#include "VectorRegister.h"
\ No newline at end of file
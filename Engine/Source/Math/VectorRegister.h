@@ -0,0 +1,612 @@
+#pragma once
+
+#include <cmath>
+#include <cstring>
+
+#include "MathTypes.h"
+
+/*
+ * Four-lane float register and the operations the vector types are built on. The backend is chosen at compile
+ * time: SSE on x86 (with SSE4.1, AVX and FMA paths when the target enables them), NEON on ARM64, and a scalar
+ * reference implementation otherwise. Define RK_MATH_SCALAR to force the scalar backend, e.g. to compare results.
+ */
+#if defined(RK_MATH_SCALAR)
+    // Forced by the build.
+#elif defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+    #define RK_MATH_SSE 1
+    #include <immintrin.h>
+    #if defined(__AVX__)
+        #define RK_MATH_AVX 1
+    #endif
+    #if defined(__FMA__) || defined(__AVX2__)
+        #define RK_MATH_FMA 1
+    #endif
+    #if defined(__SSE4_1__) || defined(RK_MATH_AVX)
+        #define RK_MATH_SSE4 1
+    #endif
+#elif defined(_M_ARM64) || defined(__aarch64__)
+    #define RK_MATH_NEON 1
+    #include <arm_neon.h>
+#else
+    #define RK_MATH_SCALAR 1
+#endif
+
+// True while a constexpr function is evaluated at compile time, where the intrinsics cannot be used.
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+    #define RK_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+    #define RK_IS_CONSTANT_EVALUATED() false
+#endif
+
+#if defined(RK_MATH_SSE)
+    using SVectorRegister = __m128;
+#elif defined(RK_MATH_NEON)
+    using SVectorRegister = float32x4_t;
+#else
+    struct SVectorRegister
+    {
+        float V[4];
+    };
+#endif
+
+namespace Simd
+{
+    /* Name of the compiled backend, e.g. "SSE4.1". */
+    constexpr const char* GetBackendName()
+    {
+#if defined(RK_MATH_SSE) && defined(RK_MATH_FMA)
+        return "AVX2/FMA";
+#elif defined(RK_MATH_AVX)
+        return "AVX";
+#elif defined(RK_MATH_SSE4)
+        return "SSE4.1";
+#elif defined(RK_MATH_SSE)
+        return "SSE2";
+#elif defined(RK_MATH_NEON)
+        return "NEON";
+#else
+        return "Scalar";
+#endif
+    }
+
+    inline SVectorRegister Set(float X, float Y, float Z, float W)
+    {
+#if defined(RK_MATH_SSE)
+        return _mm_setr_ps(X, Y, Z, W);
+#elif defined(RK_MATH_NEON)
+        const float Values[4] = { X, Y, Z, W };
+        return vld1q_f32(Values);
+#else
+        return SVectorRegister { { X, Y, Z, W } };
+#endif
+    }
+
+    inline SVectorRegister Splat(float Value)
+    {
+#if defined(RK_MATH_SSE)
+        return _mm_set1_ps(Value);
+#elif defined(RK_MATH_NEON)
+        return vdupq_n_f32(Value);
+#else
+        return SVectorRegister { { Value, Value, Value, Value } };
+#endif
+    }
+
+    inline SVectorRegister Zero()
+    {
+#if defined(RK_MATH_SSE)
+        return _mm_setzero_ps();
+#else
+        return Splat(0.0f);
+#endif
+    }
+
+    inline SVectorRegister Load(const float* Source)
+    {
+#if defined(RK_MATH_SSE)
+        return _mm_loadu_ps(Source);
+#elif defined(RK_MATH_NEON)
+        return vld1q_f32(Source);
+#else
+        SVectorRegister Result;
+        std::memcpy(Result.V, Source, sizeof(Result.V));
+        return Result;
+#endif
+    }
+
+    /* Source must be 16-byte aligned. */
+    inline SVectorRegister LoadAligned(const float* Source)
+    {
+#if defined(RK_MATH_SSE)
+        return _mm_load_ps(Source);
+#else
+        return Load(Source);
+#endif
+    }
+
+    /* Loads three floats and clears W, without reading past Source[2]. */
+    inline SVectorRegister Load3(const float* Source)
+    {
+        return Set(Source[0], Source[1], Source[2], 0.0f);
+    }
+
+    inline void Store(float* Destination, SVectorRegister Vector)
+    {
+#if defined(RK_MATH_SSE)
+        _mm_storeu_ps(Destination, Vector);
+#elif defined(RK_MATH_NEON)
+        vst1q_f32(Destination, Vector);
+#else
+        std::memcpy(Destination, Vector.V, sizeof(Vector.V));
+#endif
+    }
+
+    /* Destination must be 16-byte aligned. */
+    inline void StoreAligned(float* Destination, SVectorRegister Vector)
+    {
+#if defined(RK_MATH_SSE)
+        _mm_store_ps(Destination, Vector);
+#else
+        Store(Destination, Vector);
+#endif
+    }
+
+    /* Writes X, Y and Z without touching Destination[3]. */
+    inline void Store3(float* Destination, SVectorRegister Vector)
+    {
+        float Values[4];
+        Store(Values, Vector);
+        Destination[0] = Values[0];
+        Destination[1] = Values[1];
+        Destination[2] = Values[2];
+    }
+
+    inline float GetX(SVectorRegister Vector)
+    {
+#if defined(RK_MATH_SSE)
+        return _mm_cvtss_f32(Vector);
+#elif defined(RK_MATH_NEON)
+        return vgetq_lane_f32(Vector, 0);
+#else
+        return Vector.V[0];
+#endif
+    }
+
+    /* Lane X, Y, Z and W of the result are lanes IndexX, IndexY, IndexZ and IndexW of Vector. */
+    template<uint32 IndexX, uint32 IndexY, uint32 IndexZ, uint32 IndexW>
+    inline SVectorRegister Swizzle(SVectorRegister Vector)
+    {
+        static_assert(IndexX < 4 && IndexY < 4 && IndexZ < 4 && IndexW < 4, "Swizzle indices select one of four lanes.");
+#if defined(RK_MATH_AVX)
+        return _mm_permute_ps(Vector, _MM_SHUFFLE(IndexW, IndexZ, IndexY, IndexX));
+#elif defined(RK_MATH_SSE)
+        return _mm_shuffle_ps(Vector, Vector, _MM_SHUFFLE(IndexW, IndexZ, IndexY, IndexX));
+#elif defined(RK_MATH_NEON) && defined(__clang__)
+        return __builtin_shufflevector(Vector, Vector, IndexX, IndexY, IndexZ, IndexW);
+#elif defined(RK_MATH_NEON)
+        float32x4_t Result = vdupq_n_f32(vgetq_lane_f32(Vector, IndexX));
+        Result = vsetq_lane_f32(vgetq_lane_f32(Vector, IndexY), Result, 1);
+        Result = vsetq_lane_f32(vgetq_lane_f32(Vector, IndexZ), Result, 2);
+        return vsetq_lane_f32(vgetq_lane_f32(Vector, IndexW), Result, 3);
+#else
+        return SVectorRegister { { Vector.V[IndexX], Vector.V[IndexY], Vector.V[IndexZ], Vector.V[IndexW] } };
+#endif
+    }
+
+    /* Lanes X and Y of the result come from A, lanes Z and W from B, e.g. Shuffle<0, 1, 0, 1> joins the low halves. */
+    template<uint32 IndexX, uint32 IndexY, uint32 IndexZ, uint32 IndexW>
+    inline SVectorRegister Shuffle(SVectorRegister A, SVectorRegister B)
+    {
+        static_assert(IndexX < 4 && IndexY < 4 && IndexZ < 4 && IndexW < 4, "Shuffle indices select one of four lanes.");
+#if defined(RK_MATH_SSE)
+        if constexpr (IndexX == 0 && IndexY == 1 && IndexZ == 0 && IndexW == 1)
+        {
+            return _mm_movelh_ps(A, B);
+        }
+        else if constexpr (IndexX == 2 && IndexY == 3 && IndexZ == 2 && IndexW == 3)
+        {
+            return _mm_movehl_ps(B, A);
+        }
+        else
+        {
+            return _mm_shuffle_ps(A, B, _MM_SHUFFLE(IndexW, IndexZ, IndexY, IndexX));
+        }
+#elif defined(RK_MATH_NEON) && defined(__clang__)
+        return __builtin_shufflevector(A, B, IndexX, IndexY, IndexZ + 4, IndexW + 4);
+#elif defined(RK_MATH_NEON)
+        float32x4_t Result = vdupq_n_f32(vgetq_lane_f32(A, IndexX));
+        Result = vsetq_lane_f32(vgetq_lane_f32(A, IndexY), Result, 1);
+        Result = vsetq_lane_f32(vgetq_lane_f32(B, IndexZ), Result, 2);
+        return vsetq_lane_f32(vgetq_lane_f32(B, IndexW), Result, 3);
+#else
+        return SVectorRegister { { A.V[IndexX], A.V[IndexY], B.V[IndexZ], B.V[IndexW] } };
+#endif
+    }
+
+    /* Transposes the 4x4 matrix whose rows are the four registers, in place. */
+    inline void Transpose4(SVectorRegister& Row0, SVectorRegister& Row1, SVectorRegister& Row2, SVectorRegister& Row3)
+    {
+#if defined(RK_MATH_SSE)
+        _MM_TRANSPOSE4_PS(Row0, Row1, Row2, Row3);
+#elif defined(RK_MATH_NEON)
+        const float32x4x2_t Low = vtrnq_f32(Row0, Row1);
+        const float32x4x2_t High = vtrnq_f32(Row2, Row3);
+        Row0 = vcombine_f32(vget_low_f32(Low.val[0]), vget_low_f32(High.val[0]));
+        Row1 = vcombine_f32(vget_low_f32(Low.val[1]), vget_low_f32(High.val[1]));
+        Row2 = vcombine_f32(vget_high_f32(Low.val[0]), vget_high_f32(High.val[0]));
+        Row3 = vcombine_f32(vget_high_f32(Low.val[1]), vget_high_f32(High.val[1]));
+#else
+        const SVectorRegister Rows[4] = { Row0, Row1, Row2, Row3 };
+        SVectorRegister* Columns[4] = { &Row0, &Row1, &Row2, &Row3 };
+        for (uint32 Column = 0; Column < 4; ++Column)
+        {
+            *Columns[Column] = SVectorRegister { { Rows[0].V[Column], Rows[1].V[Column], Rows[2].V[Column], Rows[3].V[Column] } };
+        }
+#endif
+    }
+
+    template<uint32 Index>
+    inline SVectorRegister Replicate(SVectorRegister Vector)
+    {
+#if defined(RK_MATH_NEON)
+        return vdupq_laneq_f32(Vector, Index);
+#else
+        return Swizzle<Index, Index, Index, Index>(Vector);
+#endif
+    }
+
+    template<uint32 Index>
+    inline float GetComponent(SVectorRegister Vector)
+    {
+        static_assert(Index < 4, "A register has four lanes.");
+#if defined(RK_MATH_NEON)
+        return vgetq_lane_f32(Vector, Index);
+#elif defined(RK_MATH_SSE)
+        return GetX(Replicate<Index>(Vector));
+#else
+        return Vector.V[Index];
+#endif
+    }
+
+#if defined(RK_MATH_SCALAR)
+    template<typename TOperation>
+    inline SVectorRegister Map(SVectorRegister A, SVectorRegister B, TOperation Operation)
+    {
+        return SVectorRegister { { Operation(A.V[0], B.V[0]), Operation(A.V[1], B.V[1]), Operation(A.V[2], B.V[2]), Operation(A.V[3], B.V[3]) } };
+    }
+#endif
+
+    inline SVectorRegister Add(SVectorRegister A, SVectorRegister B)
+    {
+#if defined(RK_MATH_SSE)
+        return _mm_add_ps(A, B);
+#elif defined(RK_MATH_NEON)
+        return vaddq_f32(A, B);
+#else
+        return Map(A, B, [](float X, float Y) { return X + Y; });
+#endif
+    }
+
+    inline SVectorRegister Subtract(SVectorRegister A, SVectorRegister B)
+    {
+#if defined(RK_MATH_SSE)
+        return _mm_sub_ps(A, B);
+#elif defined(RK_MATH_NEON)
+        return vsubq_f32(A, B);
+#else
+        return Map(A, B, [](float X, float Y) { return X - Y; });
+#endif
+    }
+
+    inline SVectorRegister Multiply(SVectorRegister A, SVectorRegister B)
+    {
+#if defined(RK_MATH_SSE)
+        return _mm_mul_ps(A, B);
+#elif defined(RK_MATH_NEON)
+        return vmulq_f32(A, B);
+#else
+        return Map(A, B, [](float X, float Y) { return X * Y; });
+#endif
+    }
+
+    inline SVectorRegister Divide(SVectorRegister A, SVectorRegister B)
+    {
+#if defined(RK_MATH_SSE)
+        return _mm_div_ps(A, B);
+#elif defined(RK_MATH_NEON)
+        return vdivq_f32(A, B);
+#else
+        return Map(A, B, [](float X, float Y) { return X / Y; });
+#endif
+    }
+
+    /* A * B + C, fused where the target supports it. */
+    inline SVectorRegister MultiplyAdd(SVectorRegister A, SVectorRegister B, SVectorRegister C)
+    {
+#if defined(RK_MATH_FMA)
+        return _mm_fmadd_ps(A, B, C);
+#elif defined(RK_MATH_NEON)
+        return vfmaq_f32(C, A, B);
+#else
+        return Add(Multiply(A, B), C);
+#endif
+    }
+
+    /* C - A * B, fused where the target supports it. */
+    inline SVectorRegister NegativeMultiplySubtract(SVectorRegister A, SVectorRegister B, SVectorRegister C)
+    {
+#if defined(RK_MATH_FMA)
+        return _mm_fnmadd_ps(A, B, C);
+#elif defined(RK_MATH_NEON)
+        return vfmsq_f32(C, A, B);
+#else
+        return Subtract(C, Multiply(A, B));
+#endif
+    }
+
+    inline SVectorRegister Min(SVectorRegister A, SVectorRegister B)
+    {
+#if defined(RK_MATH_SSE)
+        return _mm_min_ps(A, B);
+#elif defined(RK_MATH_NEON)
+        return vminq_f32(A, B);
+#else
+        return Map(A, B, [](float X, float Y) { return X < Y ? X : Y; });
+#endif
+    }
+
+    inline SVectorRegister Max(SVectorRegister A, SVectorRegister B)
+    {
+#if defined(RK_MATH_SSE)
+        return _mm_max_ps(A, B);
+#elif defined(RK_MATH_NEON)
+        return vmaxq_f32(A, B);
+#else
+        return Map(A, B, [](float X, float Y) { return X > Y ? X : Y; });
+#endif
+    }
+
+    inline SVectorRegister Negate(SVectorRegister Vector)
+    {
+#if defined(RK_MATH_SSE)
+        return _mm_xor_ps(Vector, _mm_set1_ps(-0.0f));
+#elif defined(RK_MATH_NEON)
+        return vnegq_f32(Vector);
+#else
+        return SVectorRegister { { -Vector.V[0], -Vector.V[1], -Vector.V[2], -Vector.V[3] } };
+#endif
+    }
+
+    inline SVectorRegister Abs(SVectorRegister Vector)
+    {
+#if defined(RK_MATH_SSE)
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f), Vector);
+#elif defined(RK_MATH_NEON)
+        return vabsq_f32(Vector);
+#else
+        return SVectorRegister { { std::fabs(Vector.V[0]), std::fabs(Vector.V[1]), std::fabs(Vector.V[2]), std::fabs(Vector.V[3]) } };
+#endif
+    }
+
+    inline SVectorRegister Sqrt(SVectorRegister Vector)
+    {
+#if defined(RK_MATH_SSE)
+        return _mm_sqrt_ps(Vector);
+#elif defined(RK_MATH_NEON)
+        return vsqrtq_f32(Vector);
+#else
+        return SVectorRegister { { std::sqrt(Vector.V[0]), std::sqrt(Vector.V[1]), std::sqrt(Vector.V[2]), std::sqrt(Vector.V[3]) } };
+#endif
+    }
+
+    /* 1 / Sqrt(Vector) at full precision. */
+    inline SVectorRegister ReciprocalSqrt(SVectorRegister Vector)
+    {
+        return Divide(Splat(1.0f), Sqrt(Vector));
+    }
+
+    /* Copies X, Y and Z of Vector and sets W to zero. */
+    inline SVectorRegister ClearW(SVectorRegister Vector)
+    {
+#if defined(RK_MATH_SSE4)
+        return _mm_blend_ps(Vector, _mm_setzero_ps(), 0x8);
+#elif defined(RK_MATH_SSE)
+        return _mm_and_ps(Vector, _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0)));
+#elif defined(RK_MATH_NEON)
+        return vsetq_lane_f32(0.0f, Vector, 3);
+#else
+        return SVectorRegister { { Vector.V[0], Vector.V[1], Vector.V[2], 0.0f } };
+#endif
+    }
+
+    /* Sum of the lanes, replicated to all four lanes. */
+    inline SVectorRegister HorizontalAdd(SVectorRegister Vector)
+    {
+#if defined(RK_MATH_SSE)
+        const SVectorRegister Pairs = _mm_add_ps(Vector, Swizzle<1, 0, 3, 2>(Vector));
+        return _mm_add_ps(Pairs, Swizzle<2, 3, 0, 1>(Pairs));
+#elif defined(RK_MATH_NEON)
+        return vdupq_n_f32(vaddvq_f32(Vector));
+#else
+        return Splat((Vector.V[0] + Vector.V[1]) + (Vector.V[2] + Vector.V[3]));
+#endif
+    }
+
+    /* Dot product of X, Y and Z, replicated to all four lanes. */
+    inline SVectorRegister Dot3(SVectorRegister A, SVectorRegister B)
+    {
+#if defined(RK_MATH_SSE4)
+        return _mm_dp_ps(A, B, 0x7F);
+#else
+        return HorizontalAdd(ClearW(Multiply(A, B)));
+#endif
+    }
+
+    /* Dot product of all four lanes, replicated to all four lanes. */
+    inline SVectorRegister Dot4(SVectorRegister A, SVectorRegister B)
+    {
+#if defined(RK_MATH_SSE4)
+        return _mm_dp_ps(A, B, 0xFF);
+#else
+        return HorizontalAdd(Multiply(A, B));
+#endif
+    }
+
+    /* Cross product of X, Y and Z. W is zero when the W lanes of A and B are finite. */
+    inline SVectorRegister Cross3(SVectorRegister A, SVectorRegister B)
+    {
+        const SVectorRegister AYZX = Swizzle<1, 2, 0, 3>(A);
+        const SVectorRegister BYZX = Swizzle<1, 2, 0, 3>(B);
+        // A.yzx * B.zxy - A.zxy * B.yzx, with the shared swizzle factored out.
+        return Swizzle<1, 2, 0, 3>(NegativeMultiplySubtract(AYZX, B, Multiply(A, BYZX)));
+    }
+
+    /* Per-lane Mask ? A : B. Mask lanes must be all ones or all zeros, as produced by the comparisons. */
+    inline SVectorRegister Select(SVectorRegister Mask, SVectorRegister A, SVectorRegister B)
+    {
+#if defined(RK_MATH_SSE4)
+        return _mm_blendv_ps(B, A, Mask);
+#elif defined(RK_MATH_SSE)
+        return _mm_or_ps(_mm_and_ps(Mask, A), _mm_andnot_ps(Mask, B));
+#elif defined(RK_MATH_NEON)
+        return vbslq_f32(vreinterpretq_u32_f32(Mask), A, B);
+#else
+        SVectorRegister Result;
+        for (uint32 Lane = 0; Lane < 4; ++Lane)
+        {
+            uint32 Bits;
+            std::memcpy(&Bits, &Mask.V[Lane], sizeof(Bits));
+            Result.V[Lane] = Bits ? A.V[Lane] : B.V[Lane];
+        }
+        return Result;
+#endif
+    }
+
+#if defined(RK_MATH_SCALAR)
+    inline SVectorRegister MakeMask(bool X, bool Y, bool Z, bool W)
+    {
+        const uint32 Bits[4] = { X ? ~0u : 0u, Y ? ~0u : 0u, Z ? ~0u : 0u, W ? ~0u : 0u };
+        SVectorRegister Result;
+        std::memcpy(Result.V, Bits, sizeof(Bits));
+        return Result;
+    }
+#endif
+
+    inline SVectorRegister CompareEqual(SVectorRegister A, SVectorRegister B)
+    {
+#if defined(RK_MATH_SSE)
+        return _mm_cmpeq_ps(A, B);
+#elif defined(RK_MATH_NEON)
+        return vreinterpretq_f32_u32(vceqq_f32(A, B));
+#else
+        return MakeMask(A.V[0] == B.V[0], A.V[1] == B.V[1], A.V[2] == B.V[2], A.V[3] == B.V[3]);
+#endif
+    }
+
+    inline SVectorRegister CompareGreater(SVectorRegister A, SVectorRegister B)
+    {
+#if defined(RK_MATH_SSE)
+        return _mm_cmpgt_ps(A, B);
+#elif defined(RK_MATH_NEON)
+        return vreinterpretq_f32_u32(vcgtq_f32(A, B));
+#else
+        return MakeMask(A.V[0] > B.V[0], A.V[1] > B.V[1], A.V[2] > B.V[2], A.V[3] > B.V[3]);
+#endif
+    }
+
+    /* Bit N is set when lane N of Mask is set. */
+    inline uint32 GetMaskBits(SVectorRegister Mask)
+    {
+#if defined(RK_MATH_SSE)
+        return static_cast<uint32>(_mm_movemask_ps(Mask));
+#elif defined(RK_MATH_NEON)
+        static const int32 Shifts[4] = { 0, 1, 2, 3 };
+        const uint32x4_t Bits = vshlq_u32(vshrq_n_u32(vreinterpretq_u32_f32(Mask), 31), vld1q_s32(Shifts));
+        return vaddvq_u32(Bits);
+#else
+        uint32 Bits = 0;
+        for (uint32 Lane = 0; Lane < 4; ++Lane)
+        {
+            uint32 LaneBits;
+            std::memcpy(&LaneBits, &Mask.V[Lane], sizeof(LaneBits));
+            Bits |= (LaneBits >> 31) << Lane;
+        }
+        return Bits;
+#endif
+    }
+
+    /* 1 / Sqrt(Vector) at EMathAccuracy::Estimate. */
+    inline SVectorRegister ReciprocalSqrtEstimate(SVectorRegister Vector)
+    {
+#if defined(RK_MATH_SSE)
+        return _mm_rsqrt_ps(Vector);
+#elif defined(RK_MATH_NEON)
+        // The NEON estimate has about 8 bits, one step brings it to the bound of the tier.
+        const float32x4_t Estimate = vrsqrteq_f32(Vector);
+        return vmulq_f32(Estimate, vrsqrtsq_f32(vmulq_f32(Vector, Estimate), Estimate));
+#else
+        return ReciprocalSqrt(Vector);
+#endif
+    }
+
+    /* 1 / Sqrt(Vector) at EMathAccuracy::Fast. */
+    inline SVectorRegister ReciprocalSqrtFast(SVectorRegister Vector)
+    {
+#if defined(RK_MATH_SSE)
+        // Y * (3 - X * Y * Y) / 2. Zero and infinite inputs make the step NaN, for them the estimate is already exact.
+        const SVectorRegister Estimate = _mm_rsqrt_ps(Vector);
+        const SVectorRegister Step = NegativeMultiplySubtract(Multiply(Vector, Estimate), Estimate, Splat(3.0f));
+        const SVectorRegister Refined = Multiply(Multiply(Splat(0.5f), Estimate), Step);
+        return Select(CompareEqual(Refined, Refined), Refined, Estimate);
+#elif defined(RK_MATH_NEON)
+        const float32x4_t Estimate = ReciprocalSqrtEstimate(Vector);
+        return vmulq_f32(Estimate, vrsqrtsq_f32(vmulq_f32(Vector, Estimate), Estimate));
+#else
+        return ReciprocalSqrt(Vector);
+#endif
+    }
+
+    /* Sqrt(Vector) at EMathAccuracy::Estimate. */
+    inline SVectorRegister SqrtEstimate(SVectorRegister Vector)
+    {
+#if defined(RK_MATH_SCALAR)
+        return Sqrt(Vector);
+#else
+        // Clamping the infinite estimate of zero keeps 0 * Estimate at zero.
+        return Multiply(Vector, Min(ReciprocalSqrtEstimate(Vector), Splat(3.402823466e+38f)));
+#endif
+    }
+
+    /* Sqrt(Vector) at EMathAccuracy::Fast. */
+    inline SVectorRegister SqrtFast(SVectorRegister Vector)
+    {
+#if defined(RK_MATH_SCALAR)
+        return Sqrt(Vector);
+#else
+        // The Newton step is applied to S = X * Y directly: S * (3 - S * Y) / 2 stays zero for zero inputs.
+        const SVectorRegister Estimate = Min(ReciprocalSqrtEstimate(Vector), Splat(3.402823466e+38f));
+        const SVectorRegister Root = Multiply(Vector, Estimate);
+        return Multiply(Multiply(Splat(0.5f), Root), NegativeMultiplySubtract(Root, Estimate, Splat(3.0f)));
+#endif
+    }
+
+    inline SVectorRegister Sqrt(SVectorRegister Vector, EMathAccuracy Accuracy)
+    {
+        switch (Accuracy)
+        {
+            case EMathAccuracy::Fast:       return SqrtFast(Vector);
+            case EMathAccuracy::Estimate:   return SqrtEstimate(Vector);
+            default:                        return Sqrt(Vector);
+        }
+    }
+
+    inline SVectorRegister ReciprocalSqrt(SVectorRegister Vector, EMathAccuracy Accuracy)
+    {
+        switch (Accuracy)
+        {
+            case EMathAccuracy::Fast:       return ReciprocalSqrtFast(Vector);
+            case EMathAccuracy::Estimate:   return ReciprocalSqrtEstimate(Vector);
+            default:                        return ReciprocalSqrt(Vector);
+        }
+    }
+}
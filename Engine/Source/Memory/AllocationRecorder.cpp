@@ -0,0 +1,388 @@
+#include "EnginePCH.h"
+#include "AllocationRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+#include "Memory/Mem.h"
+
+std::atomic<bool> AllocationRecorder::bRecording { false };
+
+namespace
+{
+    using namespace AllocationCapture;
+
+    static constexpr uint32 ThreadBufferSize = 64 * 1024;
+    static constexpr uint32 MaxEventSize = sizeof(SEvent) + MaxFrames * sizeof(uint64);
+
+    /*
+     * Events of one thread waiting to be flushed. The owner holds bLocked while appending, Stop takes it to flush
+     * buffers of other threads. Like the memory counters, buffers are never freed and are reused after thread exit.
+     */
+    struct SThreadBuffer
+    {
+        std::atomic<bool> bLocked { false };
+
+        std::atomic<bool> bInUse { true };
+
+        SThreadBuffer* Next = nullptr;
+
+        uint32 ThreadId = 0;
+
+        uint32 Used = 0;
+
+        uint32 NumEvents = 0;
+
+        uint32 NumAllocations = 0;
+
+        alignas(8) uint8 Data[ThreadBufferSize];
+    };
+
+    struct SCaptureFile
+    {
+        uint8* View = nullptr;
+
+        uint64 Capacity = 0;
+
+#ifdef _WIN32
+        HANDLE File = INVALID_HANDLE_VALUE;
+        HANDLE Mapping = nullptr;
+#else
+        int File = -1;
+#endif
+    };
+
+    static SCaptureFile GCapture;
+
+    static std::atomic<uint64> GWriteOffset { 0 };
+
+    // Offset of the first block that did not fit, every later block fails as well.
+    static std::atomic<uint64> GOverflowOffset { ~0ull };
+
+    static std::atomic<uint64> GNumEvents { 0 };
+    static std::atomic<uint64> GNumDroppedEvents { 0 };
+
+    static std::atomic<uint32> GNextThreadId { 0 };
+
+    static std::atomic<SThreadBuffer*> GThreadBuffersHead { nullptr };
+
+    static uint32 GStackSampleRate = 64;
+
+    static std::chrono::steady_clock::time_point GStartTime;
+
+    static thread_local SThreadBuffer* GThreadBuffer = nullptr;
+    static thread_local bool bThreadBufferReleased = false;
+
+    static void FlushThreadBuffer(SThreadBuffer& Buffer)
+    {
+        if (Buffer.Used == 0)
+        {
+            return;
+        }
+
+        const uint64 BlockSize = sizeof(SBlockHeader) + Buffer.Used;
+        const uint64 Offset = GWriteOffset.fetch_add(BlockSize, std::memory_order_relaxed);
+        if (Offset + BlockSize <= GCapture.Capacity)
+        {
+            SBlockHeader Header { Buffer.ThreadId, Buffer.Used };
+            std::memcpy(GCapture.View + Offset, &Header, sizeof(Header));
+            std::memcpy(GCapture.View + Offset + sizeof(Header), Buffer.Data, Buffer.Used);
+            GNumEvents.fetch_add(Buffer.NumEvents, std::memory_order_relaxed);
+        }
+        else
+        {
+            uint64 OverflowOffset = GOverflowOffset.load(std::memory_order_relaxed);
+            while (Offset < OverflowOffset && !GOverflowOffset.compare_exchange_weak(OverflowOffset, Offset, std::memory_order_relaxed))
+            {
+            }
+            GNumDroppedEvents.fetch_add(Buffer.NumEvents, std::memory_order_relaxed);
+        }
+
+        Buffer.Used = 0;
+        Buffer.NumEvents = 0;
+    }
+
+    static void LockThreadBuffer(SThreadBuffer& Buffer)
+    {
+        while (Buffer.bLocked.exchange(true, std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    struct SThreadBufferOwner
+    {
+        bool bAcquired = false;
+
+        ~SThreadBufferOwner()
+        {
+            if (GThreadBuffer != nullptr)
+            {
+                LockThreadBuffer(*GThreadBuffer);
+                if (AllocationRecorder::bRecording.load(std::memory_order_acquire))
+                {
+                    FlushThreadBuffer(*GThreadBuffer);
+                }
+                GThreadBuffer->bLocked.store(false, std::memory_order_release);
+
+                GThreadBuffer->bInUse.store(false, std::memory_order_release);
+                GThreadBuffer = nullptr;
+            }
+            bThreadBufferReleased = true;
+        }
+    };
+    static thread_local SThreadBufferOwner GThreadBufferOwner;
+
+    static SThreadBuffer* AcquireThreadBuffer()
+    {
+        SThreadBuffer* Buffer = nullptr;
+        for (SThreadBuffer* Candidate = GThreadBuffersHead.load(std::memory_order_acquire); Candidate != nullptr; Candidate = Candidate->Next)
+        {
+            bool bExpected = false;
+            if (Candidate->bInUse.compare_exchange_strong(bExpected, true, std::memory_order_acquire))
+            {
+                Buffer = Candidate;
+                break;
+            }
+        }
+
+        if (Buffer == nullptr)
+        {
+            // Allocated with malloc so that registering a thread never recurses into operator new.
+            void* Block = std::malloc(sizeof(SThreadBuffer));
+            if (Block == nullptr)
+            {
+                return nullptr;
+            }
+
+            Buffer = new (Block) SThreadBuffer();
+            Buffer->Next = GThreadBuffersHead.load(std::memory_order_relaxed);
+            while (!GThreadBuffersHead.compare_exchange_weak(Buffer->Next, Buffer, std::memory_order_release, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        Buffer->ThreadId = GNextThreadId.fetch_add(1, std::memory_order_relaxed);
+        GThreadBufferOwner.bAcquired = true;
+        return Buffer;
+    }
+
+    static void RecordEvent(EEventType Type, const void* Address, size_t Size, uint8 Tag)
+    {
+        SThreadBuffer* Buffer = GThreadBuffer;
+        if (Buffer == nullptr)
+        {
+            if (bThreadBufferReleased)
+            {
+                return;
+            }
+
+            Buffer = GThreadBuffer = AcquireThreadBuffer();
+            if (Buffer == nullptr)
+            {
+                return;
+            }
+        }
+
+        // Fails only while Stop flushes this buffer, or when the unwinder allocates while an event is being written.
+        if (Buffer->bLocked.exchange(true, std::memory_order_acquire))
+        {
+            return;
+        }
+
+        if (AllocationRecorder::bRecording.load(std::memory_order_acquire))
+        {
+            if (Buffer->Used + MaxEventSize > ThreadBufferSize)
+            {
+                FlushThreadBuffer(*Buffer);
+            }
+
+            SEvent Event;
+            Event.Timestamp = static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - GStartTime).count());
+            Event.Address = static_cast<uint64>(reinterpret_cast<uintptr_t>(Address));
+            Event.Size = Size;
+            Event.Type = Type;
+            Event.Tag = Tag;
+            Event.NumFrames = 0;
+            std::memset(Event.Reserved, 0, sizeof(Event.Reserved));
+
+            uint64* Frames = reinterpret_cast<uint64*>(Buffer->Data + Buffer->Used + sizeof(SEvent));
+            if (Type == EEventType::Allocate && ++Buffer->NumAllocations % GStackSampleRate == 0)
+            {
+                // Skips RecordEvent and RecordAllocation.
+                void* Stack[MaxFrames];
+                Event.NumFrames = static_cast<uint8>(Mem::CaptureCallStack(Stack, MaxFrames, 2));
+                for (uint32 Frame = 0; Frame < Event.NumFrames; ++Frame)
+                {
+                    Frames[Frame] = static_cast<uint64>(reinterpret_cast<uintptr_t>(Stack[Frame]));
+                }
+            }
+
+            std::memcpy(Buffer->Data + Buffer->Used, &Event, sizeof(SEvent));
+            Buffer->Used += sizeof(SEvent) + Event.NumFrames * sizeof(uint64);
+            ++Buffer->NumEvents;
+        }
+
+        Buffer->bLocked.store(false, std::memory_order_release);
+    }
+
+    static bool OpenCaptureFile(const char* Path, uint64 Capacity)
+    {
+#ifdef _WIN32
+        GCapture.File = CreateFileA(Path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (GCapture.File == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        GCapture.Mapping = CreateFileMappingA(GCapture.File, nullptr, PAGE_READWRITE, static_cast<DWORD>(Capacity >> 32), static_cast<DWORD>(Capacity), nullptr);
+        void* View = GCapture.Mapping ? MapViewOfFile(GCapture.Mapping, FILE_MAP_WRITE, 0, 0, static_cast<SIZE_T>(Capacity)) : nullptr;
+        if (View == nullptr)
+        {
+            if (GCapture.Mapping)
+            {
+                CloseHandle(GCapture.Mapping);
+                GCapture.Mapping = nullptr;
+            }
+            CloseHandle(GCapture.File);
+            GCapture.File = INVALID_HANDLE_VALUE;
+            return false;
+        }
+#else
+        GCapture.File = open(Path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (GCapture.File < 0)
+        {
+            return false;
+        }
+
+        void* View = ftruncate(GCapture.File, static_cast<off_t>(Capacity)) == 0 ? mmap(nullptr, Capacity, PROT_READ | PROT_WRITE, MAP_SHARED, GCapture.File, 0) : MAP_FAILED;
+        if (View == MAP_FAILED)
+        {
+            close(GCapture.File);
+            GCapture.File = -1;
+            return false;
+        }
+#endif
+
+        GCapture.View = static_cast<uint8*>(View);
+        GCapture.Capacity = Capacity;
+        return true;
+    }
+
+    static void CloseCaptureFile(uint64 Size)
+    {
+#ifdef _WIN32
+        FlushViewOfFile(GCapture.View, 0);
+        UnmapViewOfFile(GCapture.View);
+        CloseHandle(GCapture.Mapping);
+
+        LARGE_INTEGER End;
+        End.QuadPart = static_cast<LONGLONG>(Size);
+        SetFilePointerEx(GCapture.File, End, nullptr, FILE_BEGIN);
+        SetEndOfFile(GCapture.File);
+        CloseHandle(GCapture.File);
+
+        GCapture.Mapping = nullptr;
+        GCapture.File = INVALID_HANDLE_VALUE;
+#else
+        msync(GCapture.View, GCapture.Capacity, MS_SYNC);
+        munmap(GCapture.View, GCapture.Capacity);
+        // A failed trim only leaves unused space behind the data, readers stop at DataSize.
+        [[maybe_unused]] const int TruncateResult = ftruncate(GCapture.File, static_cast<off_t>(Size));
+        close(GCapture.File);
+
+        GCapture.File = -1;
+#endif
+
+        GCapture.View = nullptr;
+        GCapture.Capacity = 0;
+    }
+}
+
+bool AllocationRecorder::Start(const char* Path, size_t MaxFileSize, uint32 StackSampleRate)
+{
+    if (IsRecording() || MaxFileSize <= sizeof(SFileHeader) || !OpenCaptureFile(Path, MaxFileSize))
+    {
+        return false;
+    }
+
+    // Buffers left over from a previous capture still hold events that were never flushed.
+    for (SThreadBuffer* Buffer = GThreadBuffersHead.load(std::memory_order_acquire); Buffer != nullptr; Buffer = Buffer->Next)
+    {
+        LockThreadBuffer(*Buffer);
+        Buffer->Used = 0;
+        Buffer->NumEvents = 0;
+        Buffer->bLocked.store(false, std::memory_order_release);
+    }
+
+    GWriteOffset.store(sizeof(SFileHeader), std::memory_order_relaxed);
+    GOverflowOffset.store(~0ull, std::memory_order_relaxed);
+    GNumEvents.store(0, std::memory_order_relaxed);
+    GNumDroppedEvents.store(0, std::memory_order_relaxed);
+    GStackSampleRate = std::max<uint32>(StackSampleRate, 1);
+    GStartTime = std::chrono::steady_clock::now();
+
+    bRecording.store(true, std::memory_order_release);
+    return true;
+}
+
+void AllocationRecorder::Stop()
+{
+    if (!IsRecording())
+    {
+        return;
+    }
+
+    // Writers re-check the flag under their buffer lock, so none can append once its buffer has been flushed here.
+    bRecording.store(false, std::memory_order_seq_cst);
+    for (SThreadBuffer* Buffer = GThreadBuffersHead.load(std::memory_order_acquire); Buffer != nullptr; Buffer = Buffer->Next)
+    {
+        LockThreadBuffer(*Buffer);
+        FlushThreadBuffer(*Buffer);
+        Buffer->bLocked.store(false, std::memory_order_release);
+    }
+
+    const uint64 End = std::min(GWriteOffset.load(std::memory_order_relaxed), GOverflowOffset.load(std::memory_order_relaxed));
+
+    SFileHeader Header;
+    std::memset(&Header, 0, sizeof(Header));
+    Header.Magic = Magic;
+    Header.Version = Version;
+    Header.DataSize = End - sizeof(SFileHeader);
+    Header.NumEvents = GNumEvents.load(std::memory_order_relaxed);
+    Header.NumDroppedEvents = GNumDroppedEvents.load(std::memory_order_relaxed);
+    Header.StackSampleRate = GStackSampleRate;
+    Header.NumTags = std::min<uint32>(static_cast<uint32>(EMemoryTag::Count), MaxTags);
+    for (uint32 Tag = 0; Tag < Header.NumTags; ++Tag)
+    {
+        std::strncpy(Header.TagNames[Tag], Mem::GetTagName(static_cast<EMemoryTag>(Tag)), MaxTagNameLength - 1);
+    }
+    std::memcpy(GCapture.View, &Header, sizeof(Header));
+
+    CloseCaptureFile(End);
+}
+
+void AllocationRecorder::RecordAllocation(const void* Address, size_t Size, uint8 Tag)
+{
+    RecordEvent(EEventType::Allocate, Address, Size, Tag);
+}
+
+void AllocationRecorder::RecordFree(const void* Address, size_t Size, uint8 Tag)
+{
+    RecordEvent(EEventType::Free, Address, Size, Tag);
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include "Math/MathTypes.h"
+
+/*
+ * Binary layout of an allocation capture. The file starts with SFileHeader, followed by blocks that each hold the
+ * events one thread buffered between two flushes. An event is an SEvent followed by NumFrames 64-bit return
+ * addresses. Events are ordered within a block but blocks of different threads interleave, so readers sort by time.
+ * Only fixed-width types are used so captures can be read by tools that do not link the engine.
+ */
+namespace AllocationCapture
+{
+    static constexpr uint32 Magic = 0x4C414B52; // "RKAL"
+    static constexpr uint32 Version = 1;
+
+    static constexpr uint32 MaxTags = 16;
+    static constexpr uint32 MaxTagNameLength = 16;
+    static constexpr uint32 MaxFrames = 16;
+
+    struct SFileHeader
+    {
+        uint32 Magic;
+        uint32 Version;
+
+        // Bytes of block data following the header.
+        uint64 DataSize;
+
+        uint64 NumEvents;
+        uint64 NumDroppedEvents;
+
+        // One allocation in StackSampleRate per thread carries a call stack.
+        uint32 StackSampleRate;
+
+        uint32 NumTags;
+        char TagNames[MaxTags][MaxTagNameLength];
+    };
+
+    struct SBlockHeader
+    {
+        uint32 ThreadId;
+
+        // Bytes of events following this header.
+        uint32 Size;
+    };
+
+    enum class EEventType : uint8
+    {
+        Allocate,
+        Free
+    };
+
+    struct SEvent
+    {
+        // Nanoseconds since the capture started.
+        uint64 Timestamp;
+
+        uint64 Address;
+        uint64 Size;
+
+        EEventType Type;
+        uint8 Tag;
+        uint8 NumFrames;
+        uint8 Reserved[5];
+    };
+    static_assert(sizeof(SEvent) == 32, "Capture events must keep their on-disk size.");
+}
+
+/*
+ * Streams every tracked heap allocation and free to a memory-mapped capture file. Events are appended to a
+ * per-thread buffer and only the flush of a full buffer touches shared state, a single atomic bump of the file
+ * write offset. The recorder never uses operator new itself. Once the file is full further events are dropped
+ * and counted in the header. Analyse captures with the AllocationReport tool.
+ */
+namespace AllocationRecorder
+{
+    bool Start(const char* Path, size_t MaxFileSize = 1024ull * 1024 * 1024, uint32 StackSampleRate = 64);
+
+    // Flushes every thread buffer, finalizes the header and truncates the file to the recorded size.
+    void Stop();
+
+    extern std::atomic<bool> bRecording;
+
+    inline bool IsRecording()
+    {
+        return bRecording.load(std::memory_order_relaxed);
+    }
+
+    // Called by the tracked allocator.
+    void RecordAllocation(const void* Address, size_t Size, uint8 Tag);
+    void RecordFree(const void* Address, size_t Size, uint8 Tag);
+}
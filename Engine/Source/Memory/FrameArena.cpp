@@ -0,0 +1,96 @@
+#include "EnginePCH.h"
+#include "FrameArena.h"
+
+#include <cstdlib>
+
+#include "Core/Assert.h"
+#include "Memory/Mem.h"
+
+namespace Utils
+{
+    static inline uintptr_t AlignUp(uintptr_t Value, size_t Alignment)
+    {
+        return (Value + (Alignment - 1)) & ~(static_cast<uintptr_t>(Alignment) - 1);
+    }
+}
+
+CLinearArena::CLinearArena(size_t InCapacity)
+{
+    Init(InCapacity);
+}
+
+CLinearArena::~CLinearArena()
+{
+    Destroy();
+}
+
+void CLinearArena::Init(size_t InCapacity)
+{
+    Destroy();
+
+    Data = static_cast<uint8*>(Mem::MallocAligned(InCapacity, CACHE_LINE_SIZE));
+    RK_ENGINE_ASSERT(Data, "Failed to allocate linear arena.");
+    Capacity = InCapacity;
+}
+
+void CLinearArena::Destroy()
+{
+    Reset();
+
+    Mem::FreeAligned(Data);
+    Data = nullptr;
+    Capacity = 0;
+    HighWaterMark = 0;
+}
+
+void* CLinearArena::Allocate(size_t Size, size_t Alignment)
+{
+    RK_ENGINE_ASSERT((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two.");
+
+    const uintptr_t Base = reinterpret_cast<uintptr_t>(Data);
+    const uintptr_t Aligned = Utils::AlignUp(Base + Offset, Alignment);
+    const size_t NewOffset = static_cast<size_t>(Aligned - Base) + Size;
+
+    if (Data == nullptr || NewOffset > Capacity)
+    {
+        return AllocateOverflow(Size, Alignment);
+    }
+
+    Offset = NewOffset;
+    if (GetUsed() > HighWaterMark)
+    {
+        HighWaterMark = GetUsed();
+    }
+    return reinterpret_cast<void*>(Aligned);
+}
+
+void* CLinearArena::AllocateOverflow(size_t Size, size_t Alignment)
+{
+    // The chunk header is followed by enough slack to align the user block.
+    const size_t ChunkSize = sizeof(SOverflowChunk) + Alignment + Size;
+    SOverflowChunk* Chunk = static_cast<SOverflowChunk*>(std::malloc(ChunkSize));
+    RK_ENGINE_ASSERT(Chunk, "Failed to allocate linear arena overflow chunk.");
+
+    Chunk->Next = OverflowChunks;
+    OverflowChunks = Chunk;
+    OverflowSize += Size;
+
+    if (GetUsed() > HighWaterMark)
+    {
+        HighWaterMark = GetUsed();
+    }
+    return reinterpret_cast<void*>(Utils::AlignUp(reinterpret_cast<uintptr_t>(Chunk + 1), Alignment));
+}
+
+void CLinearArena::Reset()
+{
+    while (OverflowChunks != nullptr)
+    {
+        SOverflowChunk* Next = OverflowChunks->Next;
+        std::free(OverflowChunks);
+        OverflowChunks = Next;
+    }
+
+    Offset = 0;
+    OverflowSize = 0;
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Math/MathTypes.h"
+
+/*
+ * Bump pointer allocator over a single contiguous block. Allocations are never freed individually,
+ * the whole block is recycled at once with Reset(). Destructors are never run, so only trivially
+ * destructible objects may be created with New/NewArray.
+ *
+ * Allocations that do not fit in the block are served from overflow chunks on the heap, which are
+ * released on the next Reset(). The overflow size is reported so the block capacity can be tuned.
+ */
+class CLinearArena
+{
+public:
+    CLinearArena() = default;
+    explicit CLinearArena(size_t InCapacity);
+    ~CLinearArena();
+
+    CLinearArena(const CLinearArena&) = delete;
+    CLinearArena& operator=(const CLinearArena&) = delete;
+
+    void Init(size_t InCapacity);
+    void Destroy();
+
+    void* Allocate(size_t Size, size_t Alignment = alignof(std::max_align_t));
+
+    template<typename TObject, typename... TArgs>
+    TObject* New(TArgs&&... Args)
+    {
+        static_assert(std::is_trivially_destructible_v<TObject>, "Arena objects are never destroyed.");
+        return new (Allocate(sizeof(TObject), alignof(TObject))) TObject(std::forward<TArgs>(Args)...);
+    }
+
+    template<typename TObject>
+    TObject* NewArray(size_t Count)
+    {
+        static_assert(std::is_trivially_destructible_v<TObject>, "Arena objects are never destroyed.");
+        TObject* Objects = static_cast<TObject*>(Allocate(Count * sizeof(TObject), alignof(TObject)));
+        for (size_t Index = 0; Index < Count; ++Index)
+        {
+            new (Objects + Index) TObject();
+        }
+        return Objects;
+    }
+
+    // Recycles every allocation made since the last reset and frees the overflow chunks.
+    void Reset();
+
+    inline size_t GetCapacity() const { return Capacity; }
+    inline size_t GetUsed() const { return Offset + OverflowSize; }
+    inline size_t GetOverflowSize() const { return OverflowSize; }
+    inline size_t GetHighWaterMark() const { return HighWaterMark; }
+
+private:
+    struct SOverflowChunk
+    {
+        SOverflowChunk* Next;
+    };
+
+    void* AllocateOverflow(size_t Size, size_t Alignment);
+
+    uint8* Data = nullptr;
+
+    size_t Capacity = 0;
+
+    size_t Offset = 0;
+
+    size_t OverflowSize = 0;
+
+    size_t HighWaterMark = 0;
+
+    SOverflowChunk* OverflowChunks = nullptr;
+};
+
+/*
+ * Container allocator drawing from a linear arena, e.g. TArray<T, SArenaAllocator>. Free is a no-op,
+ * the memory is reclaimed when the arena is reset, so the container must not outlive that reset.
+ */
+struct SArenaAllocator
+{
+    CLinearArena* Arena = nullptr;
+
+    SArenaAllocator() = default;
+
+    SArenaAllocator(CLinearArena& InArena)
+        : Arena(&InArena)
+    {
+    }
+
+    inline void* Allocate(size_t Size, size_t Alignment)
+    {
+        return Arena->Allocate(Size, Alignment);
+    }
+
+    inline void Free(void* /*Block*/, size_t /*Size*/)
+    {
+    }
+};
+
+/*
+ * One linear arena per frame in flight. A frame's arena is only recycled once the GPU has signalled that
+ * the frame slot is free again, so transient data may be referenced until the frame has been fully consumed.
+ */
+template<uint32 NumFrames>
+class TFrameArena
+{
+public:
+    void Init(size_t CapacityPerFrame)
+    {
+        for (CLinearArena& Arena : Arenas)
+        {
+            Arena.Init(CapacityPerFrame);
+        }
+    }
+
+    void Destroy()
+    {
+        for (CLinearArena& Arena : Arenas)
+        {
+            Arena.Destroy();
+        }
+    }
+
+    // Must only be called after the fence guarding FrameIndex has signalled.
+    void BeginFrame(uint32 FrameIndex)
+    {
+        CurrentFrame = FrameIndex % NumFrames;
+        Arenas[CurrentFrame].Reset();
+    }
+
+    inline void* Allocate(size_t Size, size_t Alignment = alignof(std::max_align_t))
+    {
+        return Arenas[CurrentFrame].Allocate(Size, Alignment);
+    }
+
+    template<typename TObject, typename... TArgs>
+    inline TObject* New(TArgs&&... Args)
+    {
+        return Arenas[CurrentFrame].template New<TObject>(std::forward<TArgs>(Args)...);
+    }
+
+    template<typename TObject>
+    inline TObject* NewArray(size_t Count)
+    {
+        return Arenas[CurrentFrame].template NewArray<TObject>(Count);
+    }
+
+    inline CLinearArena& GetCurrent()
+    {
+        return Arenas[CurrentFrame];
+    }
+
+    inline const CLinearArena& GetCurrent() const
+    {
+        return Arenas[CurrentFrame];
+    }
+
+    size_t GetHighWaterMark() const
+    {
+        size_t HighWaterMark = 0;
+        for (const CLinearArena& Arena : Arenas)
+        {
+            if (Arena.GetHighWaterMark() > HighWaterMark)
+            {
+                HighWaterMark = Arena.GetHighWaterMark();
+            }
+        }
+        return HighWaterMark;
+    }
+
+private:
+    CLinearArena Arenas[NumFrames];
+
+    uint32 CurrentFrame = 0;
+};
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Math/MathTypes.h"
+#include "Memory/Memory.h"
+
+template<typename TSignature, size_t InlineBytes = 32>
+class TFunction;
+
+/*
+ * Move-only callable wrapper that never allocates. The callable is stored inline and a capture larger than
+ * InlineBytes is a compile error rather than a silent heap fallback. Callables that are trivially relocatable
+ * and destructible carry no manager, so moving the function is a plain copy of its storage.
+ */
+template<typename TReturn, typename... TArgs, size_t InlineBytes>
+class TFunction<TReturn(TArgs...), InlineBytes>
+{
+private:
+    enum class EOperation : uint8
+    {
+        Relocate,
+        Destroy
+    };
+
+    using FInvoker = TReturn (*)(void*, TArgs&&...);
+    using FManager = void (*)(EOperation, void*, void*);
+
+    alignas(std::max_align_t) mutable uint8 Storage[InlineBytes] = {};
+
+    FInvoker Invoker = nullptr;
+
+    // Null when the callable can be relocated with memcpy and needs no destructor.
+    FManager Manager = nullptr;
+
+    template<typename TCallable>
+    static TReturn Invoke(void* InStorage, TArgs&&... Args)
+    {
+        return (*static_cast<TCallable*>(InStorage))(std::forward<TArgs>(Args)...);
+    }
+
+    template<typename TCallable>
+    static void Manage(EOperation Operation, void* Destination, void* Source)
+    {
+        TCallable* Callable = static_cast<TCallable*>(Source);
+        if (Operation == EOperation::Relocate)
+        {
+            new (Destination) TCallable(std::move(*Callable));
+        }
+        Callable->~TCallable();
+    }
+
+public:
+    TFunction() = default;
+
+    TFunction(std::nullptr_t)
+    {
+    }
+
+    template<typename TCallable, typename TDecayed = std::decay_t<TCallable>,
+        typename = std::enable_if_t<!std::is_same_v<TDecayed, TFunction> && std::is_invocable_r_v<TReturn, TDecayed&, TArgs...>>>
+    TFunction(TCallable&& Callable)
+    {
+        static_assert(sizeof(TDecayed) <= InlineBytes, "Callable capture does not fit in the TFunction inline storage, increase InlineBytes.");
+        static_assert(alignof(TDecayed) <= alignof(std::max_align_t), "Callable is over-aligned for TFunction storage.");
+
+        new (Storage) TDecayed(std::forward<TCallable>(Callable));
+        Invoker = &Invoke<TDecayed>;
+        if constexpr (!TIsTriviallyRelocatable<TDecayed>::value || !std::is_trivially_destructible_v<TDecayed>)
+        {
+            Manager = &Manage<TDecayed>;
+        }
+    }
+
+    TFunction(TFunction&& Other) noexcept
+    {
+        MoveFrom(Other);
+    }
+
+    ~TFunction()
+    {
+        Reset();
+    }
+
+    TFunction(const TFunction&) = delete;
+    TFunction& operator=(const TFunction&) = delete;
+
+    TFunction& operator=(TFunction&& Other) noexcept
+    {
+        if (this != &Other)
+        {
+            Reset();
+            MoveFrom(Other);
+        }
+        return *this;
+    }
+
+    TFunction& operator=(std::nullptr_t)
+    {
+        Reset();
+        return *this;
+    }
+
+    TReturn operator()(TArgs... Args) const
+    {
+        return Invoker(Storage, std::forward<TArgs>(Args)...);
+    }
+
+    explicit operator bool() const
+    {
+        return IsSet();
+    }
+
+    inline bool IsSet() const
+    {
+        return Invoker != nullptr;
+    }
+
+    void Reset()
+    {
+        if (Manager)
+        {
+            Manager(EOperation::Destroy, nullptr, Storage);
+        }
+        Invoker = nullptr;
+        Manager = nullptr;
+    }
+
+private:
+    // Expects this function to be empty.
+    void MoveFrom(TFunction& Other)
+    {
+        if (Other.Manager)
+        {
+            Other.Manager(EOperation::Relocate, Storage, Other.Storage);
+        }
+        else if (Other.Invoker)
+        {
+            std::memcpy(Storage, Other.Storage, InlineBytes);
+        }
+
+        Invoker = Other.Invoker;
+        Manager = Other.Manager;
+        Other.Invoker = nullptr;
+        Other.Manager = nullptr;
+    }
+};
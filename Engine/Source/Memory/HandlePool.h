@@ -0,0 +1,220 @@
+#pragma once
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Core/Assert.h"
+#include "Math/MathTypes.h"
+#include "Memory/Memory.h"
+
+/*
+ * Typed reference into a THandlePool: a slot index plus the generation the slot had when the handle was issued.
+ * 32-bit handles split into 20 index bits and 12 generation bits, 64-bit handles into 32 and 32. A zero handle is
+ * never issued and stays invalid. Handles are plain values, so they can be stored and passed between threads freely.
+ */
+template<typename TObject, typename TStorage = uint32>
+struct THandle
+{
+    static_assert(std::is_same_v<TStorage, uint32> || std::is_same_v<TStorage, uint64>, "Handles are 32 or 64 bits wide.");
+
+    static constexpr uint32 IndexBits = sizeof(TStorage) == 4 ? 20 : 32;
+    static constexpr uint32 GenerationBits = sizeof(TStorage) * 8 - IndexBits;
+    static constexpr TStorage IndexMask = (static_cast<TStorage>(1) << IndexBits) - 1;
+
+    // Generations wrap after 4095 reuses of a slot with 32-bit handles. A handle kept across that many reuses
+    // validates again and refers to whatever object then lives in the slot.
+    static constexpr TStorage GenerationMask = (static_cast<TStorage>(1) << GenerationBits) - 1;
+
+    TStorage Value = 0;
+
+    THandle() = default;
+
+    THandle(uint32 Index, uint32 Generation)
+        : Value((static_cast<TStorage>(Generation) << IndexBits) | Index)
+    {
+    }
+
+    inline uint32 GetIndex() const
+    {
+        return static_cast<uint32>(Value & IndexMask);
+    }
+
+    inline uint32 GetGeneration() const
+    {
+        return static_cast<uint32>((Value >> IndexBits) & GenerationMask);
+    }
+
+    inline bool IsSet() const
+    {
+        return Value != 0;
+    }
+
+    bool operator==(const THandle& Other) const { return Value == Other.Value; }
+    bool operator!=(const THandle& Other) const { return Value != Other.Value; }
+};
+
+template<typename TObject, typename TStorage>
+inline uint64 GetTypeHash(const THandle<TObject, TStorage>& Handle)
+{
+    return static_cast<uint64>(Handle.Value);
+}
+
+/*
+ * Owns objects in a densely packed array and hands out generational handles to them. Lookup and validation are
+ * a single indirection through the slot table, a handle to a destroyed object is detected by its stale generation,
+ * and iteration walks the dense array without gaps. Destroy moves the last object into the hole, so object
+ * addresses and iteration order are not stable.
+ *
+ * Once a slot has been reused 2^GenerationBits times its generation wraps and a very old handle could alias a new
+ * object, see THandle::GenerationMask; prefer 64-bit handles for long-lived, high churn resources. The pool itself
+ * is not thread safe.
+ */
+template<typename TObject, typename TStorage = uint32>
+class THandlePool
+{
+public:
+    using THandleType = THandle<TObject, TStorage>;
+
+private:
+    struct SSlot
+    {
+        // Index into Objects while the slot is alive, the next free slot otherwise. Freeing bumps Generation.
+        uint32 DenseIndexOrNextFree;
+
+        uint32 Generation;
+
+        // Checked besides the generation, so a wrapped handle can never resolve to a free slot.
+        bool bAlive;
+    };
+
+    static constexpr uint32 IndexNone = ~0u;
+
+    TArray<TObject> Objects;
+
+    // Slot index of each dense object, used to patch the slot of the object moved by Destroy.
+    TArray<uint32> DenseToSlot;
+
+    TArray<SSlot> Slots;
+
+    uint32 FreeSlots = IndexNone;
+
+public:
+    THandlePool() = default;
+
+    void Reserve(size_t NumObjects)
+    {
+        Objects.Reserve(NumObjects);
+        DenseToSlot.Reserve(NumObjects);
+        Slots.Reserve(NumObjects);
+    }
+
+    template<typename... TArgs>
+    THandleType Create(TArgs&&... Args)
+    {
+        uint32 SlotIndex = FreeSlots;
+        if (SlotIndex != IndexNone)
+        {
+            FreeSlots = Slots[SlotIndex].DenseIndexOrNextFree;
+        }
+        else
+        {
+            RK_ENGINE_ASSERT(Slots.GetSize() < THandleType::IndexMask, "Handle pool is out of indices.");
+            SlotIndex = static_cast<uint32>(Slots.GetSize());
+            Slots.Push(SSlot { IndexNone, 1, false });
+        }
+
+        SSlot& Slot = Slots[SlotIndex];
+        Slot.DenseIndexOrNextFree = static_cast<uint32>(Objects.GetSize());
+        Slot.bAlive = true;
+        Objects.Emplace(std::forward<TArgs>(Args)...);
+        DenseToSlot.Push(SlotIndex);
+
+        return THandleType(SlotIndex, Slot.Generation);
+    }
+
+    // Returns false if the handle was already stale.
+    bool Destroy(THandleType Handle)
+    {
+        if (!IsValid(Handle))
+        {
+            return false;
+        }
+
+        SSlot& Slot = Slots[Handle.GetIndex()];
+        const uint32 DenseIndex = Slot.DenseIndexOrNextFree;
+        const uint32 LastIndex = static_cast<uint32>(Objects.GetSize() - 1);
+
+        Objects.RemoveAtSwap(DenseIndex);
+        DenseToSlot.RemoveAtSwap(DenseIndex);
+        if (DenseIndex != LastIndex)
+        {
+            Slots[DenseToSlot[DenseIndex]].DenseIndexOrNextFree = DenseIndex;
+        }
+
+        // Skip generation zero so a reused slot never produces the null handle.
+        Slot.Generation = (Slot.Generation + 1) & THandleType::GenerationMask;
+        if (Slot.Generation == 0)
+        {
+            Slot.Generation = 1;
+        }
+        Slot.DenseIndexOrNextFree = FreeSlots;
+        Slot.bAlive = false;
+        FreeSlots = Handle.GetIndex();
+        return true;
+    }
+
+    inline bool IsValid(THandleType Handle) const
+    {
+        const uint32 SlotIndex = Handle.GetIndex();
+        return Handle.IsSet() && SlotIndex < Slots.GetSize() && Slots[SlotIndex].bAlive && Slots[SlotIndex].Generation == Handle.GetGeneration();
+    }
+
+    // Returns nullptr for stale handles. The pointer is invalidated by the next Create or Destroy.
+    inline TObject* Get(THandleType Handle)
+    {
+        return IsValid(Handle) ? &Objects[Slots[Handle.GetIndex()].DenseIndexOrNextFree] : nullptr;
+    }
+
+    inline const TObject* Get(THandleType Handle) const
+    {
+        return IsValid(Handle) ? &Objects[Slots[Handle.GetIndex()].DenseIndexOrNextFree] : nullptr;
+    }
+
+    // Handle of the object at DenseIndex, for iterating objects together with their handles.
+    inline THandleType GetHandle(size_t DenseIndex) const
+    {
+        const uint32 SlotIndex = DenseToSlot[DenseIndex];
+        return THandleType(SlotIndex, Slots[SlotIndex].Generation);
+    }
+
+    // Destroys every object. Outstanding handles become stale.
+    void Empty()
+    {
+        while (!Objects.IsEmpty())
+        {
+            Destroy(GetHandle(Objects.GetSize() - 1));
+        }
+    }
+
+    TObject* begin() { return Objects.begin(); }
+    TObject* end() { return Objects.end(); }
+
+    const TObject* begin() const { return Objects.begin(); }
+    const TObject* end() const { return Objects.end(); }
+
+    inline TArrayView<TObject> GetObjects() const
+    {
+        return TArrayView<TObject>(Objects);
+    }
+
+    inline size_t GetSize() const
+    {
+        return Objects.GetSize();
+    }
+
+    inline bool IsEmpty() const
+    {
+        return Objects.IsEmpty();
+    }
+};
@@ -1,8 +1,14 @@
 ﻿#pragma once
+#include <algorithm>
 #include <cstdlib>
+#include <new>
 #include <type_traits>
+#include <utility>
 
+#include "Core/Assert.h"
 #include "Math/MathTypes.h"
+#include "Memory/Memory.h"
+#include "Memory/Pool.h"
 
 template<typename TElement>
 struct TLinkedListNode
@@ -15,95 +21,598 @@ public:
     TLinkedListNode<TElement>* Next = nullptr;
 
 public:
-    TLinkedListNode()
-        : Next(nullptr), Previous(nullptr)
-    {
-    }
-    
-    ~TLinkedListNode()
+    TLinkedListNode() = default;
+
+    explicit TLinkedListNode(TElement&& InElement)
+        : Element(std::move(InElement))
     {
-        if constexpr (std::is_pointer_v<TElement>)
-        {
-            delete Element;
-        }
     }
 };
 
-// A double linked list
+// A double linked list. Nodes are drawn from a shared TObjectPool instead of individual heap allocations.
+// The list owns its nodes but not what pointer elements point to.
 template<typename TElement>
 class TLinkedList
 {
 private:
-    TLinkedListNode<TElement>* Head;
+    using TNode = TLinkedListNode<TElement>;
 
-    TLinkedListNode<TElement>* Tail;
+    TNode* Head;
+
+    TNode* Tail;
 
     uint32 Size;
     
 public:
+    class TIterator
+    {
+    private:
+        TNode* Node;
+
+    public:
+        explicit TIterator(TNode* InNode)
+            : Node(InNode)
+        {
+        }
+
+        TElement& operator*() const { return Node->Element; }
+        TElement* operator->() const { return &Node->Element; }
+
+        TIterator& operator++()
+        {
+            Node = Node->Next;
+            return *this;
+        }
+
+        bool operator==(const TIterator& Other) const { return Node == Other.Node; }
+        bool operator!=(const TIterator& Other) const { return Node != Other.Node; }
+
+        TNode* GetNode() const { return Node; }
+    };
+
     TLinkedList()
         : Head(nullptr), Tail(nullptr), Size(0)
     {
     }
 
+    TLinkedList(const TLinkedList&) = delete;
+    TLinkedList& operator=(const TLinkedList&) = delete;
+
     ~TLinkedList()
     {
-        TLinkedListNode<TElement>* Current = Head;
+        Empty();
+    }
+
+    // Walks from whichever end is closer.
+    TElement& operator[](uint32 Index)
+    {
+        return GetNode(Index)->Element;
+    }
+    
+    const TElement& operator[](uint32 Index) const
+    {
+        return GetNode(Index)->Element;
+    }
+
+    TIterator begin() const { return TIterator(Head); }
+    TIterator end() const { return TIterator(nullptr); }
+
+public:
+    // Appends Element. The returned node stays valid until it is removed and can be passed to RemoveNode.
+    TNode* Insert(TElement Element)
+    {
+        TNode* Node = TObjectPool<TNode>::New(std::move(Element));
+        Node->Previous = Tail;
+        if (Tail != nullptr)
+        {
+            Tail->Next = Node;
+        }
+        else
+        {
+            Head = Node;
+        }
+        Tail = Node;
+
+        ++Size;
+        return Node;
+    }
+
+    // Removes the first node holding Element. Returns false if there is none.
+    bool Remove(const TElement& Element)
+    {
+        for (TNode* Current = Head; Current != nullptr; Current = Current->Next)
+        {
+            if (Current->Element == Element)
+            {
+                RemoveNode(Current);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // O(1) removal of a node of this list.
+    void RemoveNode(TNode* Node)
+    {
+        (Node->Previous ? Node->Previous->Next : Head) = Node->Next;
+        (Node->Next ? Node->Next->Previous : Tail) = Node->Previous;
+
+        TObjectPool<TNode>::Delete(Node);
+        --Size;
+    }
+
+    void Empty()
+    {
+        TNode* Current = Head;
         while (Current != nullptr)
         {
-            TLinkedListNode<TElement>* Next = Current->Next;
-            delete Current;
+            TNode* Next = Current->Next;
+            TObjectPool<TNode>::Delete(Current);
             Current = Next;
-        }   
+        }
+
+        Head = nullptr;
+        Tail = nullptr;
+        Size = 0;
     }
 
-    TElement& operator[](uint32 Index)
+    inline uint32 GetSize() const
     {
-        uint32 Count = 0;
-        TLinkedListNode<TElement>* Current = Head;
-        while (Current != nullptr && Count < Index)
+        return Size;
+    }
+
+    inline bool IsEmpty() const
+    {
+        return Size == 0;
+    }
+
+private:
+    TNode* GetNode(uint32 Index) const
+    {
+        if (Index >= Size) throw std::out_of_range("Index is out of range.");
+
+        if (Index < Size / 2)
         {
-            TLinkedListNode<TElement>* Next = Current->Next;
-            Current = Next;
+            TNode* Current = Head;
+            for (uint32 Count = 0; Count < Index; ++Count)
+            {
+                Current = Current->Next;
+            }
+            return Current;
+        }
 
-            Count++;
+        TNode* Current = Tail;
+        for (uint32 Count = Size - 1; Count > Index; --Count)
+        {
+            Current = Current->Previous;
         }
-        return Current->Element;
+        return Current;
     }
-    
-    const TElement& operator[](uint32 Index) const
+};
+
+/*
+ * Links embedded in the owner of an intrusive list. Derive TOwner from TIntrusiveListNode<TOwner>, and from
+ * TIntrusiveListNode<TOwner, TTag> with distinct tags to be in several lists at once. Copies start unlinked.
+ */
+template<typename TOwner, typename TTag = void>
+class TIntrusiveListNode
+{
+private:
+    TIntrusiveListNode* Previous = nullptr;
+
+    TIntrusiveListNode* Next = nullptr;
+
+public:
+    TIntrusiveListNode() = default;
+
+    TIntrusiveListNode(const TIntrusiveListNode&)
     {
-        uint32 Count = 0;
-        TLinkedListNode<TElement>* Current = Head;
-        while (Current != nullptr && Count < Index)
+    }
+
+    TIntrusiveListNode& operator=(const TIntrusiveListNode&)
+    {
+        return *this;
+    }
+
+    ~TIntrusiveListNode()
+    {
+        RK_ENGINE_ASSERT(!IsLinked(), "Intrusive list node destroyed while still linked.");
+    }
+
+    inline bool IsLinked() const
+    {
+        return Next != nullptr;
+    }
+
+private:
+    template<typename, typename>
+    friend class TIntrusiveList;
+};
+
+/*
+ * Doubly linked list over nodes embedded in their owners, so linking never allocates and an owner unlinks itself
+ * in O(1) without a search. The list does not own the objects and they must be removed before destruction.
+ */
+template<typename TOwner, typename TTag = void>
+class TIntrusiveList
+{
+private:
+    using TNode = TIntrusiveListNode<TOwner, TTag>;
+
+    // Circular list through a sentinel, so link and unlink have no branches. The sentinel is never cast to TOwner.
+    TNode Sentinel;
+
+    uint32 Size = 0;
+
+public:
+    template<typename TValue>
+    class TIterator
+    {
+    private:
+        TNode* Node;
+
+    public:
+        explicit TIterator(TNode* InNode)
+            : Node(InNode)
         {
-            TLinkedListNode<TElement>* Next = Current->Next;
-            Current = Next;
+        }
+
+        TValue& operator*() const { return static_cast<TValue&>(*Node); }
+        TValue* operator->() const { return static_cast<TValue*>(Node); }
+
+        // Advancing before unlinking the current element keeps the iterator valid.
+        TIterator& operator++()
+        {
+            Node = Node->Next;
+            return *this;
+        }
+
+        bool operator==(const TIterator& Other) const { return Node == Other.Node; }
+        bool operator!=(const TIterator& Other) const { return Node != Other.Node; }
+    };
+
+    TIntrusiveList()
+    {
+        Sentinel.Previous = &Sentinel;
+        Sentinel.Next = &Sentinel;
+    }
+
+    TIntrusiveList(const TIntrusiveList&) = delete;
+    TIntrusiveList& operator=(const TIntrusiveList&) = delete;
+
+    ~TIntrusiveList()
+    {
+        Empty();
+        Sentinel.Previous = nullptr;
+        Sentinel.Next = nullptr;
+    }
+
+    TIterator<TOwner> begin() { return TIterator<TOwner>(Sentinel.Next); }
+    TIterator<TOwner> end() { return TIterator<TOwner>(&Sentinel); }
+
+    TIterator<const TOwner> begin() const { return TIterator<const TOwner>(Sentinel.Next); }
+    TIterator<const TOwner> end() const { return TIterator<const TOwner>(const_cast<TNode*>(&Sentinel)); }
+
+    void PushBack(TOwner& Owner)
+    {
+        LinkBefore(&Sentinel, Owner);
+    }
 
-            Count++;
+    void PushFront(TOwner& Owner)
+    {
+        LinkBefore(Sentinel.Next, Owner);
+    }
+
+    // O(1). Owner must be linked into this list.
+    void Remove(TOwner& Owner)
+    {
+        TNode& Node = Owner;
+        RK_ENGINE_ASSERT(Node.IsLinked(), "Removing an intrusive list node that is not linked.");
+
+        Node.Previous->Next = Node.Next;
+        Node.Next->Previous = Node.Previous;
+        Node.Previous = nullptr;
+        Node.Next = nullptr;
+        --Size;
+    }
+
+    // Unlinks every owner without touching the owners otherwise.
+    void Empty()
+    {
+        TNode* Current = Sentinel.Next;
+        while (Current != &Sentinel)
+        {
+            TNode* Next = Current->Next;
+            Current->Previous = nullptr;
+            Current->Next = nullptr;
+            Current = Next;
         }
-        return Current->Element;
+
+        Sentinel.Previous = &Sentinel;
+        Sentinel.Next = &Sentinel;
+        Size = 0;
+    }
+
+    inline TOwner* GetHead() const
+    {
+        return IsEmpty() ? nullptr : static_cast<TOwner*>(Sentinel.Next);
+    }
+
+    inline TOwner* GetTail() const
+    {
+        return IsEmpty() ? nullptr : static_cast<TOwner*>(Sentinel.Previous);
+    }
+
+    inline uint32 GetSize() const
+    {
+        return Size;
+    }
+
+    inline bool IsEmpty() const
+    {
+        return Size == 0;
     }
 
+private:
+    void LinkBefore(TNode* Position, TOwner& Owner)
+    {
+        TNode& Node = Owner;
+        RK_ENGINE_ASSERT(!Node.IsLinked(), "Intrusive list node is already linked.");
+
+        Node.Previous = Position->Previous;
+        Node.Next = Position;
+        Position->Previous->Next = &Node;
+        Position->Previous = &Node;
+        ++Size;
+    }
+};
+
+/*
+ * Unrolled linked list: chunks of ElementsPerChunk elements stored inline, so traversal touches one cache miss
+ * per chunk rather than per element. New elements are appended to the tail chunk. Removal shifts the rest of its
+ * chunk down to keep order and merges it into a neighbour once the two together are at most half full, so any two
+ * neighbours hold more than ElementsPerChunk / 2 elements. A removal therefore moves O(ElementsPerChunk) elements,
+ * churn never grows the list past 4 * Size / ElementsPerChunk + 1 chunks, and emptied chunks are released back to
+ * the chunk pool. Removing by value searches the chunks linearly.
+ */
+template<typename TElement, uint32 ElementsPerChunk = 32>
+class TChunkedList
+{
+    static_assert(ElementsPerChunk >= 16 && ElementsPerChunk <= 64, "TChunkedList chunks hold 16 to 64 elements.");
+
+private:
+    // Neighbours are merged by removals only once they fit into half a chunk, so the merged chunk has room for
+    // further removals and appends before it can take part in another merge.
+    static constexpr uint32 MergeFillLimit = ElementsPerChunk / 2;
+
+    struct SChunk
+    {
+        SChunk* Previous = nullptr;
+
+        SChunk* Next = nullptr;
+
+        uint32 Count = 0;
+
+        alignas(TElement) uint8 Storage[ElementsPerChunk * sizeof(TElement)];
+
+        inline TElement* GetElements()
+        {
+            return reinterpret_cast<TElement*>(Storage);
+        }
+    };
+
+    SChunk* Head = nullptr;
+
+    SChunk* Tail = nullptr;
+
+    size_t Size = 0;
+
+    size_t NumChunks = 0;
+
 public:
-    void Insert(TElement Element)
+    template<typename TValue>
+    class TIterator
     {
-        if (Size == 0)
+    private:
+        SChunk* Chunk;
+
+        uint32 Index;
+
+    public:
+        TIterator(SChunk* InChunk, uint32 InIndex)
+            : Chunk(InChunk), Index(InIndex)
         {
-            Head = new TLinkedListNode<TElement>();
-            Head->Element = Element;
-            Tail = Head;
         }
-        else
+
+        TValue& operator*() const { return Chunk->GetElements()[Index]; }
+        TValue* operator->() const { return Chunk->GetElements() + Index; }
+
+        TIterator& operator++()
+        {
+            if (++Index == Chunk->Count)
+            {
+                Chunk = Chunk->Next;
+                Index = 0;
+            }
+            return *this;
+        }
+
+        bool operator==(const TIterator& Other) const { return Chunk == Other.Chunk && Index == Other.Index; }
+        bool operator!=(const TIterator& Other) const { return !(*this == Other); }
+    };
+
+    TChunkedList() = default;
+
+    TChunkedList(const TChunkedList&) = delete;
+    TChunkedList& operator=(const TChunkedList&) = delete;
+
+    ~TChunkedList()
+    {
+        Empty();
+    }
+
+    TIterator<TElement> begin() { return TIterator<TElement>(Head, 0); }
+    TIterator<TElement> end() { return TIterator<TElement>(nullptr, 0); }
+
+    TIterator<const TElement> begin() const { return TIterator<const TElement>(Head, 0); }
+    TIterator<const TElement> end() const { return TIterator<const TElement>(nullptr, 0); }
+
+    template<typename... TArgs>
+    TElement& Emplace(TArgs&&... Args)
+    {
+        if (Tail == nullptr || Tail->Count == ElementsPerChunk)
         {
-            TLinkedListNode<TElement>* OldTail = Tail;
-            Tail = new TLinkedListNode<TElement>();
-            Tail->Previous = OldTail;
-            Tail->Element = Element;
-            OldTail->Next = Tail;
+            SChunk* Chunk = TObjectPool<SChunk>::New();
+            Chunk->Previous = Tail;
+            (Tail ? Tail->Next : Head) = Chunk;
+            Tail = Chunk;
+            ++NumChunks;
         }
+
+        TElement* Element = new (Tail->GetElements() + Tail->Count) TElement(std::forward<TArgs>(Args)...);
+        ++Tail->Count;
         ++Size;
+        return *Element;
+    }
+
+    void Push(const TElement& Element)
+    {
+        Emplace(Element);
+    }
+
+    void Push(TElement&& Element)
+    {
+        Emplace(std::move(Element));
+    }
+
+    // Removes the first element equal to Element. Returns false if there is none.
+    bool Remove(const TElement& Element)
+    {
+        for (SChunk* Chunk = Head; Chunk != nullptr; Chunk = Chunk->Next)
+        {
+            TElement* Elements = Chunk->GetElements();
+            TElement* Found = std::find(Elements, Elements + Chunk->Count, Element);
+            if (Found != Elements + Chunk->Count)
+            {
+                RemoveAt(Chunk, static_cast<uint32>(Found - Elements));
+                return true;
+            }
+        }
+        return false;
     }
 
-    void Remove(TElement Element);
+    // Removes every element matching Predicate in one pass. Returns the number removed.
+    template<typename TPredicate>
+    size_t RemoveIf(TPredicate Predicate)
+    {
+        const size_t OldSize = Size;
+        for (SChunk* Chunk = Head; Chunk != nullptr;)
+        {
+            SChunk* Next = Chunk->Next;
+            TElement* Elements = Chunk->GetElements();
+
+            uint32 Kept = 0;
+            for (uint32 Index = 0; Index < Chunk->Count; ++Index)
+            {
+                if (Predicate(static_cast<const TElement&>(Elements[Index])))
+                {
+                    Elements[Index].~TElement();
+                }
+                else
+                {
+                    if (Kept != Index)
+                    {
+                        RelocateElements(Elements + Kept, Elements + Index, 1);
+                    }
+                    ++Kept;
+                }
+            }
+
+            Size -= Chunk->Count - Kept;
+            Chunk->Count = Kept;
+            if (Kept == 0)
+            {
+                ReleaseChunk(Chunk);
+            }
+            Chunk = Next;
+        }
+
+        for (SChunk* Chunk = Head; Chunk != nullptr; Chunk = Chunk->Next)
+        {
+            while (Chunk->Next != nullptr && Chunk->Count + Chunk->Next->Count <= ElementsPerChunk)
+            {
+                MergeNext(Chunk);
+            }
+        }
+        return OldSize - Size;
+    }
+
+    void Empty()
+    {
+        while (Head != nullptr)
+        {
+            DestructElements(Head->GetElements(), Head->Count);
+            Head->Count = 0;
+            ReleaseChunk(Head);
+        }
+        Size = 0;
+    }
+
+    inline size_t GetSize() const
+    {
+        return Size;
+    }
+
+    inline bool IsEmpty() const
+    {
+        return Size == 0;
+    }
+
+    inline size_t GetNumChunks() const
+    {
+        return NumChunks;
+    }
+
+private:
+    void RemoveAt(SChunk* Chunk, uint32 Index)
+    {
+        TElement* Elements = Chunk->GetElements();
+        Elements[Index].~TElement();
+        for (uint32 Current = Index + 1; Current < Chunk->Count; ++Current)
+        {
+            RelocateElements(Elements + Current - 1, Elements + Current, 1);
+        }
+
+        --Size;
+        if (--Chunk->Count == 0)
+        {
+            ReleaseChunk(Chunk);
+        }
+        else if (Chunk->Previous != nullptr && Chunk->Previous->Count + Chunk->Count <= MergeFillLimit)
+        {
+            MergeNext(Chunk->Previous);
+        }
+        else if (Chunk->Next != nullptr && Chunk->Count + Chunk->Next->Count <= MergeFillLimit)
+        {
+            MergeNext(Chunk);
+        }
+    }
+
+    // Appends the elements of the next chunk to Chunk and releases the emptied next chunk.
+    void MergeNext(SChunk* Chunk)
+    {
+        SChunk* Next = Chunk->Next;
+        RelocateElements(Chunk->GetElements() + Chunk->Count, Next->GetElements(), Next->Count);
+        Chunk->Count += Next->Count;
+        Next->Count = 0;
+        ReleaseChunk(Next);
+    }
+
+    void ReleaseChunk(SChunk* Chunk)
+    {
+        (Chunk->Previous ? Chunk->Previous->Next : Head) = Chunk->Next;
+        (Chunk->Next ? Chunk->Next->Previous : Tail) = Chunk->Previous;
+        TObjectPool<SChunk>::Delete(Chunk);
+        --NumChunks;
+    }
 };
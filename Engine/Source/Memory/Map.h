@@ -0,0 +1,586 @@
+#pragma once
+
+#include <new>
+#include <utility>
+
+#include "Core/Hash.h"
+#include "Math/MathTypes.h"
+#include "Memory/Mem.h"
+#include "Memory/Memory.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define RK_HASH_TABLE_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define RK_HASH_TABLE_SSE2 0
+#endif
+
+namespace HashTableInternals
+{
+    static constexpr size_t GroupWidth = 16;
+
+    // Full slots store the low 7 bits of the hash, so an empty slot is the only state with the top bit set.
+    static constexpr int8 EmptyControl = static_cast<int8>(0x80);
+
+    inline uint32 CountTrailingZeros(uint32 Value)
+    {
+#if defined(_MSC_VER)
+        unsigned long Index;
+        _BitScanForward(&Index, Value);
+        return Index;
+#else
+        return __builtin_ctz(Value);
+#endif
+    }
+
+    /* Control bytes of GroupWidth consecutive slots, matched in parallel. Masks have one bit per slot. */
+    struct SGroup
+    {
+#if RK_HASH_TABLE_SSE2
+        __m128i Control;
+
+        explicit SGroup(const int8* InControl)
+            : Control(_mm_loadu_si128(reinterpret_cast<const __m128i*>(InControl)))
+        {
+        }
+
+        inline uint32 Match(uint8 Tag) const
+        {
+            return static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(Control, _mm_set1_epi8(static_cast<char>(Tag)))));
+        }
+
+        inline uint32 MatchEmpty() const
+        {
+            return static_cast<uint32>(_mm_movemask_epi8(Control));
+        }
+#else
+        const int8* Control;
+
+        explicit SGroup(const int8* InControl)
+            : Control(InControl)
+        {
+        }
+
+        inline uint32 Match(uint8 Tag) const
+        {
+            uint32 Mask = 0;
+            for (uint32 Index = 0; Index < GroupWidth; ++Index)
+            {
+                Mask |= static_cast<uint32>(Control[Index] == static_cast<int8>(Tag)) << Index;
+            }
+            return Mask;
+        }
+
+        inline uint32 MatchEmpty() const
+        {
+            uint32 Mask = 0;
+            for (uint32 Index = 0; Index < GroupWidth; ++Index)
+            {
+                Mask |= static_cast<uint32>(Control[Index] < 0) << Index;
+            }
+            return Mask;
+        }
+#endif
+    };
+}
+
+/*
+ * Open addressing hash table in the style of Swiss tables. Slots are probed linearly, a group of control bytes
+ * at a time, and each control byte holds 7 bits of the hash so most mismatches are rejected without touching
+ * the slot. Removal shifts the following entries back instead of leaving tombstones, so probe lengths do not
+ * degrade under churn.
+ *
+ * Pointers to elements are invalidated by any insertion or removal. TKeyFuncs::GetKey() extracts the key of an element.
+ */
+template<typename TElement, typename TKeyFuncs>
+class THashTable
+{
+private:
+    static constexpr size_t GroupWidth = HashTableInternals::GroupWidth;
+    static constexpr size_t MinCapacity = GroupWidth;
+    static constexpr size_t IndexNone = ~static_cast<size_t>(0);
+
+    // Control bytes for Capacity slots followed by a copy of the first GroupWidth - 1, so a group never wraps.
+    int8* Control = nullptr;
+
+    TElement* Slots = nullptr;
+
+    size_t Capacity = 0;
+
+    size_t Size = 0;
+
+public:
+    template<bool bConst>
+    class TIterator
+    {
+    private:
+        using TTable = std::conditional_t<bConst, const THashTable, THashTable>;
+        using TReference = std::conditional_t<bConst, const TElement&, TElement&>;
+
+        TTable* Table;
+
+        size_t Index;
+
+    public:
+        TIterator(TTable* InTable, size_t InIndex)
+            : Table(InTable), Index(InIndex)
+        {
+            SkipEmpty();
+        }
+
+        TReference operator*() const { return Table->Slots[Index]; }
+        auto* operator->() const { return &Table->Slots[Index]; }
+
+        TIterator& operator++()
+        {
+            ++Index;
+            SkipEmpty();
+            return *this;
+        }
+
+        bool operator==(const TIterator& Other) const { return Index == Other.Index; }
+        bool operator!=(const TIterator& Other) const { return Index != Other.Index; }
+
+    private:
+        void SkipEmpty()
+        {
+            while (Index < Table->Capacity && Table->Control[Index] < 0)
+            {
+                ++Index;
+            }
+        }
+    };
+
+    THashTable() = default;
+
+    THashTable(const THashTable& Other)
+    {
+        if (Other.Size == 0)
+        {
+            return;
+        }
+
+        Reserve(Other.Size);
+        for (const TElement& Element : Other)
+        {
+            new (Slots + InsertUnique(HashKey(TKeyFuncs::GetKey(Element)))) TElement(Element);
+        }
+    }
+
+    THashTable(THashTable&& Other) noexcept
+        : Control(Other.Control), Slots(Other.Slots), Capacity(Other.Capacity), Size(Other.Size)
+    {
+        Other.Control = nullptr;
+        Other.Slots = nullptr;
+        Other.Capacity = 0;
+        Other.Size = 0;
+    }
+
+    ~THashTable()
+    {
+        Empty();
+        Mem::FreeAligned(Control);
+    }
+
+    THashTable& operator=(THashTable Other) noexcept
+    {
+        std::swap(Control, Other.Control);
+        std::swap(Slots, Other.Slots);
+        std::swap(Capacity, Other.Capacity);
+        std::swap(Size, Other.Size);
+        return *this;
+    }
+
+    TIterator<false> begin() { return TIterator<false>(this, 0); }
+    TIterator<false> end() { return TIterator<false>(this, Capacity); }
+
+    TIterator<true> begin() const { return TIterator<true>(this, 0); }
+    TIterator<true> end() const { return TIterator<true>(this, Capacity); }
+
+    // Grows the table so NumElements fit without rehashing.
+    void Reserve(size_t NumElements)
+    {
+        size_t NewCapacity = MinCapacity;
+        while (NumElements > GetMaxLoad(NewCapacity))
+        {
+            NewCapacity *= 2;
+        }
+
+        if (NewCapacity > Capacity)
+        {
+            Rehash(NewCapacity);
+        }
+    }
+
+    // Destroys all elements but keeps the allocation.
+    void Empty()
+    {
+        if (Size == 0)
+        {
+            return;
+        }
+
+        for (size_t Index = 0; Index < Capacity; ++Index)
+        {
+            if (Control[Index] >= 0)
+            {
+                Slots[Index].~TElement();
+            }
+        }
+        Mem::Memset(Control, HashTableInternals::EmptyControl, Capacity + GroupWidth - 1);
+        Size = 0;
+    }
+
+    inline size_t GetSize() const
+    {
+        return Size;
+    }
+
+    inline size_t GetCapacity() const
+    {
+        return Capacity;
+    }
+
+    inline bool IsEmpty() const
+    {
+        return Size == 0;
+    }
+
+protected:
+    // TLookup may be any type that hashes like TKey and compares equal to it.
+    template<typename TLookup>
+    TElement* FindElement(const TLookup& Key) const
+    {
+        const size_t Index = FindIndex(Key);
+        return Index != IndexNone ? Slots + Index : nullptr;
+    }
+
+    /*
+     * Returns the slot for Key and whether it was inserted, in which case it holds MakeElement(). When the table has
+     * to grow, the element is made before the old slots are freed, so the arguments may refer into this table.
+     */
+    template<typename TLookup, typename TMakeElement>
+    std::pair<TElement*, bool> FindOrInsert(const TLookup& Key, TMakeElement&& MakeElement)
+    {
+        const uint64 Hash = HashKey(Key);
+        const size_t Index = FindIndex(Key, Hash);
+        if (Index != IndexNone)
+        {
+            return { Slots + Index, false };
+        }
+
+        if (Size + 1 > GetMaxLoad(Capacity))
+        {
+            TElement Element = MakeElement();
+            Rehash(Capacity == 0 ? MinCapacity : Capacity * 2);
+            TElement* Slot = Slots + InsertUnique(Hash);
+            new (Slot) TElement(std::move(Element));
+            return { Slot, true };
+        }
+
+        TElement* Slot = Slots + InsertUnique(Hash);
+        new (Slot) TElement(MakeElement());
+        return { Slot, true };
+    }
+
+    template<typename TLookup>
+    bool RemoveElement(const TLookup& Key)
+    {
+        const size_t Index = FindIndex(Key);
+        if (Index == IndexNone)
+        {
+            return false;
+        }
+
+        EraseAt(Index);
+        return true;
+    }
+
+private:
+    static inline size_t GetMaxLoad(size_t InCapacity)
+    {
+        return InCapacity - InCapacity / 8;
+    }
+
+    template<typename TLookup>
+    static inline uint64 HashKey(const TLookup& Key)
+    {
+        return Hash::Mix64(GetTypeHash(Key));
+    }
+
+    static inline size_t GetHome(uint64 Hash, size_t Mask)
+    {
+        return static_cast<size_t>(Hash >> 7) & Mask;
+    }
+
+    static inline uint8 GetTag(uint64 Hash)
+    {
+        return static_cast<uint8>(Hash & 0x7F);
+    }
+
+    template<typename TLookup>
+    inline size_t FindIndex(const TLookup& Key) const
+    {
+        return Size > 0 ? FindIndex(Key, HashKey(Key)) : IndexNone;
+    }
+
+    // Every entry sits at or after its home slot with no empty slot in between, so a group with an empty slot ends the probe.
+    template<typename TLookup>
+    size_t FindIndex(const TLookup& Key, uint64 Hash) const
+    {
+        if (Capacity == 0)
+        {
+            return IndexNone;
+        }
+
+        const size_t Mask = Capacity - 1;
+        const uint8 Tag = GetTag(Hash);
+        for (size_t Position = GetHome(Hash, Mask);; Position = (Position + GroupWidth) & Mask)
+        {
+            const HashTableInternals::SGroup Group(Control + Position);
+            for (uint32 Matches = Group.Match(Tag); Matches != 0; Matches &= Matches - 1)
+            {
+                const size_t Index = (Position + HashTableInternals::CountTrailingZeros(Matches)) & Mask;
+                if (TKeyFuncs::GetKey(Slots[Index]) == Key)
+                {
+                    return Index;
+                }
+            }
+
+            if (Group.MatchEmpty() != 0)
+            {
+                return IndexNone;
+            }
+        }
+    }
+
+    // Claims the first empty slot from the home of Hash. The key must not be present and a slot must be free.
+    size_t InsertUnique(uint64 Hash)
+    {
+        const size_t Mask = Capacity - 1;
+        for (size_t Position = GetHome(Hash, Mask);; Position = (Position + GroupWidth) & Mask)
+        {
+            const uint32 Empty = HashTableInternals::SGroup(Control + Position).MatchEmpty();
+            if (Empty != 0)
+            {
+                const size_t Index = (Position + HashTableInternals::CountTrailingZeros(Empty)) & Mask;
+                SetControl(Index, static_cast<int8>(GetTag(Hash)));
+                ++Size;
+                return Index;
+            }
+        }
+    }
+
+    // Backward shift deletion: pull later entries of the probe run into the hole until one would move before its home.
+    void EraseAt(size_t Index)
+    {
+        const size_t Mask = Capacity - 1;
+        Slots[Index].~TElement();
+
+        size_t Hole = Index;
+        for (size_t Next = (Index + 1) & Mask; Control[Next] >= 0; Next = (Next + 1) & Mask)
+        {
+            const size_t Home = GetHome(HashKey(TKeyFuncs::GetKey(Slots[Next])), Mask);
+            if (((Next - Home) & Mask) >= ((Next - Hole) & Mask))
+            {
+                RelocateElements(Slots + Hole, Slots + Next, 1);
+                SetControl(Hole, Control[Next]);
+                Hole = Next;
+            }
+        }
+
+        SetControl(Hole, HashTableInternals::EmptyControl);
+        --Size;
+    }
+
+    inline void SetControl(size_t Index, int8 Value)
+    {
+        Control[Index] = Value;
+        if (Index < GroupWidth - 1)
+        {
+            Control[Capacity + Index] = Value;
+        }
+    }
+
+    void Rehash(size_t NewCapacity)
+    {
+        int8* OldControl = Control;
+        TElement* OldSlots = Slots;
+        const size_t OldCapacity = Capacity;
+
+        const size_t SlotAlignment = alignof(TElement) > GroupWidth ? alignof(TElement) : GroupWidth;
+        const size_t ControlSize = (NewCapacity + GroupWidth - 1 + SlotAlignment - 1) & ~(SlotAlignment - 1);
+        uint8* Block = static_cast<uint8*>(Mem::MallocAligned(ControlSize + NewCapacity * sizeof(TElement), SlotAlignment));
+        if (Block == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+
+        Control = reinterpret_cast<int8*>(Block);
+        Slots = reinterpret_cast<TElement*>(Block + ControlSize);
+        Capacity = NewCapacity;
+        Size = 0;
+        Mem::Memset(Control, HashTableInternals::EmptyControl, NewCapacity + GroupWidth - 1);
+
+        for (size_t Index = 0; Index < OldCapacity; ++Index)
+        {
+            if (OldControl[Index] >= 0)
+            {
+                RelocateElements(Slots + InsertUnique(HashKey(TKeyFuncs::GetKey(OldSlots[Index]))), OldSlots + Index, 1);
+            }
+        }
+        Mem::FreeAligned(OldControl);
+    }
+};
+
+template<typename TKey, typename TValue>
+struct TMapPair
+{
+    TKey Key;
+
+    TValue Value;
+};
+
+namespace HashTableInternals
+{
+    template<typename TKey, typename TValue>
+    struct TMapKeyFuncs
+    {
+        static inline const TKey& GetKey(const TMapPair<TKey, TValue>& Pair)
+        {
+            return Pair.Key;
+        }
+    };
+
+    template<typename TKey>
+    struct TSetKeyFuncs
+    {
+        static inline const TKey& GetKey(const TKey& Key)
+        {
+            return Key;
+        }
+    };
+}
+
+/* Hash map over THashTable. Keys hash through GetTypeHash, lookups accept any type that hashes and compares like TKey. */
+template<typename TKey, typename TValue>
+class TMap : public THashTable<TMapPair<TKey, TValue>, HashTableInternals::TMapKeyFuncs<TKey, TValue>>
+{
+private:
+    using TPair = TMapPair<TKey, TValue>;
+
+public:
+    TMap() = default;
+
+    TMap(std::initializer_list<TPair> Init)
+    {
+        this->Reserve(Init.size());
+        for (const TPair& Pair : Init)
+        {
+            Add(Pair.Key, Pair.Value);
+        }
+    }
+
+    // Inserts or overwrites the value for Key.
+    template<typename TLookup, typename TArg>
+    TValue& Add(TLookup&& Key, TArg&& Value)
+    {
+        auto [Pair, bInserted] = this->FindOrInsert(Key, [&]()
+        {
+            return TPair { TKey(std::forward<TLookup>(Key)), TValue(std::forward<TArg>(Value)) };
+        });
+        if (!bInserted)
+        {
+            Pair->Value = std::forward<TArg>(Value);
+        }
+        return Pair->Value;
+    }
+
+    // Returns the value for Key, value-initializing it first if the key is new.
+    template<typename TLookup>
+    TValue& FindOrAdd(TLookup&& Key)
+    {
+        TPair* Pair = this->FindOrInsert(Key, [&]()
+        {
+            return TPair { TKey(std::forward<TLookup>(Key)), TValue() };
+        }).first;
+        return Pair->Value;
+    }
+
+    template<typename TLookup>
+    TValue& operator[](TLookup&& Key)
+    {
+        return FindOrAdd(std::forward<TLookup>(Key));
+    }
+
+    template<typename TLookup>
+    TValue* Find(const TLookup& Key)
+    {
+        TPair* Pair = this->FindElement(Key);
+        return Pair ? &Pair->Value : nullptr;
+    }
+
+    template<typename TLookup>
+    const TValue* Find(const TLookup& Key) const
+    {
+        const TPair* Pair = this->FindElement(Key);
+        return Pair ? &Pair->Value : nullptr;
+    }
+
+    template<typename TLookup>
+    bool Contains(const TLookup& Key) const
+    {
+        return this->FindElement(Key) != nullptr;
+    }
+
+    template<typename TLookup>
+    bool Remove(const TLookup& Key)
+    {
+        return this->RemoveElement(Key);
+    }
+};
+
+/* Hash set over THashTable. */
+template<typename TKey>
+class TSet : public THashTable<TKey, HashTableInternals::TSetKeyFuncs<TKey>>
+{
+public:
+    TSet() = default;
+
+    TSet(std::initializer_list<TKey> Init)
+    {
+        this->Reserve(Init.size());
+        for (const TKey& Key : Init)
+        {
+            Add(Key);
+        }
+    }
+
+    // Returns false if the key was already present.
+    template<typename TLookup>
+    bool Add(TLookup&& Key)
+    {
+        return this->FindOrInsert(Key, [&]()
+        {
+            return TKey(std::forward<TLookup>(Key));
+        }).second;
+    }
+
+    template<typename TLookup>
+    const TKey* Find(const TLookup& Key) const
+    {
+        return this->FindElement(Key);
+    }
+
+    template<typename TLookup>
+    bool Contains(const TLookup& Key) const
+    {
+        return this->FindElement(Key) != nullptr;
+    }
+
+    template<typename TLookup>
+    bool Remove(const TLookup& Key)
+    {
+        return this->RemoveElement(Key);
+    }
+};
@@ -1,61 +1,1262 @@
 ﻿#include "EnginePCH.h"
 #include "Mem.h"
 
-#include <mutex>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
 
-SMemoryMetrics GMemoryMetrics;
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <Windows.h>
+#elif __has_include(<execinfo.h>)
+    #include <execinfo.h>
+    #define RK_HAS_EXECINFO 1
+#endif
 
-SMemoryMetrics& GetMemoryMetrics()
+#include "Core/Assert.h"
+#include "Memory/AllocationRecorder.h"
+
+thread_local EMemoryTag GMemoryTag = EMemoryTag::Untagged;
+
+thread_local uint32 GAllowAllocationsDepth = 0;
+
+thread_local uint32 GPersistentAllocationsDepth = 0;
+
+namespace
 {
-    return GMemoryMetrics;
+    static constexpr size_t NumMemoryTags = static_cast<size_t>(EMemoryTag::Count);
+
+    // The allocation header packs the tag into the top byte of the size, and below it whether the block is leak tracked or persistent.
+    static constexpr uint32 TagShift = 56;
+    static constexpr uint64 LeakTrackedBit = uint64(1) << (TagShift - 1);
+    static constexpr uint64 PersistentBit = uint64(1) << (TagShift - 2);
+    static constexpr uint64 SizeMask = PersistentBit - 1;
+
+    // Persistent allocations are rare, so shared counters are cheap enough.
+    static std::atomic<uint64> GPersistentBytes[NumMemoryTags] = {};
+
+    // Tags without a budget only pay for the load of Budget, budgeted tags also share LiveBytes across threads.
+    struct STagBudget
+    {
+        std::atomic<uint64> Budget { 0 };
+
+        // Signed, allocations racing with SetMemoryBudget may be missed by the seed but still be freed.
+        std::atomic<int64> LiveBytes { 0 };
+
+        std::atomic<bool> bOverBudget { false };
+    };
+
+    static STagBudget GTagBudgets[NumMemoryTags];
+
+    struct STagCounters
+    {
+        std::atomic<uint64> Allocations { 0 };
+        std::atomic<uint64> Deallocations { 0 };
+        std::atomic<uint64> AllocatedBytes { 0 };
+        std::atomic<uint64> FreedBytes { 0 };
+    };
+
+    /*
+     * Counters owned by a single thread. The owner is the only writer, so updates are plain relaxed
+     * load/store pairs without a locked instruction. Blocks are never freed: when a thread exits its block
+     * is released for reuse by the next thread, which keeps counting on top of the previous totals.
+     */
+    struct SThreadMemoryCounters
+    {
+        STagCounters Tags[NumMemoryTags];
+
+        SThreadMemoryCounters* Next = nullptr;
+
+        std::atomic<bool> bInUse { true };
+    };
+
+    static std::atomic<SThreadMemoryCounters*> GThreadCountersHead { nullptr };
+
+    // Shared by threads that allocate after their own counters have been released on thread exit.
+    static SThreadMemoryCounters GOrphanCounters;
+
+    static thread_local SThreadMemoryCounters* GThreadCounters = nullptr;
+    static thread_local bool bThreadCountersReleased = false;
+
+    struct SThreadCountersOwner
+    {
+        bool bAcquired = false;
+
+        ~SThreadCountersOwner()
+        {
+            if (GThreadCounters != nullptr)
+            {
+                GThreadCounters->bInUse.store(false, std::memory_order_release);
+                GThreadCounters = nullptr;
+            }
+            bThreadCountersReleased = true;
+        }
+    };
+    static thread_local SThreadCountersOwner GThreadCountersOwner;
+
+    static SThreadMemoryCounters* AcquireThreadCounters()
+    {
+        for (SThreadMemoryCounters* Counters = GThreadCountersHead.load(std::memory_order_acquire); Counters != nullptr; Counters = Counters->Next)
+        {
+            bool bExpected = false;
+            if (Counters->bInUse.compare_exchange_strong(bExpected, true, std::memory_order_acquire))
+            {
+                return Counters;
+            }
+        }
+
+        // Allocated with malloc so that registering a thread never recurses into operator new.
+        void* Block = std::malloc(sizeof(SThreadMemoryCounters));
+        if (Block == nullptr)
+        {
+            return &GOrphanCounters;
+        }
+
+        SThreadMemoryCounters* Counters = new (Block) SThreadMemoryCounters();
+        Counters->Next = GThreadCountersHead.load(std::memory_order_relaxed);
+        while (!GThreadCountersHead.compare_exchange_weak(Counters->Next, Counters, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+        return Counters;
+    }
+
+    static inline void Increment(std::atomic<uint64>& Counter, uint64 Value, bool bShared)
+    {
+        if (bShared)
+        {
+            Counter.fetch_add(Value, std::memory_order_relaxed);
+        }
+        else
+        {
+            Counter.store(Counter.load(std::memory_order_relaxed) + Value, std::memory_order_relaxed);
+        }
+    }
+
+    static inline STagCounters& GetTagCounters(EMemoryTag Tag, bool& bShared)
+    {
+        SThreadMemoryCounters* Counters = GThreadCounters;
+        if (Counters == nullptr)
+        {
+            if (bThreadCountersReleased)
+            {
+                bShared = true;
+                return GOrphanCounters.Tags[static_cast<size_t>(Tag)];
+            }
+
+            Counters = GThreadCounters = AcquireThreadCounters();
+            GThreadCountersOwner.bAcquired = true;
+        }
+
+        bShared = Counters == &GOrphanCounters;
+        return Counters->Tags[static_cast<size_t>(Tag)];
+    }
+
+    static inline void TrackAllocation(EMemoryTag Tag, size_t Size)
+    {
+        bool bShared;
+        STagCounters& Counters = GetTagCounters(Tag, bShared);
+        Increment(Counters.Allocations, 1, bShared);
+        Increment(Counters.AllocatedBytes, Size, bShared);
+    }
+
+    static inline void TrackDeallocation(EMemoryTag Tag, size_t Size)
+    {
+        bool bShared;
+        STagCounters& Counters = GetTagCounters(Tag, bShared);
+        Increment(Counters.Deallocations, 1, bShared);
+        Increment(Counters.FreedBytes, Size, bShared);
+    }
+
+    // Warns from the allocation that crosses the budget. The warning's own allocations find the flag already set.
+    static void TrackBudget(STagBudget& TagBudget, EMemoryTag Tag, uint64 Budget, int64 Delta)
+    {
+        const int64 LiveBytes = TagBudget.LiveBytes.fetch_add(Delta, std::memory_order_relaxed) + Delta;
+        if (LiveBytes <= static_cast<int64>(Budget))
+        {
+            if (TagBudget.bOverBudget.load(std::memory_order_relaxed))
+            {
+                TagBudget.bOverBudget.store(false, std::memory_order_relaxed);
+            }
+        }
+        else if (Delta > 0 && !TagBudget.bOverBudget.exchange(true, std::memory_order_relaxed) && CLog::GetEngineLogger())
+        {
+            RK_ENGINE_WARNING("{} memory is over budget: {} live bytes, budget is {} bytes", Mem::GetTagName(Tag), LiveBytes, Budget);
+        }
+    }
+
+    struct SAllocationAuditState
+    {
+        EAllocationAuditMode Mode = EAllocationAuditMode::Disabled;
+
+        // Set while a call stack is captured, the unwinder may allocate on first use.
+        bool bCapturing = false;
+
+        SAllocationAuditReport Report;
+    };
+
+    // Both are trivially constructible, so neither needs a thread_local initialization guard on the allocation path.
+    static thread_local SAllocationAuditState GAllocationAudit;
+    static thread_local SAllocationAuditRecord GAllocationAuditRecords[SAllocationAuditReport::MaxRecords];
+
+    static void AuditAllocation(EMemoryTag Tag, size_t Size)
+    {
+        SAllocationAuditState& Audit = GAllocationAudit;
+        if (Audit.bCapturing)
+        {
+            return;
+        }
+
+        ++Audit.Report.NumAllocations;
+        Audit.Report.NumBytes += Size;
+        if (GAllowAllocationsDepth > 0)
+        {
+            ++Audit.Report.NumAllowedAllocations;
+            return;
+        }
+
+        if (Audit.Report.NumRecords < SAllocationAuditReport::MaxRecords)
+        {
+            SAllocationAuditRecord& Record = GAllocationAuditRecords[Audit.Report.NumRecords++];
+            Record.Size = Size;
+            Record.Tag = Tag;
+
+            Audit.bCapturing = true;
+            Record.NumFrames = Mem::CaptureCallStack(Record.Frames, SAllocationAuditRecord::MaxFrames, 1);
+            Audit.bCapturing = false;
+        }
+
+        if (Audit.Mode == EAllocationAuditMode::Assert)
+        {
+            RK_DEBUGBREAK();
+        }
+    }
+
+    /*
+     * Placed at the start of the malloc block of every allocation made while leak tracking is enabled, and linked
+     * into the global list of live tracked allocations until the block is freed.
+     */
+    struct SLiveAllocation
+    {
+        SLiveAllocation* Previous;
+        SLiveAllocation* Next;
+
+        uint64 Size;
+
+        EMemoryTag Tag;
+
+        uint32 NumFrames;
+
+        void* Frames[SLiveAllocationSite::MaxFrames];
+    };
+
+    static std::atomic<bool> GLeakTracking { false };
+
+    // A spin lock rather than a mutex, so the list can be used before static initialization and from any thread.
+    static std::atomic_flag GLiveAllocationsLock = ATOMIC_FLAG_INIT;
+    static SLiveAllocation* GLiveAllocationsHead = nullptr;
+
+    // Set while a call stack is captured, the unwinder may allocate on first use.
+    static thread_local bool bCapturingLiveAllocation = false;
+
+    static void LockLiveAllocations()
+    {
+        // Same as the recorder's buffer lock, yield so a descheduled holder can finish.
+        while (GLiveAllocationsLock.test_and_set(std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    static void UnlockLiveAllocations()
+    {
+        GLiveAllocationsLock.clear(std::memory_order_release);
+    }
+
+    static void LinkLiveAllocation(SLiveAllocation* Allocation, EMemoryTag Tag, size_t Size)
+    {
+        Allocation->Size = Size;
+        Allocation->Tag = Tag;
+        Allocation->NumFrames = 0;
+        Allocation->Previous = nullptr;
+
+        if (!bCapturingLiveAllocation)
+        {
+            // Skips this function and AllocateTracked.
+            bCapturingLiveAllocation = true;
+            Allocation->NumFrames = Mem::CaptureCallStack(Allocation->Frames, SLiveAllocationSite::MaxFrames, 2);
+            bCapturingLiveAllocation = false;
+        }
+
+        LockLiveAllocations();
+        Allocation->Next = GLiveAllocationsHead;
+        if (GLiveAllocationsHead != nullptr)
+        {
+            GLiveAllocationsHead->Previous = Allocation;
+        }
+        GLiveAllocationsHead = Allocation;
+        UnlockLiveAllocations();
+    }
+
+    static void UnlinkLiveAllocation(SLiveAllocation* Allocation)
+    {
+        LockLiveAllocations();
+        if (Allocation->Previous != nullptr)
+        {
+            Allocation->Previous->Next = Allocation->Next;
+        }
+        else
+        {
+            GLiveAllocationsHead = Allocation->Next;
+        }
+        if (Allocation->Next != nullptr)
+        {
+            Allocation->Next->Previous = Allocation->Previous;
+        }
+        UnlockLiveAllocations();
+    }
+
+    /*
+     * Placed directly in front of every user block. Its size keeps the user block at the default new alignment,
+     * and Offset locates the start of the malloc block when padding was inserted for a larger alignment. Alignment
+     * lets the free path check that a block is released by the delete matching its new.
+     */
+    struct SAllocationHeader
+    {
+        uint64 SizeAndTag;
+
+        uint32 Offset;
+
+        uint32 Alignment;
+    };
+
+    static constexpr size_t DefaultNewAlignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+    // Alignment the CRT malloc guarantees on every supported platform.
+    static constexpr size_t MallocAlignment = 2 * sizeof(void*);
+
+    static constexpr size_t HeaderSize = sizeof(SAllocationHeader);
+    static_assert(HeaderSize % DefaultNewAlignment == 0, "The allocation header must preserve the default new alignment.");
+
+    static constexpr size_t LiveAllocationSize = sizeof(SLiveAllocation);
+    static_assert(LiveAllocationSize % MallocAlignment == 0, "The leak tracking record must preserve the malloc alignment.");
+
+    static void* AllocateTracked(size_t Size, size_t Alignment)
+    {
+        if (Alignment < DefaultNewAlignment)
+        {
+            Alignment = DefaultNewAlignment;
+        }
+        RK_ENGINE_ASSERT((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two.");
+
+        // Worst-case padding needed to move a malloc-aligned address up to Alignment.
+        const size_t Padding = Alignment > MallocAlignment ? Alignment - MallocAlignment : 0;
+        const bool bPersistent = GPersistentAllocationsDepth > 0;
+        const bool bLeakTracked = !bPersistent && GLeakTracking.load(std::memory_order_relaxed);
+        const size_t Prefix = bLeakTracked ? LiveAllocationSize + HeaderSize : HeaderSize;
+        if (Size > SizeMask || Size > SIZE_MAX - Prefix - Padding)
+        {
+            return nullptr;
+        }
+
+        char* Block = static_cast<char*>(std::malloc(Prefix + Padding + Size));
+        if (!Block)
+        {
+            return nullptr;
+        }
+
+        const uintptr_t User = (reinterpret_cast<uintptr_t>(Block) + Prefix + (Alignment - 1)) & ~(static_cast<uintptr_t>(Alignment) - 1);
+        SAllocationHeader* Header = reinterpret_cast<SAllocationHeader*>(User) - 1;
+
+        const EMemoryTag Tag = GMemoryTag;
+        Header->SizeAndTag = (static_cast<uint64>(Tag) << TagShift) | (bLeakTracked ? LeakTrackedBit : 0) | (bPersistent ? PersistentBit : 0) | Size;
+        Header->Offset = static_cast<uint32>(User - reinterpret_cast<uintptr_t>(Block));
+        Header->Alignment = static_cast<uint32>(Alignment);
+        TrackAllocation(Tag, Size);
+        STagBudget& TagBudget = GTagBudgets[static_cast<size_t>(Tag)];
+        if (const uint64 Budget = TagBudget.Budget.load(std::memory_order_relaxed))
+        {
+            TrackBudget(TagBudget, Tag, Budget, static_cast<int64>(Size));
+        }
+        if (bPersistent)
+        {
+            GPersistentBytes[static_cast<size_t>(Tag)].fetch_add(Size, std::memory_order_relaxed);
+        }
+
+        if (GAllocationAudit.Mode != EAllocationAuditMode::Disabled)
+        {
+            AuditAllocation(Tag, Size);
+        }
+        if (AllocationRecorder::IsRecording())
+        {
+            AllocationRecorder::RecordAllocation(reinterpret_cast<void*>(User), Size, static_cast<uint8>(Tag));
+        }
+        if (bLeakTracked)
+        {
+            LinkLiveAllocation(reinterpret_cast<SLiveAllocation*>(Block), Tag, Size);
+        }
+
+        return reinterpret_cast<void*>(User);
+    }
+
+    // Alignment is the one the caller allocated with, zero when the caller does not know it.
+    static void FreeTracked(void* Pointer, size_t Alignment)
+    {
+        if (!Pointer)
+        {
+            return;
+        }
+
+        const SAllocationHeader* Header = static_cast<SAllocationHeader*>(Pointer) - 1;
+        RK_ENGINE_ASSERT(Alignment == 0 || Header->Alignment == std::max(Alignment, DefaultNewAlignment), "Block is freed with a different alignment than it was allocated with.");
+
+        // The deallocation is attributed to the tag of the allocation, independent of the scope it is freed in.
+        const EMemoryTag Tag = static_cast<EMemoryTag>(Header->SizeAndTag >> TagShift);
+        const size_t Size = static_cast<size_t>(Header->SizeAndTag & SizeMask);
+        TrackDeallocation(Tag, Size);
+        STagBudget& TagBudget = GTagBudgets[static_cast<size_t>(Tag)];
+        if (const uint64 Budget = TagBudget.Budget.load(std::memory_order_relaxed))
+        {
+            TrackBudget(TagBudget, Tag, Budget, -static_cast<int64>(Size));
+        }
+        if (AllocationRecorder::IsRecording())
+        {
+            AllocationRecorder::RecordFree(Pointer, Size, static_cast<uint8>(Tag));
+        }
+
+        if (Header->SizeAndTag & PersistentBit)
+        {
+            GPersistentBytes[static_cast<size_t>(Tag)].fetch_sub(Size, std::memory_order_relaxed);
+        }
+
+        char* Block = static_cast<char*>(Pointer) - Header->Offset;
+        if (Header->SizeAndTag & LeakTrackedBit)
+        {
+            UnlinkLiveAllocation(reinterpret_cast<SLiveAllocation*>(Block));
+        }
+
+        std::free(Block);
+    }
 }
 
-void* operator new(size_t size)
+SMemoryMetrics GetMemoryMetrics(SMemoryRateWindow* RateWindow)
 {
-    GMemoryMetrics.TotalHeapAllocations++;
+    using SClock = std::chrono::steady_clock;
+
+    uint64 Allocations[NumMemoryTags] = {};
+    uint64 Deallocations[NumMemoryTags] = {};
+    uint64 AllocatedBytes[NumMemoryTags] = {};
+    uint64 FreedBytes[NumMemoryTags] = {};
 
-    // Allocate extra memory to store the size
-    size_t totalSize = size + sizeof(size_t);
-    void* p = std::malloc(totalSize);
-    if (!p)
+    auto Accumulate = [&](const SThreadMemoryCounters& Counters)
     {
-        throw std::bad_alloc();
+        for (size_t Tag = 0; Tag < NumMemoryTags; ++Tag)
+        {
+            Allocations[Tag] += Counters.Tags[Tag].Allocations.load(std::memory_order_relaxed);
+            Deallocations[Tag] += Counters.Tags[Tag].Deallocations.load(std::memory_order_relaxed);
+            AllocatedBytes[Tag] += Counters.Tags[Tag].AllocatedBytes.load(std::memory_order_relaxed);
+            FreedBytes[Tag] += Counters.Tags[Tag].FreedBytes.load(std::memory_order_relaxed);
+        }
+    };
+
+    // Counter blocks are never unlinked, so the list can be walked while other threads register.
+    for (SThreadMemoryCounters* Counters = GThreadCountersHead.load(std::memory_order_acquire); Counters != nullptr; Counters = Counters->Next)
+    {
+        Accumulate(*Counters);
+    }
+    Accumulate(GOrphanCounters);
+
+    float ElapsedSeconds = 0.0f;
+    if (RateWindow != nullptr)
+    {
+        const SClock::time_point CurrentTime = SClock::now();
+        if (RateWindow->bStarted)
+        {
+            ElapsedSeconds = std::chrono::duration<float>(CurrentTime - RateWindow->PreviousTime).count();
+        }
+        RateWindow->PreviousTime = CurrentTime;
+        RateWindow->bStarted = true;
+    }
+
+    SMemoryMetrics Metrics;
+    for (size_t Tag = 0; Tag < NumMemoryTags; ++Tag)
+    {
+        STaggedMemoryMetrics& TagMetrics = Metrics.Tags[Tag];
+        TagMetrics.TotalAllocations = Allocations[Tag];
+        TagMetrics.TotalDeallocations = Deallocations[Tag];
+        TagMetrics.TotalBytesAllocated = AllocatedBytes[Tag];
+        // Blocks can be freed by another thread than the one that allocated them, so only the sum is meaningful.
+        TagMetrics.LiveBytes = AllocatedBytes[Tag] - FreedBytes[Tag];
+        TagMetrics.PersistentBytes = GPersistentBytes[Tag].load(std::memory_order_relaxed);
+
+        if (RateWindow != nullptr)
+        {
+            TagMetrics.AllocationRate = ElapsedSeconds > 0.0f ? (AllocatedBytes[Tag] - RateWindow->PreviousAllocatedBytes[Tag]) / ElapsedSeconds : 0.0f;
+            RateWindow->PreviousAllocatedBytes[Tag] = AllocatedBytes[Tag];
+        }
+
+        Metrics.TotalHeapAllocations += TagMetrics.TotalAllocations;
+        Metrics.TotalHeapDeallocations += TagMetrics.TotalDeallocations;
+        Metrics.TotalHeapBytesAllocated += TagMetrics.TotalBytesAllocated;
+        Metrics.CurrentHeapAllocation += TagMetrics.LiveBytes;
+    }
+
+    return Metrics;
+}
+
+uint32 Mem::CaptureCallStack(void** Frames, uint32 MaxFrames, uint32 SkipFrames)
+{
+    static constexpr uint32 MaxCapturedFrames = 64;
+
+    // Skips this function as well.
+    ++SkipFrames;
+    if (MaxFrames + SkipFrames > MaxCapturedFrames)
+    {
+        MaxFrames = MaxCapturedFrames > SkipFrames ? MaxCapturedFrames - SkipFrames : 0;
+    }
+
+#if defined(_WIN32)
+    return RtlCaptureStackBackTrace(SkipFrames, MaxFrames, Frames, nullptr);
+#elif defined(RK_HAS_EXECINFO)
+    void* AllFrames[MaxCapturedFrames];
+    const int32 NumCaptured = backtrace(AllFrames, static_cast<int32>(MaxFrames + SkipFrames));
+    const uint32 NumFrames = NumCaptured > static_cast<int32>(SkipFrames) ? static_cast<uint32>(NumCaptured) - SkipFrames : 0;
+    std::memcpy(Frames, AllFrames + SkipFrames, NumFrames * sizeof(void*));
+    return NumFrames;
+#else
+    return 0;
+#endif
+}
+
+void Mem::BeginAllocationAudit(EAllocationAuditMode Mode)
+{
+    GAllocationAudit.Report = SAllocationAuditReport();
+    GAllocationAudit.Report.Records = GAllocationAuditRecords;
+    GAllocationAudit.Mode = Mode;
+}
+
+SAllocationAuditReport Mem::EndAllocationAudit()
+{
+    GAllocationAudit.Mode = EAllocationAuditMode::Disabled;
+    return GAllocationAudit.Report;
+}
+
+void Mem::SetMemoryBudget(EMemoryTag Tag, size_t Budget)
+{
+    STagBudget& TagBudget = GTagBudgets[static_cast<size_t>(Tag)];
+    if (TagBudget.Budget.load(std::memory_order_relaxed) == 0 && Budget != 0)
+    {
+        const SMemoryMetrics Metrics = GetMemoryMetrics();
+        TagBudget.LiveBytes.store(static_cast<int64>(Metrics.Tags[static_cast<size_t>(Tag)].LiveBytes), std::memory_order_relaxed);
     }
+    TagBudget.bOverBudget.store(false, std::memory_order_relaxed);
+    TagBudget.Budget.store(Budget, std::memory_order_relaxed);
+}
 
-    // Store the size at the beginning of the block
-    *reinterpret_cast<size_t*>(p) = size;
-    GMemoryMetrics.CurrentHeapAllocation += size;
+size_t Mem::GetMemoryBudget(EMemoryTag Tag)
+{
+    return static_cast<size_t>(GTagBudgets[static_cast<size_t>(Tag)].Budget.load(std::memory_order_relaxed));
+}
+
+bool Mem::IsOverBudget(EMemoryTag Tag)
+{
+    return GTagBudgets[static_cast<size_t>(Tag)].bOverBudget.load(std::memory_order_relaxed);
+}
+
+void Mem::SetLeakTracking(bool bEnabled)
+{
+    GLeakTracking.store(bEnabled, std::memory_order_relaxed);
+}
 
-    // Return a pointer to the memory block after the size
-    return static_cast<char*>(p) + sizeof(size_t);
+bool Mem::IsLeakTrackingEnabled()
+{
+    return GLeakTracking.load(std::memory_order_relaxed);
 }
 
-void* operator new[](size_t size)
+uint32 Mem::GetLiveAllocationSites(SLiveAllocationSite* Sites, uint32 MaxSites)
 {
-    return ::operator new(size);
+    // Allocations made from here on would deadlock on the list lock or change it, so the copy lives outside the tracked heap.
+    LockLiveAllocations();
+    size_t NumAllocations = 0;
+    for (const SLiveAllocation* Allocation = GLiveAllocationsHead; Allocation != nullptr; Allocation = Allocation->Next)
+    {
+        ++NumAllocations;
+    }
+
+    SLiveAllocationSite* Entries = static_cast<SLiveAllocationSite*>(std::malloc(NumAllocations * sizeof(SLiveAllocationSite)));
+    if (Entries == nullptr)
+    {
+        UnlockLiveAllocations();
+        return 0;
+    }
+
+    size_t NumEntries = 0;
+    for (const SLiveAllocation* Allocation = GLiveAllocationsHead; Allocation != nullptr; Allocation = Allocation->Next)
+    {
+        SLiveAllocationSite& Entry = Entries[NumEntries++];
+        Entry.Tag = Allocation->Tag;
+        Entry.NumAllocations = 1;
+        Entry.NumBytes = Allocation->Size;
+        Entry.NumFrames = Allocation->NumFrames;
+        std::memcpy(Entry.Frames, Allocation->Frames, Allocation->NumFrames * sizeof(void*));
+    }
+    UnlockLiveAllocations();
+
+    auto IsSameSite = [](const SLiveAllocationSite& A, const SLiveAllocationSite& B)
+    {
+        return A.Tag == B.Tag && A.NumFrames == B.NumFrames && std::memcmp(A.Frames, B.Frames, A.NumFrames * sizeof(void*)) == 0;
+    };
+
+    // Sorting makes allocations of the same site adjacent so they can be merged in place.
+    std::sort(Entries, Entries + NumEntries, [](const SLiveAllocationSite& A, const SLiveAllocationSite& B)
+    {
+        if (A.Tag != B.Tag)
+        {
+            return A.Tag < B.Tag;
+        }
+        if (A.NumFrames != B.NumFrames)
+        {
+            return A.NumFrames < B.NumFrames;
+        }
+        return std::memcmp(A.Frames, B.Frames, A.NumFrames * sizeof(void*)) < 0;
+    });
+
+    size_t NumGroups = 0;
+    for (size_t Index = 0; Index < NumEntries; ++Index)
+    {
+        if (NumGroups > 0 && IsSameSite(Entries[NumGroups - 1], Entries[Index]))
+        {
+            ++Entries[NumGroups - 1].NumAllocations;
+            Entries[NumGroups - 1].NumBytes += Entries[Index].NumBytes;
+        }
+        else
+        {
+            Entries[NumGroups++] = Entries[Index];
+        }
+    }
+
+    const size_t NumSites = std::min<size_t>(NumGroups, MaxSites);
+    std::partial_sort(Entries, Entries + NumSites, Entries + NumGroups, [](const SLiveAllocationSite& A, const SLiveAllocationSite& B)
+    {
+        return A.NumBytes > B.NumBytes;
+    });
+    std::memcpy(Sites, Entries, NumSites * sizeof(SLiveAllocationSite));
+
+    std::free(Entries);
+    return static_cast<uint32>(NumGroups);
 }
 
-void operator delete(void* p)
+const char* Mem::GetTagName(EMemoryTag Tag)
 {
-    if (!p)
+    switch (Tag)
     {
+        case EMemoryTag::Untagged:  return "Untagged";
+        case EMemoryTag::Engine:    return "Engine";
+        case EMemoryTag::Platform:  return "Platform";
+        case EMemoryTag::Renderer:  return "Renderer";
+        case EMemoryTag::Scene:     return "Scene";
+        default:                    return "Unknown";
+    }
+}
+
+void* Mem::MallocAligned(size_t Size, size_t Alignment)
+{
+    return AllocateTracked(Size, Alignment);
+}
+
+void Mem::FreeAligned(void* Pointer)
+{
+    FreeTracked(Pointer, 0);
+}
+
+/*
+ * SIMD memory primitives. Kernels are resolved on first use from CPUID and cached in atomic function pointers,
+ * so later calls cost one relaxed load and an indirect call.
+ */
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define RK_MEM_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define RK_TARGET_AVX2
+    #else
+        #define RK_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#else
+    #define RK_MEM_X86 0
+#endif
+
+namespace
+{
+    using FMemcpyKernel = void (*)(void*, const void*, size_t);
+    using FMemsetKernel = void (*)(void*, uint8, size_t);
+    using FMemcmpKernel = int32 (*)(const void*, const void*, size_t);
+
+    // Below this size the non-temporal path is not worth the fence and the cache misses it causes on read back.
+    constexpr size_t StreamingThreshold = 256 * 1024;
+
+    // Sizes below one vector are handled with overlapping scalar moves.
+    inline void CopySmall(uint8* Destination, const uint8* Source, size_t Size)
+    {
+        if (Size >= 8)
+        {
+            uint64 Head, Tail;
+            std::memcpy(&Head, Source, 8);
+            std::memcpy(&Tail, Source + Size - 8, 8);
+            std::memcpy(Destination, &Head, 8);
+            std::memcpy(Destination + Size - 8, &Tail, 8);
+        }
+        else if (Size >= 4)
+        {
+            uint32 Head, Tail;
+            std::memcpy(&Head, Source, 4);
+            std::memcpy(&Tail, Source + Size - 4, 4);
+            std::memcpy(Destination, &Head, 4);
+            std::memcpy(Destination + Size - 4, &Tail, 4);
+        }
+        else
+        {
+            for (size_t Index = 0; Index < Size; ++Index)
+            {
+                Destination[Index] = Source[Index];
+            }
+        }
+    }
+
+    inline void SetSmall(uint8* Destination, uint8 Value, size_t Size)
+    {
+        if (Size >= 8)
+        {
+            const uint64 Pattern = 0x0101010101010101ull * Value;
+            std::memcpy(Destination, &Pattern, 8);
+            std::memcpy(Destination + Size - 8, &Pattern, 8);
+        }
+        else
+        {
+            for (size_t Index = 0; Index < Size; ++Index)
+            {
+                Destination[Index] = Value;
+            }
+        }
+    }
+
+    inline int32 CompareBytes(const uint8* A, const uint8* B, size_t Size)
+    {
+        for (size_t Index = 0; Index < Size; ++Index)
+        {
+            if (A[Index] != B[Index])
+            {
+                return static_cast<int32>(A[Index]) - static_cast<int32>(B[Index]);
+            }
+        }
+        return 0;
+    }
+
+#if !RK_MEM_X86
+    void MemcpyScalar(void* Destination, const void* Source, size_t Size)
+    {
+        std::memcpy(Destination, Source, Size);
+    }
+
+    void MemsetScalar(void* Destination, uint8 Value, size_t Size)
+    {
+        std::memset(Destination, Value, Size);
+    }
+
+    int32 MemcmpScalar(const void* A, const void* B, size_t Size)
+    {
+        return std::memcmp(A, B, Size);
+    }
+#else
+    inline uint32 CountTrailingZeros(uint32 Value)
+    {
+#if defined(_MSC_VER)
+        unsigned long Index;
+        _BitScanForward(&Index, Value);
+        return Index;
+#else
+        return __builtin_ctz(Value);
+#endif
+    }
+
+    /*
+     * Vector kernels share one shape: an unaligned head and tail, which may overlap the body, around a loop
+     * of stores aligned to the destination.
+     */
+    void MemcpySSE2(void* Destination, const void* Source, size_t Size)
+    {
+        uint8* Out = static_cast<uint8*>(Destination);
+        const uint8* In = static_cast<const uint8*>(Source);
+        if (Size < 16)
+        {
+            CopySmall(Out, In, Size);
+            return;
+        }
+
+        const __m128i Head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(In));
+        const __m128i Tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(In + Size - 16));
+
+        size_t Offset = 16 - (reinterpret_cast<uintptr_t>(Out) & 15);
+        for (; Offset + 64 <= Size; Offset += 64)
+        {
+            const __m128i V0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(In + Offset));
+            const __m128i V1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(In + Offset + 16));
+            const __m128i V2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(In + Offset + 32));
+            const __m128i V3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(In + Offset + 48));
+            _mm_store_si128(reinterpret_cast<__m128i*>(Out + Offset), V0);
+            _mm_store_si128(reinterpret_cast<__m128i*>(Out + Offset + 16), V1);
+            _mm_store_si128(reinterpret_cast<__m128i*>(Out + Offset + 32), V2);
+            _mm_store_si128(reinterpret_cast<__m128i*>(Out + Offset + 48), V3);
+        }
+        for (; Offset + 16 <= Size; Offset += 16)
+        {
+            _mm_store_si128(reinterpret_cast<__m128i*>(Out + Offset), _mm_loadu_si128(reinterpret_cast<const __m128i*>(In + Offset)));
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(Out), Head);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(Out + Size - 16), Tail);
+    }
+
+    RK_TARGET_AVX2 void MemcpyAVX2(void* Destination, const void* Source, size_t Size)
+    {
+        uint8* Out = static_cast<uint8*>(Destination);
+        const uint8* In = static_cast<const uint8*>(Source);
+        if (Size < 32)
+        {
+            MemcpySSE2(Destination, Source, Size);
+            return;
+        }
+
+        const __m256i Head = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(In));
+        const __m256i Tail = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(In + Size - 32));
+
+        size_t Offset = 32 - (reinterpret_cast<uintptr_t>(Out) & 31);
+        for (; Offset + 128 <= Size; Offset += 128)
+        {
+            const __m256i V0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(In + Offset));
+            const __m256i V1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(In + Offset + 32));
+            const __m256i V2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(In + Offset + 64));
+            const __m256i V3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(In + Offset + 96));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(Out + Offset), V0);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(Out + Offset + 32), V1);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(Out + Offset + 64), V2);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(Out + Offset + 96), V3);
+        }
+        for (; Offset + 32 <= Size; Offset += 32)
+        {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(Out + Offset), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(In + Offset)));
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(Out), Head);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(Out + Size - 32), Tail);
+    }
+
+    void MemsetSSE2(void* Destination, uint8 Value, size_t Size)
+    {
+        uint8* Out = static_cast<uint8*>(Destination);
+        if (Size < 16)
+        {
+            SetSmall(Out, Value, Size);
+            return;
+        }
+
+        const __m128i Pattern = _mm_set1_epi8(static_cast<char>(Value));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(Out), Pattern);
+
+        size_t Offset = 16 - (reinterpret_cast<uintptr_t>(Out) & 15);
+        for (; Offset + 64 <= Size; Offset += 64)
+        {
+            _mm_store_si128(reinterpret_cast<__m128i*>(Out + Offset), Pattern);
+            _mm_store_si128(reinterpret_cast<__m128i*>(Out + Offset + 16), Pattern);
+            _mm_store_si128(reinterpret_cast<__m128i*>(Out + Offset + 32), Pattern);
+            _mm_store_si128(reinterpret_cast<__m128i*>(Out + Offset + 48), Pattern);
+        }
+        for (; Offset + 16 <= Size; Offset += 16)
+        {
+            _mm_store_si128(reinterpret_cast<__m128i*>(Out + Offset), Pattern);
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(Out + Size - 16), Pattern);
+    }
+
+    RK_TARGET_AVX2 void MemsetAVX2(void* Destination, uint8 Value, size_t Size)
+    {
+        uint8* Out = static_cast<uint8*>(Destination);
+        if (Size < 32)
+        {
+            MemsetSSE2(Destination, Value, Size);
+            return;
+        }
+
+        const __m256i Pattern = _mm256_set1_epi8(static_cast<char>(Value));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(Out), Pattern);
+
+        size_t Offset = 32 - (reinterpret_cast<uintptr_t>(Out) & 31);
+        for (; Offset + 128 <= Size; Offset += 128)
+        {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(Out + Offset), Pattern);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(Out + Offset + 32), Pattern);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(Out + Offset + 64), Pattern);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(Out + Offset + 96), Pattern);
+        }
+        for (; Offset + 32 <= Size; Offset += 32)
+        {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(Out + Offset), Pattern);
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(Out + Size - 32), Pattern);
+    }
+
+    int32 MemcmpSSE2(const void* A, const void* B, size_t Size)
+    {
+        const uint8* Left = static_cast<const uint8*>(A);
+        const uint8* Right = static_cast<const uint8*>(B);
+
+        size_t Offset = 0;
+        for (; Offset + 16 <= Size; Offset += 16)
+        {
+            const __m128i L = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Left + Offset));
+            const __m128i R = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Right + Offset));
+            const uint32 Mask = static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(L, R))) ^ 0xFFFFu;
+            if (Mask != 0)
+            {
+                const size_t Index = Offset + CountTrailingZeros(Mask);
+                return static_cast<int32>(Left[Index]) - static_cast<int32>(Right[Index]);
+            }
+        }
+        return CompareBytes(Left + Offset, Right + Offset, Size - Offset);
+    }
+
+    RK_TARGET_AVX2 int32 MemcmpAVX2(const void* A, const void* B, size_t Size)
+    {
+        const uint8* Left = static_cast<const uint8*>(A);
+        const uint8* Right = static_cast<const uint8*>(B);
+
+        size_t Offset = 0;
+        for (; Offset + 32 <= Size; Offset += 32)
+        {
+            const __m256i L = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Left + Offset));
+            const __m256i R = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Right + Offset));
+            const uint32 Mask = ~static_cast<uint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(L, R)));
+            if (Mask != 0)
+            {
+                const size_t Index = Offset + CountTrailingZeros(Mask);
+                return static_cast<int32>(Left[Index]) - static_cast<int32>(Right[Index]);
+            }
+        }
+        return MemcmpSSE2(Left + Offset, Right + Offset, Size - Offset);
+    }
+
+    // Non-temporal stores need an aligned destination, so the unaligned head goes through the regular path.
+    void MemcpyStreamingSSE2(void* Destination, const void* Source, size_t Size)
+    {
+        uint8* Out = static_cast<uint8*>(Destination);
+        const uint8* In = static_cast<const uint8*>(Source);
+
+        const size_t HeadSize = (16 - (reinterpret_cast<uintptr_t>(Out) & 15)) & 15;
+        MemcpySSE2(Out, In, HeadSize);
+
+        size_t Offset = HeadSize;
+        for (; Offset + 64 <= Size; Offset += 64)
+        {
+            const __m128i V0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(In + Offset));
+            const __m128i V1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(In + Offset + 16));
+            const __m128i V2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(In + Offset + 32));
+            const __m128i V3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(In + Offset + 48));
+            _mm_stream_si128(reinterpret_cast<__m128i*>(Out + Offset), V0);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(Out + Offset + 16), V1);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(Out + Offset + 32), V2);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(Out + Offset + 48), V3);
+        }
+        _mm_sfence();
+
+        MemcpySSE2(Out + Offset, In + Offset, Size - Offset);
+    }
+
+    RK_TARGET_AVX2 void MemcpyStreamingAVX2(void* Destination, const void* Source, size_t Size)
+    {
+        uint8* Out = static_cast<uint8*>(Destination);
+        const uint8* In = static_cast<const uint8*>(Source);
+
+        const size_t HeadSize = (32 - (reinterpret_cast<uintptr_t>(Out) & 31)) & 31;
+        MemcpyAVX2(Out, In, HeadSize);
+
+        size_t Offset = HeadSize;
+        for (; Offset + 128 <= Size; Offset += 128)
+        {
+            const __m256i V0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(In + Offset));
+            const __m256i V1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(In + Offset + 32));
+            const __m256i V2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(In + Offset + 64));
+            const __m256i V3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(In + Offset + 96));
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(Out + Offset), V0);
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(Out + Offset + 32), V1);
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(Out + Offset + 64), V2);
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(Out + Offset + 96), V3);
+        }
+        _mm_sfence();
+
+        MemcpyAVX2(Out + Offset, In + Offset, Size - Offset);
+    }
+
+    bool SupportsAVX2()
+    {
+#if defined(_MSC_VER)
+        int32 Info[4];
+        __cpuid(Info, 1);
+        const bool bOSXSave = (Info[2] & (1 << 27)) != 0;
+        const bool bAVX = (Info[2] & (1 << 28)) != 0;
+        if (!bOSXSave || !bAVX || (_xgetbv(0) & 0x6) != 0x6)
+        {
+            return false;
+        }
+        __cpuidex(Info, 7, 0);
+        return (Info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+
+    struct SMemoryKernels
+    {
+        FMemcpyKernel Memcpy;
+        FMemsetKernel Memset;
+        FMemcmpKernel Memcmp;
+        FMemcpyKernel MemcpyStreaming;
+        const char* Name;
+    };
+
+    SMemoryKernels SelectKernels()
+    {
+#if RK_MEM_X86
+        if (SupportsAVX2())
+        {
+            return { MemcpyAVX2, MemsetAVX2, MemcmpAVX2, MemcpyStreamingAVX2, "AVX2" };
+        }
+        // SSE2 is part of the x86-64 baseline.
+        return { MemcpySSE2, MemsetSSE2, MemcmpSSE2, MemcpyStreamingSSE2, "SSE2" };
+#else
+        return { MemcpyScalar, MemsetScalar, MemcmpScalar, MemcpyScalar, "Scalar" };
+#endif
+    }
+
+    void ResolveMemcpy(void* Destination, const void* Source, size_t Size);
+    void ResolveMemset(void* Destination, uint8 Value, size_t Size);
+    int32 ResolveMemcmp(const void* A, const void* B, size_t Size);
+    void ResolveMemcpyStreaming(void* Destination, const void* Source, size_t Size);
+
+    // Constant-initialized to the resolvers, so the primitives are usable before static constructors have run.
+    std::atomic<FMemcpyKernel> GMemcpy { ResolveMemcpy };
+    std::atomic<FMemsetKernel> GMemset { ResolveMemset };
+    std::atomic<FMemcmpKernel> GMemcmp { ResolveMemcmp };
+    std::atomic<FMemcpyKernel> GMemcpyStreaming { ResolveMemcpyStreaming };
+    std::atomic<const char*> GKernelName { nullptr };
+
+    // Selection is deterministic, so threads racing through here store the same pointers.
+    void ResolveKernels()
+    {
+        const SMemoryKernels Kernels = SelectKernels();
+        GMemcpy.store(Kernels.Memcpy, std::memory_order_relaxed);
+        GMemset.store(Kernels.Memset, std::memory_order_relaxed);
+        GMemcmp.store(Kernels.Memcmp, std::memory_order_relaxed);
+        GMemcpyStreaming.store(Kernels.MemcpyStreaming, std::memory_order_relaxed);
+        GKernelName.store(Kernels.Name, std::memory_order_relaxed);
+    }
+
+    void ResolveMemcpy(void* Destination, const void* Source, size_t Size)
+    {
+        ResolveKernels();
+        GMemcpy.load(std::memory_order_relaxed)(Destination, Source, Size);
+    }
+
+    void ResolveMemset(void* Destination, uint8 Value, size_t Size)
+    {
+        ResolveKernels();
+        GMemset.load(std::memory_order_relaxed)(Destination, Value, Size);
+    }
+
+    int32 ResolveMemcmp(const void* A, const void* B, size_t Size)
+    {
+        ResolveKernels();
+        return GMemcmp.load(std::memory_order_relaxed)(A, B, Size);
+    }
+
+    void ResolveMemcpyStreaming(void* Destination, const void* Source, size_t Size)
+    {
+        ResolveKernels();
+        GMemcpyStreaming.load(std::memory_order_relaxed)(Destination, Source, Size);
+    }
+}
+
+void* Mem::Memcpy(void* Destination, const void* Source, size_t Size)
+{
+    GMemcpy.load(std::memory_order_relaxed)(Destination, Source, Size);
+    return Destination;
+}
+
+void* Mem::Memmove(void* Destination, const void* Source, size_t Size)
+{
+    const uintptr_t Out = reinterpret_cast<uintptr_t>(Destination);
+    const uintptr_t In = reinterpret_cast<uintptr_t>(Source);
+
+    // Overlapping moves are rare, so only disjoint ranges take the vector path.
+    if (Out - In >= Size && In - Out >= Size)
+    {
+        GMemcpy.load(std::memory_order_relaxed)(Destination, Source, Size);
+        return Destination;
+    }
+    return std::memmove(Destination, Source, Size);
+}
+
+void Mem::Memset(void* Pointer, int32 Value, size_t Size)
+{
+    GMemset.load(std::memory_order_relaxed)(Pointer, static_cast<uint8>(Value), Size);
+}
+
+void Mem::MemZero(void* Pointer, size_t Size)
+{
+    GMemset.load(std::memory_order_relaxed)(Pointer, 0, Size);
+}
+
+int32 Mem::Memcmp(const void* A, const void* B, size_t Size)
+{
+    const int32 Result = GMemcmp.load(std::memory_order_relaxed)(A, B, Size);
+    return (Result > 0) - (Result < 0);
+}
+
+void Mem::MemcpyStreaming(void* Destination, const void* Source, size_t Size)
+{
+    if (Size < StreamingThreshold)
+    {
+        GMemcpy.load(std::memory_order_relaxed)(Destination, Source, Size);
         return;
     }
+    GMemcpyStreaming.load(std::memory_order_relaxed)(Destination, Source, Size);
+}
+
+const char* Mem::GetKernelName()
+{
+    if (GKernelName.load(std::memory_order_relaxed) == nullptr)
+    {
+        ResolveKernels();
+    }
+    return GKernelName.load(std::memory_order_relaxed);
+}
+
+void* operator new(size_t Size)
+{
+    void* Pointer = AllocateTracked(Size, DefaultNewAlignment);
+    if (!Pointer)
+    {
+        throw std::bad_alloc();
+    }
+    return Pointer;
+}
+
+void* operator new[](size_t Size)
+{
+    return ::operator new(Size);
+}
+
+void* operator new(size_t Size, std::align_val_t Alignment)
+{
+    void* Pointer = AllocateTracked(Size, static_cast<size_t>(Alignment));
+    if (!Pointer)
+    {
+        throw std::bad_alloc();
+    }
+    return Pointer;
+}
+
+void* operator new[](size_t Size, std::align_val_t Alignment)
+{
+    return ::operator new(Size, Alignment);
+}
+
+void* operator new(size_t Size, const std::nothrow_t&) noexcept
+{
+    return AllocateTracked(Size, DefaultNewAlignment);
+}
+
+void* operator new[](size_t Size, const std::nothrow_t&) noexcept
+{
+    return AllocateTracked(Size, DefaultNewAlignment);
+}
+
+void* operator new(size_t Size, std::align_val_t Alignment, const std::nothrow_t&) noexcept
+{
+    return AllocateTracked(Size, static_cast<size_t>(Alignment));
+}
+
+void* operator new[](size_t Size, std::align_val_t Alignment, const std::nothrow_t&) noexcept
+{
+    return AllocateTracked(Size, static_cast<size_t>(Alignment));
+}
+
+// Every block carries its own header, so the sized and aligned forms all share the same release path.
+
+void operator delete(void* Pointer) noexcept
+{
+    FreeTracked(Pointer, DefaultNewAlignment);
+}
+
+void operator delete[](void* Pointer) noexcept
+{
+    FreeTracked(Pointer, DefaultNewAlignment);
+}
+
+void operator delete(void* Pointer, size_t) noexcept
+{
+    FreeTracked(Pointer, DefaultNewAlignment);
+}
+
+void operator delete[](void* Pointer, size_t) noexcept
+{
+    FreeTracked(Pointer, DefaultNewAlignment);
+}
+
+void operator delete(void* Pointer, std::align_val_t Alignment) noexcept
+{
+    FreeTracked(Pointer, static_cast<size_t>(Alignment));
+}
+
+void operator delete[](void* Pointer, std::align_val_t Alignment) noexcept
+{
+    FreeTracked(Pointer, static_cast<size_t>(Alignment));
+}
 
-    // Adjust the pointer to get the original allocated block
-    char* block = static_cast<char*>(p) - sizeof(size_t);
+void operator delete(void* Pointer, size_t, std::align_val_t Alignment) noexcept
+{
+    FreeTracked(Pointer, static_cast<size_t>(Alignment));
+}
 
-    // Retrieve the size from the beginning of the block
-    size_t size = *reinterpret_cast<size_t*>(block);
+void operator delete[](void* Pointer, size_t, std::align_val_t Alignment) noexcept
+{
+    FreeTracked(Pointer, static_cast<size_t>(Alignment));
+}
 
-    GMemoryMetrics.CurrentHeapAllocation -= size;
-    GMemoryMetrics.TotalHeapDeallocations++;
+void operator delete(void* Pointer, const std::nothrow_t&) noexcept
+{
+    FreeTracked(Pointer, DefaultNewAlignment);
+}
 
-    // Free the original allocated block
-    std::free(block);
+void operator delete[](void* Pointer, const std::nothrow_t&) noexcept
+{
+    FreeTracked(Pointer, DefaultNewAlignment);
 }
 
-void operator delete[](void* p) noexcept
+void operator delete(void* Pointer, std::align_val_t Alignment, const std::nothrow_t&) noexcept
 {
-    ::operator delete(p);
-}
\ No newline at end of file
+    FreeTracked(Pointer, static_cast<size_t>(Alignment));
+}
+
+void operator delete[](void* Pointer, std::align_val_t Alignment, const std::nothrow_t&) noexcept
+{
+    FreeTracked(Pointer, static_cast<size_t>(Alignment));
+}
@@ -1,25 +1,207 @@
 ﻿#pragma once
 
 #include <assert.h>
+#include <chrono>
 #include <cstdlib> // For std::malloc and std::free
 #include <mutex>
+#include <new>
 #include <type_traits>
 
 #include "Math/MathTypes.h"
 
+static constexpr size_t CACHE_LINE_SIZE = 64;
+
+/* Subsystem an allocation is attributed to. Set for the current thread with RK_MEMORY_SCOPE. */
+enum class EMemoryTag : uint8
+{
+    Untagged = 0,
+    Engine,
+    Platform,
+    Renderer,
+    Scene,
+    Count
+};
+
+struct STaggedMemoryMetrics
+{
+    size_t TotalAllocations = 0;
+    size_t TotalDeallocations = 0;
+    size_t TotalBytesAllocated = 0;
+    size_t LiveBytes = 0;
+
+    // Part of LiveBytes allocated within a persistent allocation scope, expected to live until the process exits.
+    size_t PersistentBytes = 0;
+
+    // Bytes allocated per second since the previous snapshot taken with the same rate window, zero without one.
+    float AllocationRate = 0.0f;
+};
+
 struct SMemoryMetrics
 {
     size_t TotalHeapAllocations = 0;
     size_t TotalHeapDeallocations = 0;
+    size_t TotalHeapBytesAllocated = 0;
     size_t CurrentHeapAllocation = 0;
+
+    STaggedMemoryMetrics Tags[static_cast<size_t>(EMemoryTag::Count)];
+};
+
+/* Allocation rate state owned by one caller of GetMemoryMetrics, so callers sampling at different intervals do not skew each other's rates. */
+struct SMemoryRateWindow
+{
+    std::chrono::steady_clock::time_point PreviousTime;
+
+    uint64 PreviousAllocatedBytes[static_cast<size_t>(EMemoryTag::Count)] = {};
+
+    bool bStarted = false;
+};
+
+/* Snapshot of the heap counters, aggregated from the per-thread counters. Rates are only filled in with a RateWindow. */
+SMemoryMetrics GetMemoryMetrics(SMemoryRateWindow* RateWindow = nullptr);
+
+extern thread_local EMemoryTag GMemoryTag;
+
+/* Attributes every heap allocation made by this thread to a tag for the lifetime of the scope. */
+struct SMemoryScope
+{
+    SMemoryScope(EMemoryTag Tag)
+        : PreviousTag(GMemoryTag)
+    {
+        GMemoryTag = Tag;
+    }
+
+    ~SMemoryScope()
+    {
+        GMemoryTag = PreviousTag;
+    }
+
+    SMemoryScope(const SMemoryScope&) = delete;
+    SMemoryScope& operator=(const SMemoryScope&) = delete;
+
+private:
+    EMemoryTag PreviousTag;
+};
+
+#define RK_MEMORY_SCOPE(Tag) SMemoryScope MemoryScope(EMemoryTag::Tag)
+
+/*
+ * Zero-allocation audit. While armed, every heap allocation made by the arming thread is counted, and those outside
+ * an allow scope are recorded with their call stack, or break into the debugger in Assert mode. Records live in a
+ * fixed per-thread buffer, so the audit itself never allocates.
+ */
+enum class EAllocationAuditMode : uint8
+{
+    Disabled,
+    Record,
+    Assert
+};
+
+struct SAllocationAuditRecord
+{
+    static constexpr uint32 MaxFrames = 16;
+
+    size_t Size;
+
+    EMemoryTag Tag;
+
+    uint32 NumFrames;
+
+    void* Frames[MaxFrames];
+};
+
+struct SAllocationAuditReport
+{
+    uint32 NumAllocations = 0;
+    uint32 NumAllowedAllocations = 0;
+    size_t NumBytes = 0;
+
+    // First MaxRecords disallowed allocations, valid until the thread arms the audit again.
+    static constexpr uint32 MaxRecords = 32;
+    const SAllocationAuditRecord* Records = nullptr;
+    uint32 NumRecords = 0;
+};
+
+extern thread_local uint32 GAllowAllocationsDepth;
+
+/* Marks allocations made by this thread within the scope as known and acceptable to the allocation audit. */
+struct SAllowAllocationsScope
+{
+    SAllowAllocationsScope()
+    {
+        ++GAllowAllocationsDepth;
+    }
+
+    ~SAllowAllocationsScope()
+    {
+        --GAllowAllocationsDepth;
+    }
+
+    SAllowAllocationsScope(const SAllowAllocationsScope&) = delete;
+    SAllowAllocationsScope& operator=(const SAllowAllocationsScope&) = delete;
+};
+
+#define RK_ALLOW_ALLOCATIONS() SAllowAllocationsScope AllowAllocations
+
+extern thread_local uint32 GPersistentAllocationsDepth;
+
+/*
+ * Marks heap allocations made by this thread within the scope as living until the process exits, such as the slabs
+ * of process-wide pools. They are left out of leak tracking and counted as PersistentBytes of their tag.
+ */
+struct SPersistentAllocationsScope
+{
+    SPersistentAllocationsScope()
+    {
+        ++GPersistentAllocationsDepth;
+    }
+
+    ~SPersistentAllocationsScope()
+    {
+        --GPersistentAllocationsDepth;
+    }
+
+    SPersistentAllocationsScope(const SPersistentAllocationsScope&) = delete;
+    SPersistentAllocationsScope& operator=(const SPersistentAllocationsScope&) = delete;
 };
-extern SMemoryMetrics GMemoryMetrics;
-SMemoryMetrics& GetMemoryMetrics();
 
-void* operator new(size_t size) noexcept(false);
-void* operator new[](size_t size) noexcept(false);
-void operator delete(void* p) noexcept;
-void operator delete[](void* p) noexcept;
+#define RK_PERSISTENT_ALLOCATIONS() SPersistentAllocationsScope PersistentAllocations
+
+/*
+ * Leak tracking. While enabled, every new heap allocation is linked into a global list together with its call
+ * stack until it is freed, so allocations still live at shutdown can be reported by call site. This costs a
+ * stack capture and a lock per allocation and is meant for automated runs rather than shipping builds.
+ */
+struct SLiveAllocationSite
+{
+    static constexpr uint32 MaxFrames = 12;
+
+    EMemoryTag Tag;
+
+    uint32 NumAllocations;
+
+    size_t NumBytes;
+
+    uint32 NumFrames;
+
+    void* Frames[MaxFrames];
+};
+
+/*
+ * The global allocator is replaced to track every heap allocation. All forms honour the requested alignment,
+ * and blocks from plain new are aligned to __STDCPP_DEFAULT_NEW_ALIGNMENT__.
+ */
+void* operator new(size_t Size) noexcept(false);
+void* operator new[](size_t Size) noexcept(false);
+void* operator new(size_t Size, std::align_val_t Alignment) noexcept(false);
+void* operator new[](size_t Size, std::align_val_t Alignment) noexcept(false);
+void operator delete(void* Pointer) noexcept;
+void operator delete[](void* Pointer) noexcept;
+void operator delete(void* Pointer, size_t Size) noexcept;
+void operator delete[](void* Pointer, size_t Size) noexcept;
+void operator delete(void* Pointer, std::align_val_t Alignment) noexcept;
+void operator delete[](void* Pointer, std::align_val_t Alignment) noexcept;
+void operator delete(void* Pointer, size_t Size, std::align_val_t Alignment) noexcept;
+void operator delete[](void* Pointer, size_t Size, std::align_val_t Alignment) noexcept;
 
 template<typename TClassTo>
 static inline TClassTo* Cast(void* Pointer)
@@ -36,7 +218,12 @@ static inline TClassTo* Cast(void* Pointer)
 
 namespace Mem
 {
-    
+    const char* GetTagName(EMemoryTag Tag);
+
+    /* Tracked allocation aligned to Alignment, which must be a power of two. Release with FreeAligned. */
+    void* MallocAligned(size_t Size, size_t Alignment);
+    void FreeAligned(void* Pointer);
+
     template<typename TObject>
     static TObject* Malloc(size_t Count = 1)
     {
@@ -59,14 +246,54 @@ namespace Mem
         return Cast<TObject>(Block);
     }
 
-    /* Trivial for character arrays or initialize memory to zero state */
-    static void Memset(void* Pointer, int32 Value, size_t Size)
-    {
-        unsigned char* Block = Cast<unsigned char>(Pointer);
+    /*
+     * Memory primitives backed by SSE2/AVX2 kernels, selected from CPUID on first use. Memcmp returns -1, 0 or 1.
+     * Memmove takes the vector path only when the ranges are disjoint.
+     */
+    void* Memcpy(void* Destination, const void* Source, size_t Size);
+    void* Memmove(void* Destination, const void* Source, size_t Size);
+    void Memset(void* Pointer, int32 Value, size_t Size);
+    void MemZero(void* Pointer, size_t Size);
+    int32 Memcmp(const void* A, const void* B, size_t Size);
 
-        for (size_t Index = 0; Index < Size; ++Index)
-        {
-            Block[Index] = Value;
-        }
+    /* Copy with non-temporal stores that bypass the cache, for large write-once destinations such as mapped upload buffers. */
+    void MemcpyStreaming(void* Destination, const void* Source, size_t Size);
+
+    /* Instruction set of the selected kernels, e.g. "AVX2". */
+    const char* GetKernelName();
+
+    /* Return addresses of the calling thread's stack, innermost first, skipping SkipFrames callers. Never uses operator new. */
+    uint32 CaptureCallStack(void** Frames, uint32 MaxFrames, uint32 SkipFrames = 0);
+
+    /* Arms the allocation audit on the calling thread. Nested arming is not supported. */
+    void BeginAllocationAudit(EAllocationAuditMode Mode);
+
+    /* Disarms the audit on the calling thread and returns what it observed since BeginAllocationAudit. */
+    SAllocationAuditReport EndAllocationAudit();
+
+    /*
+     * Live heap bytes allowed for Tag, zero for no limit. The allocation that takes the tag over its budget logs a
+     * warning, once per crossing. While a budget is set, the tag's live bytes are also kept in a shared counter,
+     * which is seeded from the per-thread counters when the budget is set.
+     */
+    void SetMemoryBudget(EMemoryTag Tag, size_t Budget);
+    size_t GetMemoryBudget(EMemoryTag Tag);
+    bool IsOverBudget(EMemoryTag Tag);
+
+    /* Allocations made while leak tracking is enabled are tracked until freed, even after it is disabled again. */
+    void SetLeakTracking(bool bEnabled);
+    bool IsLeakTrackingEnabled();
+
+    /*
+     * Groups the tracked allocations that are still live by tag and call stack. Writes the MaxSites groups with the
+     * most bytes to Sites, largest first, and returns the total number of groups.
+     */
+    uint32 GetLiveAllocationSites(SLiveAllocationSite* Sites, uint32 MaxSites);
+
+    template<typename TObject>
+    inline void MemZero(TObject& Object)
+    {
+        static_assert(std::is_trivially_copyable_v<TObject>, "MemZero requires a trivially copyable type.");
+        MemZero(&Object, sizeof(TObject));
     }
 }
@@ -1,11 +1,19 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <assert.h>
+#include <cstddef>
+#include <cstring>
+#include <new>
 #include <stdexcept>
+#include <tuple>
 #include <utility>
 #include <type_traits>
 
+#include "Math/MathTypes.h"
+#include "Memory/Pool.h"
+
 template<typename TElement>
 class TArrayView;
 
@@ -88,91 +96,291 @@ public:
     }
 };
 
-template<typename T>
+enum class ESharedPtrMode : uint8
+{
+    // Plain counts, for pointers that never leave the owning thread.
+    NotThreadSafe,
+
+    // Atomic counts, for pointers shared between the render and worker threads.
+    ThreadSafe
+};
+
+namespace SharedPtrInternals
+{
+    template<ESharedPtrMode Mode>
+    struct TReferenceCounter
+    {
+        uint32 Value;
+
+        explicit TReferenceCounter(uint32 InValue) : Value(InValue) {}
+
+        inline uint32 Get() const { return Value; }
+        inline void Increment() { ++Value; }
+        inline uint32 Decrement() { return --Value; }
+
+        inline bool IncrementIfNotZero()
+        {
+            if (Value == 0)
+            {
+                return false;
+            }
+            ++Value;
+            return true;
+        }
+    };
+
+    template<>
+    struct TReferenceCounter<ESharedPtrMode::ThreadSafe>
+    {
+        std::atomic<uint32> Value;
+
+        explicit TReferenceCounter(uint32 InValue) : Value(InValue) {}
+
+        inline uint32 Get() const { return Value.load(std::memory_order_relaxed); }
+
+        // A new reference is always made from an existing one, so the increment needs no ordering.
+        inline void Increment() { Value.fetch_add(1, std::memory_order_relaxed); }
+
+        // Release orders our writes to the object before its destruction, acquire makes the last owner see them.
+        inline uint32 Decrement() { return Value.fetch_sub(1, std::memory_order_acq_rel) - 1; }
+
+        inline bool IncrementIfNotZero()
+        {
+            uint32 Expected = Value.load(std::memory_order_relaxed);
+            while (Expected != 0)
+            {
+                if (Value.compare_exchange_weak(Expected, Expected + 1, std::memory_order_relaxed))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+    /*
+     * Control block shared by all TSharedPtr and TWeakPtr instances of one object. The weak count holds
+     * one extra reference on behalf of all shared references, so the block dies with the last pointer of either kind.
+     */
+    template<ESharedPtrMode Mode>
+    class TReferenceController
+    {
+    public:
+        TReferenceController()
+            : SharedCount(1), WeakCount(1)
+        {
+        }
+
+        virtual ~TReferenceController() = default;
+
+        TReferenceController(const TReferenceController&) = delete;
+        TReferenceController& operator=(const TReferenceController&) = delete;
+
+        inline void AddShared()
+        {
+            SharedCount.Increment();
+        }
+
+        inline bool TryAddShared()
+        {
+            return SharedCount.IncrementIfNotZero();
+        }
+
+        inline void ReleaseShared()
+        {
+            if (SharedCount.Decrement() == 0)
+            {
+                DestroyObject();
+                ReleaseWeak();
+            }
+        }
+
+        inline void AddWeak()
+        {
+            WeakCount.Increment();
+        }
+
+        inline void ReleaseWeak()
+        {
+            if (WeakCount.Decrement() == 0)
+            {
+                DestroyController();
+            }
+        }
+
+        inline uint32 GetSharedCount() const
+        {
+            return SharedCount.Get();
+        }
+
+    protected:
+        virtual void DestroyObject() = 0;
+
+        virtual void DestroyController() = 0;
+
+    private:
+        TReferenceCounter<Mode> SharedCount;
+
+        TReferenceCounter<Mode> WeakCount;
+    };
+
+    /* Controls an object allocated separately by the caller. The blocks themselves are pooled. */
+    template<typename T, ESharedPtrMode Mode>
+    class TPointerController final : public TReferenceController<Mode>
+    {
+    public:
+        explicit TPointerController(T* InPointer)
+            : Pointer(InPointer)
+        {
+        }
+
+    protected:
+        void DestroyObject() override
+        {
+            delete Pointer;
+        }
+
+        void DestroyController() override
+        {
+            TObjectPool<TPointerController>::Delete(this);
+        }
+
+    private:
+        T* Pointer;
+    };
+
+    /* Controls an object living inside the block, so the object and its counts share one allocation. */
+    template<typename T, ESharedPtrMode Mode>
+    class TInlineController final : public TReferenceController<Mode>
+    {
+    public:
+        template<typename... TArgs>
+        explicit TInlineController(TArgs&&... Args)
+        {
+            new (Storage) T(std::forward<TArgs>(Args)...);
+        }
+
+        inline T* GetObject()
+        {
+            return reinterpret_cast<T*>(Storage);
+        }
+
+    protected:
+        void DestroyObject() override
+        {
+            GetObject()->~T();
+        }
+
+        void DestroyController() override
+        {
+            delete this;
+        }
+
+    private:
+        alignas(T) uint8 Storage[sizeof(T)];
+    };
+}
+
+template<typename T, ESharedPtrMode Mode = ESharedPtrMode::ThreadSafe>
+class TWeakPtr;
+
+/*
+ * Reference counted owning pointer. Counts are atomic unless Mode is NotThreadSafe. Prefer MakeSharedPtr,
+ * which places the object and its counts in a single allocation.
+ */
+template<typename T, ESharedPtrMode Mode = ESharedPtrMode::ThreadSafe>
 class TSharedPtr
 {
 private:
+    using TController = SharedPtrInternals::TReferenceController<Mode>;
+
     T* Pointer;
 
-    size_t* ReferenceCount;
+    TController* Controller;
+
+    TSharedPtr(T* InPointer, TController* InController)
+        : Pointer(InPointer), Controller(InController)
+    {
+    }
 
 public:
     TSharedPtr()
-        : Pointer(nullptr), ReferenceCount(0)
+        : Pointer(nullptr), Controller(nullptr)
     {
     }
-    
+
+    TSharedPtr(std::nullptr_t)
+        : TSharedPtr()
+    {
+    }
+
     explicit TSharedPtr(T* InPointer)
-        : Pointer(InPointer)
+        : Pointer(InPointer), Controller(nullptr)
     {
-        ReferenceCount = (InPointer ? new size_t(1) : nullptr);
+        if (InPointer)
+        {
+            Controller = TObjectPool<SharedPtrInternals::TPointerController<T, Mode>>::New(InPointer);
+        }
     }
 
     ~TSharedPtr()
     {
-        if (ReferenceCount && --(*ReferenceCount) == 0)
+        if (Controller)
         {
-            delete Pointer;
-            delete ReferenceCount;
+            Controller->ReleaseShared();
         }
     }
 
     TSharedPtr(const TSharedPtr& Other)
-        : Pointer(Other.Pointer)
+        : Pointer(Other.Pointer), Controller(Other.Controller)
     {
-        ReferenceCount = Other.ReferenceCount;
-        
-        if (ReferenceCount)
+        if (Controller)
         {
-            ++(*ReferenceCount);
+            Controller->AddShared();
         }
     }
 
     TSharedPtr(TSharedPtr&& Other) noexcept
-        : Pointer(Other.Pointer)
+        : Pointer(Other.Pointer), Controller(Other.Controller)
     {
-        ReferenceCount = Other.ReferenceCount;
-
         Other.Pointer = nullptr;
-        Other.ReferenceCount = nullptr;
+        Other.Controller = nullptr;
     }
 
-    TSharedPtr& operator=(const TSharedPtr& Other)
+    template<typename TOther, typename = std::enable_if_t<std::is_convertible_v<TOther*, T*>>>
+    TSharedPtr(const TSharedPtr<TOther, Mode>& Other)
+        : Pointer(Other.Pointer), Controller(Other.Controller)
     {
-        if (this != &Other)
+        if (Controller)
         {
-            if (ReferenceCount && --(*ReferenceCount) == 0) {
-                delete Pointer;
-                delete ReferenceCount;
-            }
-            
-            Pointer = Other.Pointer;
-            ReferenceCount = Other.ReferenceCount;
-
-            if (ReferenceCount)
-            {
-                ++(*ReferenceCount);     
-            }
+            Controller->AddShared();
         }
+    }
+
+    template<typename TOther, typename = std::enable_if_t<std::is_convertible_v<TOther*, T*>>>
+    TSharedPtr(TSharedPtr<TOther, Mode>&& Other) noexcept
+        : Pointer(Other.Pointer), Controller(Other.Controller)
+    {
+        Other.Pointer = nullptr;
+        Other.Controller = nullptr;
+    }
+
+    // Taking both pointers by value releases the previous pointee when the argument goes out of scope.
+    TSharedPtr& operator=(const TSharedPtr& Other)
+    {
+        TSharedPtr(Other).Swap(*this);
         return *this;
     }
 
     TSharedPtr& operator=(TSharedPtr&& Other) noexcept
     {
-        if (this != &Other)
-        {
-            Pointer = Other.Pointer;
-            ReferenceCount = Other.ReferenceCount;
-
-            Other.Pointer = nullptr;
-            Other.ReferenceCount = nullptr;
-        }
+        TSharedPtr(std::move(Other)).Swap(*this);
         return *this;
     }
 
-    TSharedPtr& operator=(decltype(__nullptr))
+    TSharedPtr& operator=(std::nullptr_t)
     {
-        Reset(nullptr);
+        Reset();
         return *this;
     }
 
@@ -181,6 +389,16 @@ public:
         return IsValid();
     }
 
+    bool operator==(const TSharedPtr& Other) const
+    {
+        return Pointer == Other.Pointer;
+    }
+
+    bool operator!=(const TSharedPtr& Other) const
+    {
+        return Pointer != Other.Pointer;
+    }
+
     T& operator*() const
     {
         return *Get();
@@ -196,31 +414,18 @@ public:
         return Pointer;
     }
 
-    T* Release()
+    void Reset(T* NewPointer = nullptr)
     {
-        T* TempPointer = Pointer;
-        if (ReferenceCount && --(*ReferenceCount) == 0)
+        if (Pointer != NewPointer)
         {
-            delete ReferenceCount;
+            TSharedPtr(NewPointer).Swap(*this);
         }
-        Pointer = nullptr;
-        ReferenceCount = nullptr;
-        return TempPointer;
     }
 
-    void Reset(T* NewPointer = nullptr)
+    void Swap(TSharedPtr& Other) noexcept
     {
-        if (Pointer != NewPointer)
-        {
-            if (ReferenceCount && --(*ReferenceCount) == 0)
-            {
-                delete Pointer;
-                delete ReferenceCount;
-            }
-
-            Pointer = NewPointer;
-            ReferenceCount = (NewPointer ? new size_t(1) : nullptr);
-        }
+        std::swap(Pointer, Other.Pointer);
+        std::swap(Controller, Other.Controller);
     }
 
     bool IsValid() const
@@ -235,201 +440,1005 @@ public:
     
     size_t GetReferenceCount() const
     {
-        return *ReferenceCount;
+        return Controller ? Controller->GetSharedCount() : 0;
     }
+
+private:
+    template<typename, ESharedPtrMode>
+    friend class TSharedPtr;
+
+    template<typename, ESharedPtrMode>
+    friend class TWeakPtr;
+
+    template<typename TObject, ESharedPtrMode ObjectMode, typename... TArgs>
+    friend TSharedPtr<TObject, ObjectMode> MakeSharedPtrWithMode(TArgs&&... Args);
 };
 
 /*
- * TArray is contiguous and fixed-size, while also a dynamic memory. 
+ * Non-owning reference to an object owned by TSharedPtr. It keeps the control block alive but not the object,
+ * Lock() returns an empty pointer once the last shared reference is gone.
  */
-template<typename TElement>
-class TArray
+template<typename T, ESharedPtrMode Mode>
+class TWeakPtr
 {
 private:
-    size_t Size;
+    using TController = SharedPtrInternals::TReferenceController<Mode>;
 
-    size_t Capacity;
+    T* Pointer;
 
-    TElement* Data;
+    TController* Controller;
 
 public:
-    TArray()
-        : Size(0), Capacity(1), Data(new TElement[Capacity])
+    TWeakPtr()
+        : Pointer(nullptr), Controller(nullptr)
     {
     }
 
-    TArray(std::initializer_list<TElement> Init)
-        : Size(Init.size()), Capacity(Init.size()), Data(new TElement[Capacity])
+    TWeakPtr(const TSharedPtr<T, Mode>& Shared)
+        : Pointer(Shared.Pointer), Controller(Shared.Controller)
     {
-        std::copy(Init.begin(), Init.end(), Data);
+        if (Controller)
+        {
+            Controller->AddWeak();
+        }
     }
 
-    TArray(const TArray& Other)
-        : Size(Other.Size), Capacity(Other.Capacity), Data(new TElement[Capacity])
+    TWeakPtr(const TWeakPtr& Other)
+        : Pointer(Other.Pointer), Controller(Other.Controller)
     {
-        std::copy(Other.Data, Other.Data + Other.Size, Data);
+        if (Controller)
+        {
+            Controller->AddWeak();
+        }
     }
 
-    TArray(TArray&& Other) noexcept
-        : Size(Other.Size), Capacity(Other.Capacity), Data(Other.Data)
+    TWeakPtr(TWeakPtr&& Other) noexcept
+        : Pointer(Other.Pointer), Controller(Other.Controller)
     {
-        Other.Size = 0;
-        Other.Capacity = 0;
-        Other.Data = nullptr;
+        Other.Pointer = nullptr;
+        Other.Controller = nullptr;
     }
 
-    ~TArray()
+    ~TWeakPtr()
     {
-        delete[] Data;
+        if (Controller)
+        {
+            Controller->ReleaseWeak();
+        }
     }
 
-    TArray& operator=(const TArray& Other)
+    TWeakPtr& operator=(const TWeakPtr& Other)
     {
-        if (this != &Other)
-        {
-            TElement* NewData = new TElement[Other.Capacity];
-            std::copy(Other.Data, Other.Data + Other.Size, NewData);
-            delete[] Data;
-            Size = Other.Size;
-            Capacity = Other.Capacity;
-            Data = NewData;
-        }
+        TWeakPtr(Other).Swap(*this);
         return *this;
     }
 
-    TArray& operator=(TArray&& Other) noexcept // Move
+    TWeakPtr& operator=(TWeakPtr&& Other) noexcept
     {
-        if (this != &Other)
-        {
-            delete[] Data;
-            Size = Other.Size;
-            Capacity = Other.Capacity;
-            Data = Other.Data;
-            Other.Size = 0;
-            Other.Capacity = 0;
-            Other.Data = nullptr;
-        }
+        TWeakPtr(std::move(Other)).Swap(*this);
         return *this;
     }
 
-    TElement& operator[](size_t Index)
+    TWeakPtr& operator=(const TSharedPtr<T, Mode>& Shared)
     {
-        if (Index >= Size) throw std::out_of_range("Index is out of range.");
-        return Data[Index];
+        TWeakPtr(Shared).Swap(*this);
+        return *this;
     }
 
-    const TElement& operator[](size_t Index) const
+    // Returns a shared reference if the object is still alive, or an empty pointer otherwise.
+    TSharedPtr<T, Mode> Lock() const
     {
-        if (Index >= Size) throw std::out_of_range("Index is out of range.");
-        return Data[Index];
+        if (Controller && Controller->TryAddShared())
+        {
+            return TSharedPtr<T, Mode>(Pointer, Controller);
+        }
+        return TSharedPtr<T, Mode>();
     }
 
-    TElement& At(size_t Index)
+    void Reset()
     {
-        if (Index >= Size) throw std::out_of_range("Index is out of range.");
-        return Data[Index];
+        TWeakPtr().Swap(*this);
     }
 
-    const TElement& At(size_t Index) const
+    void Swap(TWeakPtr& Other) noexcept
     {
-        if (Index >= Size) throw std::out_of_range("Index is out of range.");
-        return Data[Index]; 
+        std::swap(Pointer, Other.Pointer);
+        std::swap(Controller, Other.Controller);
     }
 
-    TElement* begin() { return Data; }
-    TElement* end() { return Data + Size; }
+    // The result may be stale by the time it is read if other threads hold shared references, use Lock() instead.
+    bool IsValid() const
+    {
+        return Controller && Controller->GetSharedCount() > 0;
+    }
+};
 
-    const TElement* begin() const { return Data; }
-    const TElement* end() const { return Data + Size; }
-    
+/*
+ * Base for engine objects that embed their own reference count, managed through TRefCountPtr. The count is
+ * atomic and the object deletes itself when it drops to zero.
+ */
+class CRefCountedObject
+{
 public:
-    void Init(size_t NewCapacity, TElement InitToValue = nullptr)
+    CRefCountedObject()
+        : NumReferences(0)
     {
-        Reserve(NewCapacity);
-
-        for (size_t Index = 0; Index < NewCapacity; ++Index)
-        {
-            Push(InitToValue);
-        }
     }
-    
-    void Reserve(size_t NewCapacity)
+
+    // Copies start with their own count.
+    CRefCountedObject(const CRefCountedObject&)
+        : NumReferences(0)
     {
-        if (NewCapacity > Capacity)
-        {
-            TElement* NewData = new TElement[NewCapacity];
-            std::move(Data, Data + Size, NewData);
-            delete[] Data;
-            Capacity = NewCapacity;
-            Data = NewData;
-        }
     }
-    
-    void Push(const TElement& Value)
-    {
-        if (Size >= Capacity)
-        {
-            Reserve(Capacity * 2);
-        }
 
-        Data[Size++] = Value;
-    }
-    
-    void Push(TElement&& Value)
+    CRefCountedObject& operator=(const CRefCountedObject&)
     {
-        if (Size >= Capacity)
-        {
-            Reserve(Capacity * 2);
-        }
-
-        Data[Size++] = std::move(Value);
+        return *this;
     }
 
-    TElement Pop()
+    virtual ~CRefCountedObject() = default;
+
+    uint32 AddRef() const
     {
-        if (Size > 0)
-        {
-            Data[--Size].~TElement();
-        }
-        return TElement();
+        return NumReferences.fetch_add(1, std::memory_order_relaxed) + 1;
     }
 
-    void Empty()
+    uint32 Release() const
     {
-        while (Size > 0)
+        const uint32 Remaining = NumReferences.fetch_sub(1, std::memory_order_acq_rel) - 1;
+        if (Remaining == 0)
         {
-            Data[--Size].~TElement();
+            delete this;
         }
+        return Remaining;
     }
 
-    size_t GetSize() const
+    uint32 GetRefCount() const
     {
-        return Size;
+        return NumReferences.load(std::memory_order_relaxed);
     }
 
 private:
-    friend class TArrayView<TElement>;
+    mutable std::atomic<uint32> NumReferences;
 };
 
 /*
- * Non-owning, fixed-size view of a contiguous block of memory (the TArray).
+ * Intrusive reference counted pointer, a single pointer wide. T must provide AddRef() and Release(),
+ * e.g. by deriving from CRefCountedObject.
  */
-template<typename TElement>
-class TArrayView
+template<typename T>
+class TRefCountPtr
 {
 private:
-    TElement* Data;
-
-    size_t Size;
+    T* Reference;
 
 public:
-    TArrayView(TElement* InData, size_t InSize)
-        : Data(InData), Size(InSize)
+    TRefCountPtr()
+        : Reference(nullptr)
     {
     }
 
-    TArrayView(const TArray<TElement>& Array)
-        : Data(Array.Data), Size(Array.Size)
+    TRefCountPtr(std::nullptr_t)
+        : Reference(nullptr)
+    {
+    }
+
+    TRefCountPtr(T* InReference, bool bAddRef = true)
+        : Reference(InReference)
+    {
+        if (Reference && bAddRef)
+        {
+            Reference->AddRef();
+        }
+    }
+
+    TRefCountPtr(const TRefCountPtr& Other)
+        : TRefCountPtr(Other.Reference)
+    {
+    }
+
+    TRefCountPtr(TRefCountPtr&& Other) noexcept
+        : Reference(Other.Reference)
+    {
+        Other.Reference = nullptr;
+    }
+
+    template<typename TOther, typename = std::enable_if_t<std::is_convertible_v<TOther*, T*>>>
+    TRefCountPtr(const TRefCountPtr<TOther>& Other)
+        : TRefCountPtr(Other.Get())
+    {
+    }
+
+    ~TRefCountPtr()
+    {
+        if (Reference)
+        {
+            Reference->Release();
+        }
+    }
+
+    TRefCountPtr& operator=(const TRefCountPtr& Other)
+    {
+        TRefCountPtr(Other).Swap(*this);
+        return *this;
+    }
+
+    TRefCountPtr& operator=(TRefCountPtr&& Other) noexcept
+    {
+        TRefCountPtr(std::move(Other)).Swap(*this);
+        return *this;
+    }
+
+    TRefCountPtr& operator=(T* InReference)
+    {
+        TRefCountPtr(InReference).Swap(*this);
+        return *this;
+    }
+
+    explicit operator bool() const
+    {
+        return IsValid();
+    }
+
+    bool operator==(const TRefCountPtr& Other) const
+    {
+        return Reference == Other.Reference;
+    }
+
+    bool operator!=(const TRefCountPtr& Other) const
+    {
+        return Reference != Other.Reference;
+    }
+
+    T& operator*() const
+    {
+        return *Reference;
+    }
+
+    T* operator->() const
+    {
+        return Reference;
+    }
+
+    T* Get() const
+    {
+        return Reference;
+    }
+
+    void Swap(TRefCountPtr& Other) noexcept
+    {
+        std::swap(Reference, Other.Reference);
+    }
+
+    bool IsValid() const
+    {
+        return Reference != nullptr;
+    }
+
+    uint32 GetRefCount() const
+    {
+        return Reference ? Reference->GetRefCount() : 0;
+    }
+};
+
+/*
+ * Types that can be moved to a new address with a plain memcpy, after which the source is treated as
+ * uninitialized storage without running its destructor. Specialize for engine types that qualify.
+ */
+template<typename T>
+struct TIsTriviallyRelocatable : std::bool_constant<std::is_trivially_copyable_v<T>>
+{
+};
+
+template<typename T>
+struct TIsTriviallyRelocatable<TUniquePtr<T>> : std::true_type
+{
+};
+
+template<typename T, ESharedPtrMode Mode>
+struct TIsTriviallyRelocatable<TSharedPtr<T, Mode>> : std::true_type
+{
+};
+
+template<typename T, ESharedPtrMode Mode>
+struct TIsTriviallyRelocatable<TWeakPtr<T, Mode>> : std::true_type
+{
+};
+
+template<typename T>
+struct TIsTriviallyRelocatable<TRefCountPtr<T>> : std::true_type
+{
+};
+
+/* Moves Count elements from Source into uninitialized Destination and ends the lifetime of the sources. */
+template<typename TElement>
+static inline void RelocateElements(TElement* Destination, TElement* Source, size_t Count)
+{
+    if constexpr (TIsTriviallyRelocatable<TElement>::value)
+    {
+        if (Count > 0)
+        {
+            std::memcpy(static_cast<void*>(Destination), static_cast<const void*>(Source), Count * sizeof(TElement));
+        }
+    }
+    else
+    {
+        for (size_t Index = 0; Index < Count; ++Index)
+        {
+            new (Destination + Index) TElement(std::move(Source[Index]));
+            Source[Index].~TElement();
+        }
+    }
+}
+
+template<typename TElement>
+static inline void DestructElements(TElement* Elements, size_t Count)
+{
+    if constexpr (!std::is_trivially_destructible_v<TElement>)
+    {
+        for (size_t Index = 0; Index < Count; ++Index)
+        {
+            Elements[Index].~TElement();
+        }
+    }
+}
+
+/*
+ * Default container allocator, backed by the tracked global heap.
+ */
+struct SHeapAllocator
+{
+    inline void* Allocate(size_t Size, size_t Alignment)
+    {
+        void* Block = Mem::MallocAligned(Size, Alignment);
+        if (Block == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        return Block;
+    }
+
+    inline void Free(void* Block, size_t /*Size*/)
+    {
+        Mem::FreeAligned(Block);
+    }
+};
+
+/*
+ * TArray is contiguous and fixed-size, while also a dynamic memory. Storage is raw memory from TAllocator,
+ * elements are only constructed in [0, Size) and capacity beyond that stays uninitialized.
+ */
+template<typename TElement, typename TAllocator = SHeapAllocator>
+class TArray
+{
+private:
+    size_t Size;
+
+    size_t Capacity;
+
+    TElement* Data;
+
+    TAllocator Allocator;
+
+public:
+    TArray()
+        : Size(0), Capacity(0), Data(nullptr), Allocator()
+    {
+    }
+
+    explicit TArray(const TAllocator& InAllocator)
+        : Size(0), Capacity(0), Data(nullptr), Allocator(InAllocator)
+    {
+    }
+
+    TArray(std::initializer_list<TElement> Init)
+        : Size(0), Capacity(0), Data(nullptr), Allocator()
+    {
+        Reserve(Init.size());
+        for (const TElement& Element : Init)
+        {
+            new (Data + Size++) TElement(Element);
+        }
+    }
+
+    TArray(const TArray& Other)
+        : Size(0), Capacity(0), Data(nullptr), Allocator(Other.Allocator)
+    {
+        Reserve(Other.Size);
+        for (const TElement& Element : Other)
+        {
+            new (Data + Size++) TElement(Element);
+        }
+    }
+
+    TArray(TArray&& Other) noexcept
+        : Size(Other.Size), Capacity(Other.Capacity), Data(Other.Data), Allocator(std::move(Other.Allocator))
+    {
+        Other.Size = 0;
+        Other.Capacity = 0;
+        Other.Data = nullptr;
+    }
+
+    ~TArray()
+    {
+        DestructElements(Data, Size);
+        FreeData();
+    }
+
+    TArray& operator=(const TArray& Other)
+    {
+        if (this != &Other)
+        {
+            Empty();
+            Reserve(Other.Size);
+            for (const TElement& Element : Other)
+            {
+                new (Data + Size++) TElement(Element);
+            }
+        }
+        return *this;
+    }
+
+    TArray& operator=(TArray&& Other) noexcept // Move
+    {
+        if (this != &Other)
+        {
+            DestructElements(Data, Size);
+            FreeData();
+            Size = Other.Size;
+            Capacity = Other.Capacity;
+            Data = Other.Data;
+            Allocator = std::move(Other.Allocator);
+            Other.Size = 0;
+            Other.Capacity = 0;
+            Other.Data = nullptr;
+        }
+        return *this;
+    }
+
+    TElement& operator[](size_t Index)
+    {
+        if (Index >= Size) throw std::out_of_range("Index is out of range.");
+        return Data[Index];
+    }
+
+    const TElement& operator[](size_t Index) const
+    {
+        if (Index >= Size) throw std::out_of_range("Index is out of range.");
+        return Data[Index];
+    }
+
+    TElement& At(size_t Index)
+    {
+        if (Index >= Size) throw std::out_of_range("Index is out of range.");
+        return Data[Index];
+    }
+
+    const TElement& At(size_t Index) const
+    {
+        if (Index >= Size) throw std::out_of_range("Index is out of range.");
+        return Data[Index]; 
+    }
+
+    TElement* begin() { return Data; }
+    TElement* end() { return Data + Size; }
+
+    const TElement* begin() const { return Data; }
+    const TElement* end() const { return Data + Size; }
+    
+public:
+    void Init(size_t NewCapacity, const TElement& InitToValue = TElement())
+    {
+        Reserve(NewCapacity);
+
+        for (size_t Index = 0; Index < NewCapacity; ++Index)
+        {
+            Push(InitToValue);
+        }
+    }
+    
+    void Reserve(size_t NewCapacity)
+    {
+        if (NewCapacity > Capacity)
+        {
+            Reallocate(NewCapacity);
+        }
+    }
+
+    // Releases unused capacity.
+    void Shrink()
+    {
+        if (Capacity > Size)
+        {
+            Reallocate(Size);
+        }
+    }
+
+    // Value-initializes appended elements and destroys trailing ones.
+    void Resize(size_t NewSize)
+    {
+        if (NewSize < Size)
+        {
+            DestructElements(Data + NewSize, Size - NewSize);
+        }
+        else
+        {
+            Reserve(NewSize);
+            for (size_t Index = Size; Index < NewSize; ++Index)
+            {
+                new (Data + Index) TElement();
+            }
+        }
+        Size = NewSize;
+    }
+    
+    void Push(const TElement& Value)
+    {
+        Emplace(Value);
+    }
+    
+    void Push(TElement&& Value)
+    {
+        Emplace(std::move(Value));
+    }
+
+    template<typename... TArgs>
+    TElement& Emplace(TArgs&&... Args)
+    {
+        if (Size < Capacity)
+        {
+            return *new (Data + Size++) TElement(std::forward<TArgs>(Args)...);
+        }
+
+        // Construct into the new block before relocating, as Args may refer to an element of this array.
+        const size_t NewCapacity = Capacity > 0 ? Capacity * 2 : 4;
+        TElement* NewData = static_cast<TElement*>(Allocator.Allocate(NewCapacity * sizeof(TElement), alignof(TElement)));
+        new (NewData + Size) TElement(std::forward<TArgs>(Args)...);
+        RelocateElements(NewData, Data, Size);
+        FreeData();
+
+        Data = NewData;
+        Capacity = NewCapacity;
+        return Data[Size++];
+    }
+
+    TElement Pop()
+    {
+        if (Size == 0)
+        {
+            return TElement();
+        }
+
+        TElement Value = std::move(Data[Size - 1]);
+        Data[--Size].~TElement();
+        return Value;
+    }
+
+    // O(1) removal that fills the hole with the last element, so element order is not preserved.
+    void RemoveAtSwap(size_t Index)
+    {
+        if (Index >= Size) throw std::out_of_range("Index is out of range.");
+
+        Data[Index].~TElement();
+        if (Index != --Size)
+        {
+            RelocateElements(Data + Index, Data + Size, 1);
+        }
+    }
+
+    bool Contains(const TElement& Value) const
+    {
+        for (const TElement& Element : *this)
+        {
+            if (Element == Value)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Empty()
+    {
+        DestructElements(Data, Size);
+        Size = 0;
+    }
+
+    size_t GetSize() const
+    {
+        return Size;
+    }
+
+    size_t GetCapacity() const
+    {
+        return Capacity;
+    }
+
+    bool IsEmpty() const
+    {
+        return Size == 0;
+    }
+
+    TElement* GetData()
+    {
+        return Data;
+    }
+
+    const TElement* GetData() const
+    {
+        return Data;
+    }
+
+private:
+    void Reallocate(size_t NewCapacity)
+    {
+        TElement* NewData = nullptr;
+        if (NewCapacity > 0)
+        {
+            NewData = static_cast<TElement*>(Allocator.Allocate(NewCapacity * sizeof(TElement), alignof(TElement)));
+            RelocateElements(NewData, Data, Size);
+        }
+        FreeData();
+        Capacity = NewCapacity;
+        Data = NewData;
+    }
+
+    void FreeData()
+    {
+        if (Data != nullptr)
+        {
+            Allocator.Free(Data, Capacity * sizeof(TElement));
+        }
+    }
+
+    template<typename>
+    friend class TArrayView;
+};
+
+template<typename TElement, typename TAllocator>
+struct TIsTriviallyRelocatable<TArray<TElement, TAllocator>> : TIsTriviallyRelocatable<TAllocator>
+{
+};
+
+/*
+ * Array with storage for NumInlineElements elements inside the object itself. Only when it grows past that
+ * does it spill to the heap, so small, bounded lists rebuilt every frame never touch the allocator.
+ */
+template<typename TElement, size_t NumInlineElements>
+class TInlineArray
+{
+    static_assert(NumInlineElements > 0, "TInlineArray requires inline capacity, use TArray instead.");
+
+private:
+    size_t Size;
+
+    size_t Capacity;
+
+    TElement* Data;
+
+    alignas(TElement) uint8 InlineStorage[NumInlineElements * sizeof(TElement)];
+
+public:
+    TInlineArray()
+        : Size(0), Capacity(NumInlineElements), Data(GetInlineData())
+    {
+    }
+
+    TInlineArray(std::initializer_list<TElement> Init)
+        : TInlineArray()
+    {
+        Reserve(Init.size());
+        for (const TElement& Element : Init)
+        {
+            new (Data + Size++) TElement(Element);
+        }
+    }
+
+    TInlineArray(const TInlineArray& Other)
+        : TInlineArray()
+    {
+        Reserve(Other.Size);
+        for (const TElement& Element : Other)
+        {
+            new (Data + Size++) TElement(Element);
+        }
+    }
+
+    TInlineArray(TInlineArray&& Other) noexcept
+        : TInlineArray()
+    {
+        MoveFrom(Other);
+    }
+
+    ~TInlineArray()
+    {
+        DestructElements(Data, Size);
+        FreeData();
+    }
+
+    TInlineArray& operator=(const TInlineArray& Other)
+    {
+        if (this != &Other)
+        {
+            Empty();
+            Reserve(Other.Size);
+            for (const TElement& Element : Other)
+            {
+                new (Data + Size++) TElement(Element);
+            }
+        }
+        return *this;
+    }
+
+    TInlineArray& operator=(TInlineArray&& Other) noexcept
+    {
+        if (this != &Other)
+        {
+            DestructElements(Data, Size);
+            FreeData();
+            Size = 0;
+            Capacity = NumInlineElements;
+            Data = GetInlineData();
+            MoveFrom(Other);
+        }
+        return *this;
+    }
+
+    TElement& operator[](size_t Index)
+    {
+        if (Index >= Size) throw std::out_of_range("Index is out of range.");
+        return Data[Index];
+    }
+
+    const TElement& operator[](size_t Index) const
+    {
+        if (Index >= Size) throw std::out_of_range("Index is out of range.");
+        return Data[Index];
+    }
+
+    TElement& At(size_t Index)
+    {
+        if (Index >= Size) throw std::out_of_range("Index is out of range.");
+        return Data[Index];
+    }
+
+    const TElement& At(size_t Index) const
+    {
+        if (Index >= Size) throw std::out_of_range("Index is out of range.");
+        return Data[Index];
+    }
+
+    TElement* begin() { return Data; }
+    TElement* end() { return Data + Size; }
+
+    const TElement* begin() const { return Data; }
+    const TElement* end() const { return Data + Size; }
+
+public:
+    void Init(size_t NewCapacity, const TElement& InitToValue = TElement())
+    {
+        Reserve(NewCapacity);
+
+        for (size_t Index = 0; Index < NewCapacity; ++Index)
+        {
+            Push(InitToValue);
+        }
+    }
+
+    void Reserve(size_t NewCapacity)
+    {
+        if (NewCapacity > Capacity)
+        {
+            Reallocate(NewCapacity);
+        }
+    }
+
+    // Releases unused capacity, moving the elements back into the inline storage when they fit.
+    void Shrink()
+    {
+        if (!IsInline() && Capacity > Size)
+        {
+            Reallocate(Size);
+        }
+    }
+
+    void Resize(size_t NewSize)
+    {
+        if (NewSize < Size)
+        {
+            DestructElements(Data + NewSize, Size - NewSize);
+        }
+        else
+        {
+            Reserve(NewSize);
+            for (size_t Index = Size; Index < NewSize; ++Index)
+            {
+                new (Data + Index) TElement();
+            }
+        }
+        Size = NewSize;
+    }
+
+    void Push(const TElement& Value)
+    {
+        Emplace(Value);
+    }
+
+    void Push(TElement&& Value)
+    {
+        Emplace(std::move(Value));
+    }
+
+    template<typename... TArgs>
+    TElement& Emplace(TArgs&&... Args)
+    {
+        if (Size == Capacity)
+        {
+            // Args may refer to an element of this array, so construct a copy before relocating.
+            TElement Value(std::forward<TArgs>(Args)...);
+            Reserve(Capacity * 2);
+            return *new (Data + Size++) TElement(std::move(Value));
+        }
+        return *new (Data + Size++) TElement(std::forward<TArgs>(Args)...);
+    }
+
+    TElement Pop()
+    {
+        if (Size == 0)
+        {
+            return TElement();
+        }
+
+        TElement Value = std::move(Data[Size - 1]);
+        Data[--Size].~TElement();
+        return Value;
+    }
+
+    void RemoveAtSwap(size_t Index)
+    {
+        if (Index >= Size) throw std::out_of_range("Index is out of range.");
+
+        Data[Index].~TElement();
+        if (Index != --Size)
+        {
+            RelocateElements(Data + Index, Data + Size, 1);
+        }
+    }
+
+    bool Contains(const TElement& Value) const
+    {
+        for (const TElement& Element : *this)
+        {
+            if (Element == Value)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Empty()
+    {
+        DestructElements(Data, Size);
+        Size = 0;
+    }
+
+    size_t GetSize() const
+    {
+        return Size;
+    }
+
+    size_t GetCapacity() const
+    {
+        return Capacity;
+    }
+
+    bool IsEmpty() const
+    {
+        return Size == 0;
+    }
+
+    // True while the elements still live in the inline storage.
+    bool IsInline() const
+    {
+        return Data == GetInlineData();
+    }
+
+    TElement* GetData()
+    {
+        return Data;
+    }
+
+    const TElement* GetData() const
+    {
+        return Data;
+    }
+
+private:
+    inline TElement* GetInlineData()
+    {
+        return reinterpret_cast<TElement*>(InlineStorage);
+    }
+
+    inline const TElement* GetInlineData() const
+    {
+        return reinterpret_cast<const TElement*>(InlineStorage);
+    }
+
+    void Reallocate(size_t NewCapacity)
+    {
+        TElement* NewData = GetInlineData();
+        if (NewCapacity > NumInlineElements)
+        {
+            NewData = static_cast<TElement*>(SHeapAllocator().Allocate(NewCapacity * sizeof(TElement), alignof(TElement)));
+        }
+        else
+        {
+            NewCapacity = NumInlineElements;
+        }
+
+        RelocateElements(NewData, Data, Size);
+        FreeData();
+        Capacity = NewCapacity;
+        Data = NewData;
+    }
+
+    // Expects this array to be empty and inline.
+    void MoveFrom(TInlineArray& Other)
+    {
+        if (Other.IsInline())
+        {
+            RelocateElements(Data, Other.Data, Other.Size);
+        }
+        else
+        {
+            Data = Other.Data;
+            Capacity = Other.Capacity;
+            Other.Data = Other.GetInlineData();
+            Other.Capacity = NumInlineElements;
+        }
+        Size = Other.Size;
+        Other.Size = 0;
+    }
+
+    void FreeData()
+    {
+        if (!IsInline())
+        {
+            SHeapAllocator().Free(Data, Capacity * sizeof(TElement));
+        }
+    }
+
+    template<typename>
+    friend class TArrayView;
+};
+
+/*
+ * Non-owning, fixed-size view of a contiguous block of memory (the TArray).
+ */
+template<typename TElement>
+class TArrayView
+{
+private:
+    TElement* Data;
+
+    size_t Size;
+
+public:
+    TArrayView(TElement* InData, size_t InSize)
+        : Data(InData), Size(InSize)
+    {
+    }
+
+    template<typename TAllocator>
+    TArrayView(const TArray<TElement, TAllocator>& Array)
+        : Data(Array.Data), Size(Array.Size)
+    {
+    }
+
+    template<size_t NumInlineElements>
+    TArrayView(const TInlineArray<TElement, NumInlineElements>& Array)
+        : Data(Array.Data), Size(Array.Size)
     {
     }
 
@@ -449,6 +1458,251 @@ public:
     {
         return Size;
     }
+
+    inline bool IsEmpty() const
+    {
+        return Size == 0;
+    }
+
+    inline TElement* GetData() const
+    {
+        return Data;
+    }
+
+    TElement* begin() const { return Data; }
+    TElement* end() const { return Data + Size; }
+};
+
+/*
+ * Structure-of-arrays container: each field lives in its own contiguous stream, so a system touching one field
+ * streams only that field through the cache. All streams share a single allocation and start on a cache line.
+ *
+ * Capacity is kept a multiple of SimdPadding elements and the spare tail is zeroed when allocated, so vector loops
+ * may run up to GetPaddedSize() without a scalar remainder. Values past GetSize() are unspecified. Fields must be
+ * trivially copyable, streams are relocated with a plain copy.
+ */
+template<typename... TFields>
+class TSoAArray
+{
+    static_assert(sizeof...(TFields) > 0, "TSoAArray requires at least one field.");
+    static_assert((std::is_trivially_copyable_v<TFields> && ...), "TSoAArray fields must be trivially copyable.");
+
+public:
+    static constexpr size_t NumFields = sizeof...(TFields);
+
+    // Enough for a full AVX-512 register of 32-bit lanes.
+    static constexpr size_t SimdPadding = 16;
+
+    template<size_t FieldIndex>
+    using TField = std::tuple_element_t<FieldIndex, std::tuple<TFields...>>;
+
+private:
+    using TIndices = std::index_sequence_for<TFields...>;
+
+    static constexpr size_t StreamAlignment = CACHE_LINE_SIZE;
+
+    std::tuple<TFields*...> Streams;
+
+    size_t Size = 0;
+
+    size_t Capacity = 0;
+
+    uint8* Block = nullptr;
+
+public:
+    TSoAArray() = default;
+
+    TSoAArray(const TSoAArray& Other)
+    {
+        Reserve(Other.Size);
+        CopyStreams(Streams, Other.Streams, Other.Size, TIndices());
+        Size = Other.Size;
+    }
+
+    TSoAArray(TSoAArray&& Other) noexcept
+        : Streams(Other.Streams), Size(Other.Size), Capacity(Other.Capacity), Block(Other.Block)
+    {
+        Other.Streams = std::tuple<TFields*...>();
+        Other.Size = 0;
+        Other.Capacity = 0;
+        Other.Block = nullptr;
+    }
+
+    ~TSoAArray()
+    {
+        Mem::FreeAligned(Block);
+    }
+
+    TSoAArray& operator=(TSoAArray Other) noexcept
+    {
+        std::swap(Streams, Other.Streams);
+        std::swap(Size, Other.Size);
+        std::swap(Capacity, Other.Capacity);
+        std::swap(Block, Other.Block);
+        return *this;
+    }
+
+    // Appends one element, one value per field. Returns its index. Values are taken by copy, as they may refer into
+    // the streams that growing reallocates.
+    size_t Emplace(TFields... Values)
+    {
+        if (Size == Capacity)
+        {
+            Reserve(Capacity == 0 ? SimdPadding : Capacity * 2);
+        }
+
+        StoreValues(Size, TIndices(), Values...);
+        return Size++;
+    }
+
+    void RemoveAtSwap(size_t Index)
+    {
+        if (Index >= Size) throw std::out_of_range("Index is out of range.");
+
+        --Size;
+        if (Index != Size)
+        {
+            MoveElement(Index, Size, TIndices());
+        }
+    }
+
+    void Reserve(size_t NewCapacity)
+    {
+        NewCapacity = (NewCapacity + SimdPadding - 1) & ~(SimdPadding - 1);
+        if (NewCapacity <= Capacity)
+        {
+            return;
+        }
+
+        uint8* NewBlock = static_cast<uint8*>(Mem::MallocAligned(GetBlockSize(NewCapacity), StreamAlignment));
+        if (NewBlock == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        Mem::MemZero(NewBlock, GetBlockSize(NewCapacity));
+
+        std::tuple<TFields*...> NewStreams;
+        AssignStreams(NewStreams, NewBlock, NewCapacity, TIndices());
+        CopyStreams(NewStreams, Streams, Size, TIndices());
+
+        Mem::FreeAligned(Block);
+        Block = NewBlock;
+        Streams = NewStreams;
+        Capacity = NewCapacity;
+    }
+
+    // Grows or shrinks the element count. New elements are zeroed.
+    void Resize(size_t NewSize)
+    {
+        Reserve(NewSize);
+        if (NewSize > Size)
+        {
+            ZeroRange(Size, NewSize - Size, TIndices());
+        }
+        Size = NewSize;
+    }
+
+    void Empty()
+    {
+        Size = 0;
+    }
+
+    template<size_t FieldIndex>
+    inline TField<FieldIndex>& Get(size_t Index)
+    {
+        if (Index >= Size) throw std::out_of_range("Index is out of range.");
+        return std::get<FieldIndex>(Streams)[Index];
+    }
+
+    template<size_t FieldIndex>
+    inline const TField<FieldIndex>& Get(size_t Index) const
+    {
+        if (Index >= Size) throw std::out_of_range("Index is out of range.");
+        return std::get<FieldIndex>(Streams)[Index];
+    }
+
+    // View over the live elements of one field.
+    template<size_t FieldIndex>
+    inline TArrayView<TField<FieldIndex>> GetField() const
+    {
+        return TArrayView<TField<FieldIndex>>(std::get<FieldIndex>(Streams), Size);
+    }
+
+    // Raw stream pointer, aligned to StreamAlignment and valid up to GetPaddedSize().
+    template<size_t FieldIndex>
+    inline TField<FieldIndex>* GetFieldData() const
+    {
+        return std::get<FieldIndex>(Streams);
+    }
+
+    inline size_t GetSize() const
+    {
+        return Size;
+    }
+
+    // Size rounded up to SimdPadding, never more than the capacity.
+    inline size_t GetPaddedSize() const
+    {
+        return (Size + SimdPadding - 1) & ~(SimdPadding - 1);
+    }
+
+    inline size_t GetCapacity() const
+    {
+        return Capacity;
+    }
+
+    inline bool IsEmpty() const
+    {
+        return Size == 0;
+    }
+
+private:
+    static inline size_t AlignStream(size_t Offset)
+    {
+        return (Offset + StreamAlignment - 1) & ~(StreamAlignment - 1);
+    }
+
+    static size_t GetBlockSize(size_t InCapacity)
+    {
+        size_t Offset = 0;
+        ((Offset = AlignStream(Offset) + InCapacity * sizeof(TFields)), ...);
+        return AlignStream(Offset);
+    }
+
+    template<size_t... Indices>
+    static void AssignStreams(std::tuple<TFields*...>& Target, uint8* InBlock, size_t InCapacity, std::index_sequence<Indices...>)
+    {
+        size_t Offset = 0;
+        ((std::get<Indices>(Target) = reinterpret_cast<TFields*>(InBlock + AlignStream(Offset)),
+          Offset = AlignStream(Offset) + InCapacity * sizeof(TFields)), ...);
+    }
+
+    template<size_t... Indices>
+    static void CopyStreams(std::tuple<TFields*...>& Target, const std::tuple<TFields*...>& Source, size_t Count, std::index_sequence<Indices...>)
+    {
+        if (Count > 0)
+        {
+            (Mem::Memcpy(std::get<Indices>(Target), std::get<Indices>(Source), Count * sizeof(TFields)), ...);
+        }
+    }
+
+    template<size_t... Indices>
+    inline void StoreValues(size_t Index, std::index_sequence<Indices...>, const TFields&... Values)
+    {
+        ((std::get<Indices>(Streams)[Index] = Values), ...);
+    }
+
+    template<size_t... Indices>
+    inline void MoveElement(size_t Destination, size_t Source, std::index_sequence<Indices...>)
+    {
+        ((std::get<Indices>(Streams)[Destination] = std::get<Indices>(Streams)[Source]), ...);
+    }
+
+    template<size_t... Indices>
+    inline void ZeroRange(size_t Start, size_t Count, std::index_sequence<Indices...>)
+    {
+        (Mem::MemZero(std::get<Indices>(Streams) + Start, Count * sizeof(TFields)), ...);
+    }
 };
 
 template<typename T, typename... TArgs>
@@ -463,10 +1717,18 @@ static TUniquePtr<T> MakeUniquePtr(T* Other)
     return TUniquePtr<T>(Other);
 }
 
+/* Constructs the object inside its control block, so the shared pointer costs a single allocation. */
+template<typename T, ESharedPtrMode Mode, typename... TArgs>
+TSharedPtr<T, Mode> MakeSharedPtrWithMode(TArgs&&... Args)
+{
+    auto* Controller = new SharedPtrInternals::TInlineController<T, Mode>(std::forward<TArgs>(Args)...);
+    return TSharedPtr<T, Mode>(Controller->GetObject(), Controller);
+}
+
 template<typename T, typename... TArgs>
 static TSharedPtr<T> MakeSharedPtr(TArgs&&... Args)
 {
-    return TSharedPtr<T>(new T(std::forward<TArgs>(Args)...));
+    return MakeSharedPtrWithMode<T, ESharedPtrMode::ThreadSafe>(std::forward<TArgs>(Args)...);
 }
 
 template<typename T>
@@ -0,0 +1,318 @@
+﻿#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#include "Math/MathTypes.h"
+#include "Memory/Mem.h"
+
+struct SPoolStats
+{
+    uint32 NumSlabs = 0;
+
+    // Blocks carved out of all slabs.
+    uint32 Capacity = 0;
+
+    // Blocks currently handed out by the pool, including blocks parked in thread caches.
+    uint32 LiveBlocks = 0;
+
+    uint32 PeakLiveBlocks = 0;
+
+    inline float GetOccupancy() const
+    {
+        return Capacity > 0 ? static_cast<float>(LiveBlocks) / Capacity : 0.0f;
+    }
+};
+
+/*
+ * Fixed-size block allocator. Blocks are carved out of slabs and recycled through an intrusive free list,
+ * so allocation and release are O(1) and only reach the system allocator when a new slab is needed.
+ * Slabs are kept until the pool is destroyed.
+ */
+template<typename TObject, uint32 BlocksPerSlab = 64>
+class TPoolAllocator
+{
+private:
+    struct SFreeBlock
+    {
+        SFreeBlock* Next;
+    };
+
+    struct SSlab
+    {
+        SSlab* Next;
+    };
+
+    static constexpr size_t BlockAlignment = alignof(TObject) > alignof(SFreeBlock) ? alignof(TObject) : alignof(SFreeBlock);
+    static constexpr size_t BlockSize = ((sizeof(TObject) > sizeof(SFreeBlock) ? sizeof(TObject) : sizeof(SFreeBlock)) + BlockAlignment - 1) & ~(BlockAlignment - 1);
+    static constexpr size_t SlabHeaderSize = (sizeof(SSlab) + BlockAlignment - 1) & ~(BlockAlignment - 1);
+
+public:
+    TPoolAllocator() = default;
+
+    ~TPoolAllocator()
+    {
+        while (Slabs != nullptr)
+        {
+            SSlab* Next = Slabs->Next;
+            Mem::FreeAligned(Slabs);
+            Slabs = Next;
+        }
+    }
+
+    TPoolAllocator(const TPoolAllocator&) = delete;
+    TPoolAllocator& operator=(const TPoolAllocator&) = delete;
+
+    void* Allocate()
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        return AllocateLocked();
+    }
+
+    void Free(void* Block)
+    {
+        if (Block == nullptr)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> Lock(Mutex);
+        FreeLocked(Block);
+    }
+
+    // Fills Blocks with Count blocks under a single lock.
+    void AllocateBatch(void** Blocks, uint32 Count)
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        for (uint32 Index = 0; Index < Count; ++Index)
+        {
+            Blocks[Index] = AllocateLocked();
+        }
+    }
+
+    // Returns Count blocks under a single lock.
+    void FreeBatch(void* const* Blocks, uint32 Count)
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        for (uint32 Index = 0; Index < Count; ++Index)
+        {
+            FreeLocked(Blocks[Index]);
+        }
+    }
+
+    SPoolStats GetStats() const
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        return Stats;
+    }
+
+private:
+    void* AllocateLocked()
+    {
+        if (FreeList == nullptr)
+        {
+            AllocateSlab();
+        }
+
+        SFreeBlock* Block = FreeList;
+        FreeList = Block->Next;
+
+        if (++Stats.LiveBlocks > Stats.PeakLiveBlocks)
+        {
+            Stats.PeakLiveBlocks = Stats.LiveBlocks;
+        }
+        return Block;
+    }
+
+    void FreeLocked(void* Block)
+    {
+        SFreeBlock* FreeBlock = static_cast<SFreeBlock*>(Block);
+        FreeBlock->Next = FreeList;
+        FreeList = FreeBlock;
+
+        --Stats.LiveBlocks;
+    }
+
+    void AllocateSlab()
+    {
+        uint8* Memory = static_cast<uint8*>(Mem::MallocAligned(SlabHeaderSize + BlockSize * BlocksPerSlab, BlockAlignment));
+        if (Memory == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+
+        SSlab* Slab = reinterpret_cast<SSlab*>(Memory);
+        Slab->Next = Slabs;
+        Slabs = Slab;
+
+        // Thread the new blocks in address order so consecutive allocations stay adjacent in memory.
+        uint8* Blocks = Memory + SlabHeaderSize;
+        for (uint32 Index = BlocksPerSlab; Index > 0; --Index)
+        {
+            SFreeBlock* Block = reinterpret_cast<SFreeBlock*>(Blocks + (Index - 1) * BlockSize);
+            Block->Next = FreeList;
+            FreeList = Block;
+        }
+
+        Stats.NumSlabs++;
+        Stats.Capacity += BlocksPerSlab;
+    }
+
+    mutable std::mutex Mutex;
+
+    SFreeBlock* FreeList = nullptr;
+
+    SSlab* Slabs = nullptr;
+
+    SPoolStats Stats;
+};
+
+/*
+ * Process-wide pool of TObject. Each thread keeps a small cache of free blocks in front of the shared
+ * TPoolAllocator, so the common New/Delete path neither locks nor touches shared cache lines.
+ */
+template<typename TObject>
+class TObjectPool
+{
+private:
+    static constexpr uint32 ThreadCacheSize = 32;
+
+    using TAllocator = TPoolAllocator<TObject>;
+
+    // Trivially destructible, so it stays usable after the owner below has flushed it on thread exit.
+    struct SThreadCache
+    {
+        void* Blocks[ThreadCacheSize];
+
+        uint32 Count;
+
+        bool bRegistered;
+
+        bool bReleased;
+    };
+
+    struct SThreadCacheOwner
+    {
+        ~SThreadCacheOwner()
+        {
+            SThreadCache& Cache = GetThreadCache();
+            GetAllocator().FreeBatch(Cache.Blocks, Cache.Count);
+            Cache.Count = 0;
+            Cache.bReleased = true;
+        }
+    };
+
+public:
+    template<typename... TArgs>
+    static TObject* New(TArgs&&... Args)
+    {
+        return new (Allocate()) TObject(std::forward<TArgs>(Args)...);
+    }
+
+    static void Delete(TObject* Object)
+    {
+        if (Object == nullptr)
+        {
+            return;
+        }
+
+        Object->~TObject();
+        Free(Object);
+    }
+
+    static void* Allocate()
+    {
+        SThreadCache& Cache = GetThreadCache();
+        if (Cache.Count == 0)
+        {
+            // Slabs of the shared pool are never returned, keep them out of the leak report.
+            RK_PERSISTENT_ALLOCATIONS();
+
+            if (!RegisterThreadCache(Cache))
+            {
+                return GetAllocator().Allocate();
+            }
+
+            // Refill half of the cache so that alternating New/Delete does not bounce on the shared pool.
+            GetAllocator().AllocateBatch(Cache.Blocks, ThreadCacheSize / 2);
+            Cache.Count = ThreadCacheSize / 2;
+        }
+        return Cache.Blocks[--Cache.Count];
+    }
+
+    static void Free(void* Block)
+    {
+        SThreadCache& Cache = GetThreadCache();
+        if (!RegisterThreadCache(Cache))
+        {
+            GetAllocator().Free(Block);
+            return;
+        }
+
+        if (Cache.Count == ThreadCacheSize)
+        {
+            GetAllocator().FreeBatch(Cache.Blocks + ThreadCacheSize / 2, ThreadCacheSize / 2);
+            Cache.Count = ThreadCacheSize / 2;
+        }
+        Cache.Blocks[Cache.Count++] = Block;
+    }
+
+    static SPoolStats GetStats()
+    {
+        return GetAllocator().GetStats();
+    }
+
+private:
+    // Never destroyed, so objects released during static destruction still return to a valid pool.
+    static TAllocator& GetAllocator()
+    {
+        alignas(TAllocator) static uint8 Storage[sizeof(TAllocator)];
+        static TAllocator* Allocator = new (Storage) TAllocator();
+        return *Allocator;
+    }
+
+    static SThreadCache& GetThreadCache()
+    {
+        static thread_local SThreadCache Cache;
+        return Cache;
+    }
+
+    // Returns false once the cache has been flushed on thread exit.
+    static bool RegisterThreadCache(SThreadCache& Cache)
+    {
+        if (!Cache.bRegistered)
+        {
+            static thread_local SThreadCacheOwner Owner;
+            Cache.bRegistered = true;
+        }
+        return !Cache.bReleased;
+    }
+};
+
+/*
+ * Routes new/delete of TDerived through TObjectPool. Derived classes of a different size fall back to the
+ * global allocator, so deriving further from a pooled class stays safe.
+ */
+template<typename TDerived>
+class TPooledObject
+{
+public:
+    static void* operator new(size_t Size)
+    {
+        return Size == sizeof(TDerived) ? TObjectPool<TDerived>::Allocate() : ::operator new(Size);
+    }
+
+    static void operator delete(void* Pointer, size_t Size)
+    {
+        if (Size == sizeof(TDerived))
+        {
+            TObjectPool<TDerived>::Free(Pointer);
+        }
+        else
+        {
+            ::operator delete(Pointer);
+        }
+    }
+};
@@ -0,0 +1,2 @@
+#include "EnginePCH.h"
+#include "RingBuffer.h"
@@ -0,0 +1,383 @@
+#pragma once
+
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Core/Assert.h"
+#include "Math/MathTypes.h"
+#include "Memory/Mem.h"
+
+/*
+ * Bounded single-producer single-consumer queue. Push and pop are wait-free: each side owns one index and keeps
+ * a cached copy of the other, so the shared cache line is only read when the cached view says full or empty.
+ * Exactly one thread may push and exactly one thread may pop.
+ */
+template<typename TElement>
+class TSpscQueue
+{
+private:
+    // Producer side.
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> Tail { 0 };
+
+    size_t CachedHead = 0;
+
+    // Consumer side.
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> Head { 0 };
+
+    size_t CachedTail = 0;
+
+    // Shared, read only after construction.
+    alignas(CACHE_LINE_SIZE) TElement* Slots = nullptr;
+
+    size_t Mask = 0;
+
+public:
+    // Capacity must be a power of two.
+    explicit TSpscQueue(size_t Capacity)
+        : Mask(Capacity - 1)
+    {
+        RK_ENGINE_ASSERT(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Queue capacity must be a power of two.");
+
+        Slots = static_cast<TElement*>(Mem::MallocAligned(Capacity * sizeof(TElement), alignof(TElement) > CACHE_LINE_SIZE ? alignof(TElement) : CACHE_LINE_SIZE));
+        if (Slots == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+    }
+
+    ~TSpscQueue()
+    {
+        for (size_t Index = Head.load(std::memory_order_relaxed); Index != Tail.load(std::memory_order_relaxed); ++Index)
+        {
+            Slots[Index & Mask].~TElement();
+        }
+        Mem::FreeAligned(Slots);
+    }
+
+    TSpscQueue(const TSpscQueue&) = delete;
+    TSpscQueue& operator=(const TSpscQueue&) = delete;
+
+    // Producer only. Returns false when full.
+    template<typename... TArgs>
+    bool TryEmplace(TArgs&&... Args)
+    {
+        const size_t CurrentTail = Tail.load(std::memory_order_relaxed);
+        if (CurrentTail - CachedHead > Mask)
+        {
+            CachedHead = Head.load(std::memory_order_acquire);
+            if (CurrentTail - CachedHead > Mask)
+            {
+                return false;
+            }
+        }
+
+        new (Slots + (CurrentTail & Mask)) TElement(std::forward<TArgs>(Args)...);
+        Tail.store(CurrentTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPush(const TElement& Value)
+    {
+        return TryEmplace(Value);
+    }
+
+    bool TryPush(TElement&& Value)
+    {
+        return TryEmplace(std::move(Value));
+    }
+
+    // Producer only. Pushes as many of Values as fit with a single publish and returns how many were pushed.
+    size_t PushBatch(const TElement* Values, size_t Count)
+    {
+        const size_t CurrentTail = Tail.load(std::memory_order_relaxed);
+        size_t Free = Mask + 1 - (CurrentTail - CachedHead);
+        if (Free < Count)
+        {
+            CachedHead = Head.load(std::memory_order_acquire);
+            Free = Mask + 1 - (CurrentTail - CachedHead);
+        }
+
+        const size_t NumPushed = Count < Free ? Count : Free;
+        for (size_t Index = 0; Index < NumPushed; ++Index)
+        {
+            new (Slots + ((CurrentTail + Index) & Mask)) TElement(Values[Index]);
+        }
+
+        if (NumPushed > 0)
+        {
+            Tail.store(CurrentTail + NumPushed, std::memory_order_release);
+        }
+        return NumPushed;
+    }
+
+    // Consumer only. Returns false when empty.
+    bool TryPop(TElement& OutValue)
+    {
+        const size_t CurrentHead = Head.load(std::memory_order_relaxed);
+        if (CurrentHead == CachedTail)
+        {
+            CachedTail = Tail.load(std::memory_order_acquire);
+            if (CurrentHead == CachedTail)
+            {
+                return false;
+            }
+        }
+
+        TElement& Slot = Slots[CurrentHead & Mask];
+        OutValue = std::move(Slot);
+        Slot.~TElement();
+        Head.store(CurrentHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. Pops up to MaxCount values with a single release and returns how many were popped.
+    size_t PopBatch(TElement* OutValues, size_t MaxCount)
+    {
+        const size_t CurrentHead = Head.load(std::memory_order_relaxed);
+        size_t Available = CachedTail - CurrentHead;
+        if (Available < MaxCount)
+        {
+            CachedTail = Tail.load(std::memory_order_acquire);
+            Available = CachedTail - CurrentHead;
+        }
+
+        const size_t NumPopped = MaxCount < Available ? MaxCount : Available;
+        for (size_t Index = 0; Index < NumPopped; ++Index)
+        {
+            TElement& Slot = Slots[(CurrentHead + Index) & Mask];
+            OutValues[Index] = std::move(Slot);
+            Slot.~TElement();
+        }
+
+        if (NumPopped > 0)
+        {
+            Head.store(CurrentHead + NumPopped, std::memory_order_release);
+        }
+        return NumPopped;
+    }
+
+    // Approximate when called while the other side is active.
+    size_t GetSize() const
+    {
+        return Tail.load(std::memory_order_acquire) - Head.load(std::memory_order_acquire);
+    }
+
+    size_t GetCapacity() const
+    {
+        return Mask + 1;
+    }
+};
+
+/*
+ * Bounded multi-producer multi-consumer queue (Vyukov). Every cell carries a sequence number that tells whether
+ * it is free or filled for the current lap, so producers and consumers only contend on their own index and a
+ * failed push or pop never blocks. Lock-free, not wait-free.
+ */
+template<typename TElement>
+class TMpmcQueue
+{
+private:
+    struct SCell
+    {
+        std::atomic<size_t> Sequence;
+
+        alignas(TElement) uint8 Storage[sizeof(TElement)];
+
+        inline TElement* GetElement()
+        {
+            return reinterpret_cast<TElement*>(Storage);
+        }
+    };
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> EnqueuePosition { 0 };
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> DequeuePosition { 0 };
+
+    alignas(CACHE_LINE_SIZE) SCell* Cells = nullptr;
+
+    size_t Mask = 0;
+
+public:
+    // Capacity must be a power of two.
+    explicit TMpmcQueue(size_t Capacity)
+        : Mask(Capacity - 1)
+    {
+        RK_ENGINE_ASSERT(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Queue capacity must be a power of two.");
+
+        Cells = static_cast<SCell*>(Mem::MallocAligned(Capacity * sizeof(SCell), alignof(SCell) > CACHE_LINE_SIZE ? alignof(SCell) : CACHE_LINE_SIZE));
+        if (Cells == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+
+        for (size_t Index = 0; Index < Capacity; ++Index)
+        {
+            new (&Cells[Index].Sequence) std::atomic<size_t>(Index);
+        }
+    }
+
+    ~TMpmcQueue()
+    {
+        for (size_t Index = DequeuePosition.load(std::memory_order_relaxed); Index != EnqueuePosition.load(std::memory_order_relaxed); ++Index)
+        {
+            Cells[Index & Mask].GetElement()->~TElement();
+        }
+        Mem::FreeAligned(Cells);
+    }
+
+    TMpmcQueue(const TMpmcQueue&) = delete;
+    TMpmcQueue& operator=(const TMpmcQueue&) = delete;
+
+    // Returns false when full.
+    template<typename... TArgs>
+    bool TryEmplace(TArgs&&... Args)
+    {
+        size_t Position = EnqueuePosition.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            SCell& Cell = Cells[Position & Mask];
+            const size_t Sequence = Cell.Sequence.load(std::memory_order_acquire);
+            const intptr_t Difference = static_cast<intptr_t>(Sequence) - static_cast<intptr_t>(Position);
+
+            if (Difference == 0)
+            {
+                if (EnqueuePosition.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed))
+                {
+                    new (Cell.Storage) TElement(std::forward<TArgs>(Args)...);
+                    Cell.Sequence.store(Position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (Difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                Position = EnqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool TryPush(const TElement& Value)
+    {
+        return TryEmplace(Value);
+    }
+
+    bool TryPush(TElement&& Value)
+    {
+        return TryEmplace(std::move(Value));
+    }
+
+    // Claims a run of free cells with a single CAS. Returns how many of Values were pushed.
+    size_t PushBatch(const TElement* Values, size_t Count)
+    {
+        size_t Position = EnqueuePosition.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            // A free cell stays free until its position is claimed, so the run counted here is still free if the CAS wins.
+            size_t NumFree = 0;
+            while (NumFree < Count && NumFree <= Mask && Cells[(Position + NumFree) & Mask].Sequence.load(std::memory_order_acquire) == Position + NumFree)
+            {
+                ++NumFree;
+            }
+
+            if (NumFree == 0)
+            {
+                const size_t Sequence = Cells[Position & Mask].Sequence.load(std::memory_order_acquire);
+                if (static_cast<intptr_t>(Sequence) - static_cast<intptr_t>(Position) < 0)
+                {
+                    return 0;
+                }
+                Position = EnqueuePosition.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            if (EnqueuePosition.compare_exchange_weak(Position, Position + NumFree, std::memory_order_relaxed))
+            {
+                for (size_t Index = 0; Index < NumFree; ++Index)
+                {
+                    SCell& Cell = Cells[(Position + Index) & Mask];
+                    new (Cell.Storage) TElement(Values[Index]);
+                    Cell.Sequence.store(Position + Index + 1, std::memory_order_release);
+                }
+                return NumFree;
+            }
+        }
+    }
+
+    // Returns false when empty.
+    bool TryPop(TElement& OutValue)
+    {
+        size_t Position = DequeuePosition.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            SCell& Cell = Cells[Position & Mask];
+            const size_t Sequence = Cell.Sequence.load(std::memory_order_acquire);
+            const intptr_t Difference = static_cast<intptr_t>(Sequence) - static_cast<intptr_t>(Position + 1);
+
+            if (Difference == 0)
+            {
+                if (DequeuePosition.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed))
+                {
+                    OutValue = std::move(*Cell.GetElement());
+                    Cell.GetElement()->~TElement();
+                    Cell.Sequence.store(Position + Mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (Difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                Position = DequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Claims a run of filled cells with a single CAS. Returns how many values were popped.
+    size_t PopBatch(TElement* OutValues, size_t MaxCount)
+    {
+        size_t Position = DequeuePosition.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            size_t NumFilled = 0;
+            while (NumFilled < MaxCount && NumFilled <= Mask && Cells[(Position + NumFilled) & Mask].Sequence.load(std::memory_order_acquire) == Position + NumFilled + 1)
+            {
+                ++NumFilled;
+            }
+
+            if (NumFilled == 0)
+            {
+                const size_t Sequence = Cells[Position & Mask].Sequence.load(std::memory_order_acquire);
+                if (static_cast<intptr_t>(Sequence) - static_cast<intptr_t>(Position + 1) < 0)
+                {
+                    return 0;
+                }
+                Position = DequeuePosition.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            if (DequeuePosition.compare_exchange_weak(Position, Position + NumFilled, std::memory_order_relaxed))
+            {
+                for (size_t Index = 0; Index < NumFilled; ++Index)
+                {
+                    SCell& Cell = Cells[(Position + Index) & Mask];
+                    OutValues[Index] = std::move(*Cell.GetElement());
+                    Cell.GetElement()->~TElement();
+                    Cell.Sequence.store(Position + Index + Mask + 1, std::memory_order_release);
+                }
+                return NumFilled;
+            }
+        }
+    }
+
+    size_t GetCapacity() const
+    {
+        return Mask + 1;
+    }
+};
@@ -0,0 +1,113 @@
+#include "EnginePCH.h"
+#include "StackAllocator.h"
+
+#include <cstdlib>
+
+#include "Core/Assert.h"
+#include "Memory/Mem.h"
+
+namespace Utils
+{
+    static inline uintptr_t AlignUp(uintptr_t Value, size_t Alignment)
+    {
+        return (Value + (Alignment - 1)) & ~(static_cast<uintptr_t>(Alignment) - 1);
+    }
+}
+
+CStackAllocator::CStackAllocator(size_t InCapacity)
+{
+    Init(InCapacity);
+}
+
+CStackAllocator::~CStackAllocator()
+{
+    Destroy();
+}
+
+void CStackAllocator::Init(size_t InCapacity)
+{
+    Destroy();
+
+    Data = static_cast<uint8*>(Mem::MallocAligned(InCapacity, CACHE_LINE_SIZE));
+    RK_ENGINE_ASSERT(Data, "Failed to allocate stack allocator.");
+    Capacity = InCapacity;
+}
+
+void CStackAllocator::Destroy()
+{
+    FreeToMarker(SMarker { 0, 0, nullptr });
+
+    Mem::FreeAligned(Data);
+    Data = nullptr;
+    Capacity = 0;
+    HighWaterMark = 0;
+}
+
+void* CStackAllocator::Allocate(size_t Size, size_t Alignment)
+{
+    RK_ENGINE_ASSERT((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two.");
+
+    const uintptr_t Base = reinterpret_cast<uintptr_t>(Data);
+    const uintptr_t Aligned = Utils::AlignUp(Base + Offset, Alignment);
+    const size_t NewOffset = static_cast<size_t>(Aligned - Base) + Size;
+
+    if (Data == nullptr || NewOffset > Capacity)
+    {
+        return AllocateOverflow(Size, Alignment);
+    }
+
+    Offset = NewOffset;
+    if (Offset + OverflowSize > HighWaterMark)
+    {
+        HighWaterMark = Offset + OverflowSize;
+    }
+    return reinterpret_cast<void*>(Aligned);
+}
+
+void CStackAllocator::Free(void* Block, size_t Size)
+{
+    uint8* Bytes = static_cast<uint8*>(Block);
+    if (Data != nullptr && Bytes >= Data && Bytes + Size == Data + Offset)
+    {
+        Offset = static_cast<size_t>(Bytes - Data);
+    }
+}
+
+void* CStackAllocator::AllocateOverflow(size_t Size, size_t Alignment)
+{
+    // The chunk header is followed by enough slack to align the user block.
+    const size_t ChunkSize = sizeof(SOverflowChunk) + Alignment + Size;
+    SOverflowChunk* Chunk = static_cast<SOverflowChunk*>(std::malloc(ChunkSize));
+    RK_ENGINE_ASSERT(Chunk, "Failed to allocate stack allocator overflow chunk.");
+
+    Chunk->Next = OverflowChunks;
+    OverflowChunks = Chunk;
+    OverflowSize += ChunkSize;
+
+    if (Offset + OverflowSize > HighWaterMark)
+    {
+        HighWaterMark = Offset + OverflowSize;
+    }
+    return reinterpret_cast<void*>(Utils::AlignUp(reinterpret_cast<uintptr_t>(Chunk + 1), Alignment));
+}
+
+void CStackAllocator::FreeToMarker(const SMarker& Marker)
+{
+    while (OverflowChunks != Marker.OverflowChunks)
+    {
+        RK_ENGINE_ASSERT(OverflowChunks, "Stack marker does not belong to this allocator.");
+
+        SOverflowChunk* Next = OverflowChunks->Next;
+        std::free(OverflowChunks);
+        OverflowChunks = Next;
+    }
+
+    Offset = Marker.Offset;
+    OverflowSize = Marker.OverflowSize;
+}
+
+CStackAllocator& CStackAllocator::GetThreadStack()
+{
+    thread_local CStackAllocator ThreadStack(DefaultThreadStackSize);
+    return ThreadStack;
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Math/MathTypes.h"
+
+/*
+ * LIFO scratch allocator over a single contiguous block. A marker captures the current top and FreeToMarker
+ * releases everything allocated after it in one step, so short-lived data in loaders and one-shot passes never
+ * touches the general heap. Freeing the most recent allocation pops it, any other Free is deferred to the marker.
+ *
+ * Allocations that do not fit are served from heap overflow chunks that are released by the rollback that covers
+ * them. Not thread safe, use GetThreadStack() for a per-thread instance.
+ */
+class CStackAllocator
+{
+private:
+    struct SOverflowChunk
+    {
+        SOverflowChunk* Next;
+    };
+
+public:
+    struct SMarker
+    {
+        size_t Offset;
+
+        size_t OverflowSize;
+
+        SOverflowChunk* OverflowChunks;
+    };
+
+    static constexpr size_t DefaultThreadStackSize = 256 * 1024;
+
+    CStackAllocator() = default;
+    explicit CStackAllocator(size_t InCapacity);
+    ~CStackAllocator();
+
+    CStackAllocator(const CStackAllocator&) = delete;
+    CStackAllocator& operator=(const CStackAllocator&) = delete;
+
+    void Init(size_t InCapacity);
+    void Destroy();
+
+    void* Allocate(size_t Size, size_t Alignment = alignof(std::max_align_t));
+
+    // Pops Block if it is the most recent allocation, otherwise its memory is reclaimed by the enclosing rollback.
+    void Free(void* Block, size_t Size);
+
+    inline SMarker GetMarker() const
+    {
+        return SMarker { Offset, OverflowSize, OverflowChunks };
+    }
+
+    // Releases every allocation made since Marker was taken. Nested markers must be rolled back innermost first.
+    void FreeToMarker(const SMarker& Marker);
+
+    inline size_t GetCapacity() const { return Capacity; }
+    inline size_t GetUsed() const { return Offset; }
+    inline size_t GetOverflowSize() const { return OverflowSize; }
+    inline size_t GetHighWaterMark() const { return HighWaterMark; }
+
+    // Scratch stack of the calling thread, created with DefaultThreadStackSize on first use.
+    static CStackAllocator& GetThreadStack();
+
+private:
+    void* AllocateOverflow(size_t Size, size_t Alignment);
+
+    uint8* Data = nullptr;
+
+    size_t Capacity = 0;
+
+    size_t Offset = 0;
+
+    size_t OverflowSize = 0;
+
+    size_t HighWaterMark = 0;
+
+    SOverflowChunk* OverflowChunks = nullptr;
+};
+
+/* Rolls the stack back to where it was when the scope was entered. */
+struct SStackScope
+{
+    SStackScope(CStackAllocator& InStack)
+        : Stack(InStack), Marker(InStack.GetMarker())
+    {
+    }
+
+    ~SStackScope()
+    {
+        Stack.FreeToMarker(Marker);
+    }
+
+    SStackScope(const SStackScope&) = delete;
+    SStackScope& operator=(const SStackScope&) = delete;
+
+private:
+    CStackAllocator& Stack;
+
+    CStackAllocator::SMarker Marker;
+};
+
+/*
+ * Binds Name to this thread's scratch stack and rolls it back at the end of the enclosing scope. Containers using
+ * the stack must be declared after the macro so they are destroyed before the rollback.
+ */
+#define RK_SCOPED_STACK(Name) CStackAllocator& Name = CStackAllocator::GetThreadStack(); SStackScope Name##Scope(Name)
+
+/* Container allocator drawing from a stack allocator, e.g. TArray<T, SStackAllocator>. */
+struct SStackAllocator
+{
+    CStackAllocator* Stack = nullptr;
+
+    SStackAllocator() = default;
+
+    SStackAllocator(CStackAllocator& InStack)
+        : Stack(&InStack)
+    {
+    }
+
+    inline void* Allocate(size_t Size, size_t Alignment)
+    {
+        return Stack->Allocate(Size, Alignment);
+    }
+
+    inline void Free(void* Block, size_t Size)
+    {
+        Stack->Free(Block, Size);
+    }
+};
+
+/* Standard library allocator adapter, e.g. std::vector<T, TStdStackAllocator<T>>. */
+template<typename TElement>
+struct TStdStackAllocator
+{
+    using value_type = TElement;
+
+    CStackAllocator* Stack;
+
+    TStdStackAllocator(CStackAllocator& InStack)
+        : Stack(&InStack)
+    {
+    }
+
+    template<typename TOther>
+    TStdStackAllocator(const TStdStackAllocator<TOther>& Other)
+        : Stack(Other.Stack)
+    {
+    }
+
+    inline TElement* allocate(size_t Count)
+    {
+        return static_cast<TElement*>(Stack->Allocate(Count * sizeof(TElement), alignof(TElement)));
+    }
+
+    inline void deallocate(TElement* Block, size_t Count)
+    {
+        Stack->Free(Block, Count * sizeof(TElement));
+    }
+
+    template<typename TOther>
+    bool operator==(const TStdStackAllocator<TOther>& Other) const { return Stack == Other.Stack; }
+
+    template<typename TOther>
+    bool operator!=(const TStdStackAllocator<TOther>& Other) const { return Stack != Other.Stack; }
+};
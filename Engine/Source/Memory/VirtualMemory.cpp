@@ -0,0 +1,104 @@
+#include "EnginePCH.h"
+#include "VirtualMemory.h"
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <Windows.h>
+#else
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+namespace
+{
+    // Default huge page size on x86-64 and most ARM64 kernels.
+    constexpr size_t DefaultHugePageSize = 2 * 1024 * 1024;
+}
+
+size_t VirtualMemory::GetPageSize()
+{
+#ifdef _WIN32
+    static const size_t PageSize = []
+    {
+        SYSTEM_INFO Info;
+        GetSystemInfo(&Info);
+        return static_cast<size_t>(Info.dwPageSize);
+    }();
+#else
+    static const size_t PageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    return PageSize;
+}
+
+size_t VirtualMemory::GetHugePageSize()
+{
+    return DefaultHugePageSize;
+}
+
+void* VirtualMemory::Reserve(size_t Size, EHugePages HugePages)
+{
+#ifdef _WIN32
+    // Reservations are made at allocation granularity (64 KB), which every commit granularity here is a multiple of.
+    return VirtualAlloc(nullptr, Size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+    const int32 Flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+#ifdef MAP_HUGETLB
+    if (HugePages == EHugePages::Explicit)
+    {
+        // Without MAP_NORESERVE the whole range is reserved from the huge page pool here, so an undersized pool
+        // fails now and falls back instead of raising SIGBUS on first touch.
+        void* Address = mmap(nullptr, Size, PROT_NONE, Flags | MAP_HUGETLB, -1, 0);
+        if (Address != MAP_FAILED)
+        {
+            return Address;
+        }
+    }
+#endif
+
+    void* Address = mmap(nullptr, Size, PROT_NONE, Flags | MAP_NORESERVE, -1, 0);
+    if (Address == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (HugePages != EHugePages::None)
+    {
+        madvise(Address, Size, MADV_HUGEPAGE);
+    }
+#endif
+    return Address;
+#endif
+}
+
+bool VirtualMemory::Commit(void* Address, size_t Size)
+{
+#ifdef _WIN32
+    return VirtualAlloc(Address, Size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+    return mprotect(Address, Size, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+void VirtualMemory::Decommit(void* Address, size_t Size)
+{
+#ifdef _WIN32
+    VirtualFree(Address, Size, MEM_DECOMMIT);
+#else
+    // Drop the pages first so the range reads back as zero if it is committed again.
+    madvise(Address, Size, MADV_DONTNEED);
+    mprotect(Address, Size, PROT_NONE);
+#endif
+}
+
+void VirtualMemory::Release(void* Address, size_t Size)
+{
+#ifdef _WIN32
+    VirtualFree(Address, 0, MEM_RELEASE);
+#else
+    munmap(Address, Size);
+#endif
+}
@@ -0,0 +1,291 @@
+#pragma once
+
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include "Core/Assert.h"
+#include "Math/MathTypes.h"
+#include "Memory/Memory.h"
+
+enum class EHugePages : uint8
+{
+    None,
+
+    // Ask the kernel to back the range with huge pages where it can (Linux THP). Ignored on Windows.
+    Transparent,
+
+    // Map the range from the explicit huge page pool (Linux hugetlbfs). The pool must hold the whole reservation,
+    // otherwise this falls back to Transparent.
+    // Windows large pages must be committed all at once, which defeats incremental commit, so they are not used.
+    Explicit
+};
+
+/* Thin wrapper over the OS virtual memory API. Sizes and addresses must be multiples of GetPageSize(). */
+namespace VirtualMemory
+{
+    size_t GetPageSize();
+    size_t GetHugePageSize();
+
+    // Reserves address space without backing it. Returns nullptr on failure.
+    void* Reserve(size_t Size, EHugePages HugePages = EHugePages::None);
+
+    // Backs part of a reserved range with zeroed memory. Returns false on failure.
+    bool Commit(void* Address, size_t Size);
+
+    // Returns the physical pages to the OS, the range stays reserved.
+    void Decommit(void* Address, size_t Size);
+
+    void Release(void* Address, size_t Size);
+
+    inline size_t RoundUp(size_t Size, size_t Granularity)
+    {
+        return (Size + Granularity - 1) / Granularity * Granularity;
+    }
+}
+
+/*
+ * Array over a virtual range reserved up front for MaxElements. Pages are committed as the array grows, so growth
+ * never reallocates or copies and element addresses stay stable for the lifetime of the array. Only committed
+ * pages use physical memory, reserving generously is cheap.
+ */
+template<typename TElement>
+class TVirtualArray
+{
+private:
+    TElement* Data = nullptr;
+
+    size_t Size = 0;
+
+    // Elements that fit in the committed pages.
+    size_t Capacity = 0;
+
+    size_t ReservedBytes = 0;
+
+    size_t CommittedBytes = 0;
+
+    size_t CommitGranularity = 0;
+
+public:
+    TVirtualArray() = default;
+
+    explicit TVirtualArray(size_t MaxElements, EHugePages HugePages = EHugePages::None)
+    {
+        Init(MaxElements, HugePages);
+    }
+
+    TVirtualArray(TVirtualArray&& Other) noexcept
+    {
+        *this = std::move(Other);
+    }
+
+    ~TVirtualArray()
+    {
+        Destroy();
+    }
+
+    TVirtualArray(const TVirtualArray&) = delete;
+    TVirtualArray& operator=(const TVirtualArray&) = delete;
+
+    TVirtualArray& operator=(TVirtualArray&& Other) noexcept
+    {
+        if (this != &Other)
+        {
+            Destroy();
+            std::swap(Data, Other.Data);
+            std::swap(Size, Other.Size);
+            std::swap(Capacity, Other.Capacity);
+            std::swap(ReservedBytes, Other.ReservedBytes);
+            std::swap(CommittedBytes, Other.CommittedBytes);
+            std::swap(CommitGranularity, Other.CommitGranularity);
+        }
+        return *this;
+    }
+
+    void Init(size_t MaxElements, EHugePages HugePages = EHugePages::None)
+    {
+        Destroy();
+
+        // Huge pages are committed a whole page at a time, otherwise commit in 64 KB steps to keep syscalls rare.
+        CommitGranularity = HugePages != EHugePages::None ? VirtualMemory::GetHugePageSize() : VirtualMemory::RoundUp(64 * 1024, VirtualMemory::GetPageSize());
+
+        // A wrapped byte count would reserve a small range that later commits run past.
+        RK_ENGINE_ASSERT(MaxElements <= (SIZE_MAX - CommitGranularity) / sizeof(TElement), "TVirtualArray reservation overflows the address space.");
+        if (MaxElements > (SIZE_MAX - CommitGranularity) / sizeof(TElement))
+        {
+            throw std::bad_alloc();
+        }
+        ReservedBytes = VirtualMemory::RoundUp(MaxElements * sizeof(TElement), CommitGranularity);
+
+        Data = static_cast<TElement*>(VirtualMemory::Reserve(ReservedBytes, HugePages));
+        if (Data == nullptr)
+        {
+            ReservedBytes = 0;
+            throw std::bad_alloc();
+        }
+    }
+
+    void Destroy()
+    {
+        if (Data != nullptr)
+        {
+            DestructElements(Data, Size);
+            VirtualMemory::Release(Data, ReservedBytes);
+        }
+
+        Data = nullptr;
+        Size = 0;
+        Capacity = 0;
+        ReservedBytes = 0;
+        CommittedBytes = 0;
+    }
+
+    TElement& operator[](size_t Index)
+    {
+        if (Index >= Size) throw std::out_of_range("Index is out of range.");
+        return Data[Index];
+    }
+
+    const TElement& operator[](size_t Index) const
+    {
+        if (Index >= Size) throw std::out_of_range("Index is out of range.");
+        return Data[Index];
+    }
+
+    TElement* begin() { return Data; }
+    TElement* end() { return Data + Size; }
+
+    const TElement* begin() const { return Data; }
+    const TElement* end() const { return Data + Size; }
+
+    operator TArrayView<TElement>() const
+    {
+        return TArrayView<TElement>(Data, Size);
+    }
+
+public:
+    // Commits pages for NumElements up front.
+    void Reserve(size_t NumElements)
+    {
+        if (NumElements > Capacity)
+        {
+            CommitBytes(NumElements * sizeof(TElement));
+        }
+    }
+
+    void Push(const TElement& Value)
+    {
+        Emplace(Value);
+    }
+
+    void Push(TElement&& Value)
+    {
+        Emplace(std::move(Value));
+    }
+
+    template<typename... TArgs>
+    TElement& Emplace(TArgs&&... Args)
+    {
+        if (Size == Capacity)
+        {
+            CommitBytes((Size + 1) * sizeof(TElement));
+        }
+        return *new (Data + Size++) TElement(std::forward<TArgs>(Args)...);
+    }
+
+    TElement Pop()
+    {
+        if (Size == 0)
+        {
+            return TElement();
+        }
+
+        TElement Value = std::move(Data[Size - 1]);
+        Data[--Size].~TElement();
+        return Value;
+    }
+
+    void RemoveAtSwap(size_t Index)
+    {
+        if (Index >= Size) throw std::out_of_range("Index is out of range.");
+
+        Data[Index].~TElement();
+        if (Index != --Size)
+        {
+            RelocateElements(Data + Index, Data + Size, 1);
+        }
+    }
+
+    // Destroys all elements, committed pages are kept for reuse.
+    void Empty()
+    {
+        DestructElements(Data, Size);
+        Size = 0;
+    }
+
+    // Returns committed pages beyond the current size to the OS.
+    void Shrink()
+    {
+        const size_t NeededBytes = VirtualMemory::RoundUp(Size * sizeof(TElement), CommitGranularity);
+        if (NeededBytes < CommittedBytes)
+        {
+            VirtualMemory::Decommit(reinterpret_cast<uint8*>(Data) + NeededBytes, CommittedBytes - NeededBytes);
+            CommittedBytes = NeededBytes;
+            Capacity = CommittedBytes / sizeof(TElement);
+        }
+    }
+
+    inline size_t GetSize() const
+    {
+        return Size;
+    }
+
+    inline size_t GetCapacity() const
+    {
+        return Capacity;
+    }
+
+    inline size_t GetMaxSize() const
+    {
+        return ReservedBytes / sizeof(TElement);
+    }
+
+    inline size_t GetCommittedBytes() const
+    {
+        return CommittedBytes;
+    }
+
+    inline bool IsEmpty() const
+    {
+        return Size == 0;
+    }
+
+    inline TElement* GetData()
+    {
+        return Data;
+    }
+
+    inline const TElement* GetData() const
+    {
+        return Data;
+    }
+
+private:
+    void CommitBytes(size_t NeededBytes)
+    {
+        const size_t NewCommittedBytes = VirtualMemory::RoundUp(NeededBytes, CommitGranularity);
+        if (Data == nullptr || NewCommittedBytes > ReservedBytes)
+        {
+            throw std::length_error("TVirtualArray exceeded its reserved range.");
+        }
+
+        if (!VirtualMemory::Commit(reinterpret_cast<uint8*>(Data) + CommittedBytes, NewCommittedBytes - CommittedBytes))
+        {
+            throw std::bad_alloc();
+        }
+
+        CommittedBytes = NewCommittedBytes;
+        Capacity = CommittedBytes / sizeof(TElement);
+    }
+};
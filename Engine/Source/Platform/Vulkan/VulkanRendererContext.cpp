@@ -5,7 +5,7 @@
 
 #include <cassert>
 #include <stdexcept>
-#include <set>
+#include <cstring>
 #include <GLFW/glfw3.h>
 #include <GLFW/glfw3native.h>
 #include <vulkan/vulkan_core.h>
@@ -16,6 +16,7 @@
 #include "Math/Math.h"
 #include "Renderer/Shader.h"
 #include "Memory/Mem.h"
+#include "Memory/StackAllocator.h"
 
 std::vector<RkVertex> Vertices = {
 	{{0.0f, -0.5f}, {1.0f, 0.0f, 0.0f}},
@@ -63,7 +64,7 @@ VKAPI_ATTR VkBool32 VKAPI_CALL RkVulkanRendererContext::DebugCallback(VkDebugUti
     return VK_FALSE;
 }
 
-VkSurfaceFormatKHR RkVulkanRendererContext::SelectSwapchainSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& Formats)
+VkSurfaceFormatKHR RkVulkanRendererContext::SelectSwapchainSurfaceFormat(const TArrayView<VkSurfaceFormatKHR>& Formats)
 {
     for (const auto& Format : Formats)
     {
@@ -76,7 +77,7 @@ VkSurfaceFormatKHR RkVulkanRendererContext::SelectSwapchainSurfaceFormat(const s
     return Formats[0];
 }
 
-VkPresentModeKHR RkVulkanRendererContext::SelectSwapchainPresentMode(const std::vector<VkPresentModeKHR>& PresentModes)
+VkPresentModeKHR RkVulkanRendererContext::SelectSwapchainPresentMode(const TArrayView<VkPresentModeKHR>& PresentModes)
 {
     for (const auto& PresentMode : PresentModes)
     {
@@ -165,6 +166,8 @@ bool RkValidationLayer::IsSupported()
 
 void RkVulkanRendererContext::Init()
 {
+    RK_MEMORY_SCOPE(Renderer);
+
     ValidationLayers.push_back(RkValidationLayer("VK_LAYER_KHRONOS_validation"));
 
     CreateInstance();
@@ -241,13 +244,13 @@ void RkVulkanRendererContext::CreateInstance()
 
     VkDebugUtilsMessengerCreateInfoEXT DebugCreateInfo{};
 
-    std::vector<const char*> Result;
+    TInlineArray<const char*, 4> Result;
     for (auto& ValidationLayer : ValidationLayers)
     {
-        Result.emplace_back(ValidationLayer.Name);
+        Result.Emplace(ValidationLayer.Name);
     }
-    CreateInfo.enabledLayerCount = Result.size();
-    CreateInfo.ppEnabledLayerNames = Result.data();
+    CreateInfo.enabledLayerCount = static_cast<uint32>(Result.GetSize());
+    CreateInfo.ppEnabledLayerNames = Result.GetData();
 
     DebugCreateInfo = CreateDebugMessengerCreateInfo();
     CreateInfo.pNext = (VkDebugUtilsMessengerCreateInfoEXT*)&DebugCreateInfo;
@@ -297,9 +300,13 @@ void RkVulkanRendererContext::CreateLogicalDevice()
 {
     RkQueueFamilyIndices QueueFamilyIndices = RequestQueueFamilies(PhysicalDevice);
 
-    std::vector<VkDeviceQueueCreateInfo> QueueCreateInfos;
-    std::set<uint32> UniqueQueueFamilies { QueueFamilyIndices.GraphicsFamily.value(), QueueFamilyIndices.PresentFamily.value() };
-    
+    TInlineArray<VkDeviceQueueCreateInfo, 2> QueueCreateInfos;
+    TInlineArray<uint32, 2> UniqueQueueFamilies { QueueFamilyIndices.GraphicsFamily.value() };
+    if (!UniqueQueueFamilies.Contains(QueueFamilyIndices.PresentFamily.value()))
+    {
+        UniqueQueueFamilies.Push(QueueFamilyIndices.PresentFamily.value());
+    }
+
     float QueuePriority = 1.0f;
     for (uint32 Idx : UniqueQueueFamilies)
     {
@@ -308,26 +315,26 @@ void RkVulkanRendererContext::CreateLogicalDevice()
         QueueCreateInfo.queueFamilyIndex = Idx;
         QueueCreateInfo.queueCount = 1;
         QueueCreateInfo.pQueuePriorities = &QueuePriority;
-        QueueCreateInfos.push_back(QueueCreateInfo);
+        QueueCreateInfos.Push(QueueCreateInfo);
     }
 
     VkPhysicalDeviceFeatures DeviceFeatures{};
 
     VkDeviceCreateInfo CreateInfo{};
     CreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-    CreateInfo.pQueueCreateInfos = QueueCreateInfos.data();
-    CreateInfo.queueCreateInfoCount = static_cast<uint32>(QueueCreateInfos.size());
+    CreateInfo.pQueueCreateInfos = QueueCreateInfos.GetData();
+    CreateInfo.queueCreateInfoCount = static_cast<uint32>(QueueCreateInfos.GetSize());
     CreateInfo.pEnabledFeatures = &DeviceFeatures;
     CreateInfo.enabledExtensionCount = static_cast<uint32>(Extensions.size());
     CreateInfo.ppEnabledExtensionNames = Extensions.data();
 
-    std::vector<const char*> Result;
+    TInlineArray<const char*, 4> Result;
     for (auto& ValidationLayer : ValidationLayers)
     {
-        Result.emplace_back(ValidationLayer.Name);
+        Result.Emplace(ValidationLayer.Name);
     }
-    CreateInfo.enabledLayerCount = static_cast<uint32>(Result.size());
-    CreateInfo.ppEnabledLayerNames = Result.data();
+    CreateInfo.enabledLayerCount = static_cast<uint32>(Result.GetSize());
+    CreateInfo.ppEnabledLayerNames = Result.GetData();
 
     VkResult CreateLogicalDeviceResult = vkCreateDevice(PhysicalDevice, &CreateInfo, nullptr, &LogicalDevice);
     RK_ENGINE_ASSERT(CreateLogicalDeviceResult == VK_SUCCESS, "Failed to create logical device.");
@@ -552,8 +559,8 @@ void RkVulkanRendererContext::CreateRenderPipeline()
 
     // TODO: This is just for testing!
     RkShader Shader;
-    Shader.Compile(RK_SHADERTYPE_VERTEXSHADER, L"../Shaders/SimpleShaderVert.hlsl", L"main", "vs_6_0");
-    Shader.Compile(RK_SHADERTYPE_FRAGMENTSHADER, L"../Shaders/SimpleShaderFrag.hlsl", L"main", "ps_6_0");
+    Shader.Compile(RK_SHADERTYPE_VERTEXSHADER, RK_NAME("../Shaders/SimpleShaderVert.hlsl"), RK_NAME("main"), RK_NAME("vs_6_0"));
+    Shader.Compile(RK_SHADERTYPE_FRAGMENTSHADER, RK_NAME("../Shaders/SimpleShaderFrag.hlsl"), RK_NAME("main"), RK_NAME("ps_6_0"));
 
     // Copy shader create info seperate vector
     std::vector<VkPipelineShaderStageCreateInfo> ShaderStageCreateInfos(Shader.ShaderPrograms.size());
@@ -633,7 +640,7 @@ void RkVulkanRendererContext::CreateBuffers()
 
     void* Data;
     vkMapMemory(GetLogicalDevice(), VertexBufferMemory, 0, BufferInfo.size, 0, &Data);
-    memcpy(Data, Vertices.data(), (size_t)BufferInfo.size);
+    Mem::MemcpyStreaming(Data, Vertices.data(), (size_t)BufferInfo.size);
     vkUnmapMemory(GetLogicalDevice(), VertexBufferMemory);
 
     // We will be recording a command buffer every frame, so we want to be able to reset and rerecord over it.
@@ -693,6 +700,8 @@ void RkVulkanRendererContext::CreateSynchronizationObjects()
 
 void RkVulkanRendererContext::RegenerateSwapchain()
 {
+    RK_MEMORY_SCOPE(Renderer);
+
     vkDeviceWaitIdle(GetLogicalDevice());
 
     while (GetWindow()->IsMinimized())
@@ -727,16 +736,16 @@ RkSwapChainSupportDetails RkVulkanRendererContext::RequestSwapchainSupportDetail
 
     if (FormatCount != 0)
     {
-        SwapChainSupportDetails.Formats.resize(FormatCount);
-        vkGetPhysicalDeviceSurfaceFormatsKHR(PhysicalDevice, SurfaceInterface, &FormatCount, SwapChainSupportDetails.Formats.data());
+        SwapChainSupportDetails.Formats.Resize(FormatCount);
+        vkGetPhysicalDeviceSurfaceFormatsKHR(PhysicalDevice, SurfaceInterface, &FormatCount, SwapChainSupportDetails.Formats.GetData());
     }
 
     uint32 PresentModeCount;
-    vkGetPhysicalDeviceSurfacePresentModesKHR(PhysicalDevice, SurfaceInterface, &PresentModeCount, SwapChainSupportDetails.PresentMode.data());
+    vkGetPhysicalDeviceSurfacePresentModesKHR(PhysicalDevice, SurfaceInterface, &PresentModeCount, nullptr);
     if (PresentModeCount != 0)
     {
-        SwapChainSupportDetails.PresentMode.resize(PresentModeCount);
-        vkGetPhysicalDeviceSurfacePresentModesKHR(PhysicalDevice, SurfaceInterface, &PresentModeCount, SwapChainSupportDetails.PresentMode.data());
+        SwapChainSupportDetails.PresentMode.Resize(PresentModeCount);
+        vkGetPhysicalDeviceSurfacePresentModesKHR(PhysicalDevice, SurfaceInterface, &PresentModeCount, SwapChainSupportDetails.PresentMode.GetData());
     }
     return SwapChainSupportDetails;
 }
@@ -779,25 +788,36 @@ bool RkVulkanRendererContext::IsVulkanCapableDevice(VkPhysicalDevice PhysicalDev
 {
     RkQueueFamilyIndices Indices = RequestQueueFamilies(PhysicalDevice);
 
+    RK_SCOPED_STACK(Stack);
+
     uint32 ExtensionCount;
     vkEnumerateDeviceExtensionProperties(PhysicalDevice, nullptr, &ExtensionCount, nullptr);
 
-    std::vector<VkExtensionProperties> AvailableExtensions(ExtensionCount);
-    vkEnumerateDeviceExtensionProperties(PhysicalDevice, nullptr, &ExtensionCount, AvailableExtensions.data());
+    TArray<VkExtensionProperties, SStackAllocator> AvailableExtensions(Stack);
+    AvailableExtensions.Resize(ExtensionCount);
+    vkEnumerateDeviceExtensionProperties(PhysicalDevice, nullptr, &ExtensionCount, AvailableExtensions.GetData());
 
-    std::set<std::string> RequiredExtensions(Extensions.begin(), Extensions.end());
-    for (const auto& Extension : AvailableExtensions)
+    bool bExtensionSupport = true;
+    for (const char* RequiredExtension : Extensions)
     {
-        RequiredExtensions.erase(Extension.extensionName);
+        bool bFound = false;
+        for (const VkExtensionProperties& Extension : AvailableExtensions)
+        {
+            if (std::strcmp(Extension.extensionName, RequiredExtension) == 0)
+            {
+                bFound = true;
+                break;
+            }
+        }
+        bExtensionSupport &= bFound;
     }
     
-    bool bExtensionSupport = RequiredExtensions.empty();
     bool bSwapChainAdequate = false;
     
     if (bExtensionSupport)
     {
         RkSwapChainSupportDetails SwapChainSupport = RequestSwapchainSupportDetails(PhysicalDevice);
-        bSwapChainAdequate = !SwapChainSupport.Formats.empty() && !SwapChainSupport.PresentMode.empty();
+        bSwapChainAdequate = !SwapChainSupport.Formats.IsEmpty() && !SwapChainSupport.PresentMode.IsEmpty();
     }
 
     return Indices.IsComplete() && bExtensionSupport && bSwapChainAdequate;
@@ -872,9 +892,14 @@ void RkVulkanRendererContext::Record(VkCommandBuffer CommandBuffer, uint32 Image
     RK_ENGINE_ASSERT(Result == VK_SUCCESS, "Failed to record command buffer.");
 }
 
-void RkVulkanRendererContext::Draw()
+void RkVulkanRendererContext::WaitForFrame()
 {
     vkWaitForFences(GetLogicalDevice(), 1, &InFlightFences[CurrentFrame], VK_TRUE, UINT64_MAX);
+}
+
+void RkVulkanRendererContext::Draw()
+{
+    RK_MEMORY_SCOPE(Renderer);
 
     uint32_t ImageIndex = 0;
     VkResult Result = vkAcquireNextImageKHR(GetLogicalDevice(), Swapchain, UINT64_MAX, ImageAvailableSemaphores[CurrentFrame], VK_NULL_HANDLE, &ImageIndex);
@@ -11,6 +11,7 @@
 #include "Renderer/RendererContext.h"
 #include "Math/MathTypes.h"
 #include "Core/Assert.h"
+#include "Memory/Memory.h"
 
 //enum ERenderPipelineType
 //{
@@ -59,10 +60,10 @@ struct RkSwapChainSupportDetails
     VkSurfaceCapabilitiesKHR Capabilities;
 
     // Pixel format, color depth
-    std::vector<VkSurfaceFormatKHR> Formats;
+    TInlineArray<VkSurfaceFormatKHR, 16> Formats;
 
     // Conditions for "swapping" images to the screen
-    std::vector<VkPresentModeKHR> PresentMode;
+    TInlineArray<VkPresentModeKHR, 8> PresentMode;
 };
 
 struct RkVertex
@@ -98,11 +99,6 @@ struct RkVertex
     }
 };
 
-// With 2 frames in flight, the CPU and the GPU can be working on their own tasks at the same time. 
-// If the CPU finishes early, it will wait till the GPU finishes rendering before submitting more work. 
-// With 3 or more frames in flight, the CPU could get ahead of the GPU, adding frames of latency
-static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
-
  /*   
   *   Shader stages : the shader modules that define the functionality of the programmable stages of the graphics pipeline
   *   Fixed - function state : all of the structures that define the fixed - function stages of the pipeline, like input assembly, rasterizer, viewport and color blending
@@ -123,9 +119,14 @@ public:
     // Records a single draw call to command buffer
     void Record(VkCommandBuffer CommandBuffer, uint32 ImageIndex);
 
-    // Submits the recorded command buffer
+    // Blocks until the GPU has finished with the current frame slot
+    void WaitForFrame();
+
+    // Submits the recorded command buffer. Expects WaitForFrame to have been called for this frame.
     void Draw();
 
+    inline size_t GetCurrentFrame() const { return CurrentFrame; }
+
     // Recreates the entire swapchain (swapchains, framebuffers, image views)
     void RegenerateSwapchain();
 
@@ -152,8 +153,8 @@ protected:
             const VkDebugUtilsMessengerCallbackDataEXT* CallbackData,
             void* UserData);
 
-    VkSurfaceFormatKHR SelectSwapchainSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& Formats);
-    VkPresentModeKHR SelectSwapchainPresentMode(const std::vector<VkPresentModeKHR>& PresentModes);
+    VkSurfaceFormatKHR SelectSwapchainSurfaceFormat(const TArrayView<VkSurfaceFormatKHR>& Formats);
+    VkPresentModeKHR SelectSwapchainPresentMode(const TArrayView<VkPresentModeKHR>& PresentModes);
     VkExtent2D SelectSwapExtent(const VkSurfaceCapabilitiesKHR& Capabilities);
     
     RkSwapChainSupportDetails RequestSwapchainSupportDetails(VkPhysicalDevice PhysicalDevice);
@@ -9,6 +9,8 @@
 
 void CWindowsWindow::CreateNativeWindow()
 {
+    RK_MEMORY_SCOPE(Platform);
+
     glfwInit();
 
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
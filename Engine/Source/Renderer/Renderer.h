@@ -1,27 +1,35 @@
 #pragma once
 
-#include <functional>
+#include <type_traits>
+#include <utility>
 
+#include "Memory/Function.h"
 #include "Memory/Memory.h"
 
 class CRenderCommand
 {
 public:
+    // Captures beyond this size fail to compile instead of allocating.
+    static constexpr size_t InlineSize = 48;
+
     CRenderCommand() = default;
-    CRenderCommand(const std::function<void()>& Func)
-        : Command(Func)
+
+    template<typename TCallable, typename = std::enable_if_t<!std::is_same_v<std::decay_t<TCallable>, CRenderCommand>>>
+    CRenderCommand(TCallable&& Callable)
+        : Command(std::forward<TCallable>(Callable))
     {
     }
 
-    std::function<void()> Command;
+    TFunction<void(), InlineSize> Command;
 };
 
 class CRenderQueue
 {
 public:
-    void AddCommand(const CRenderCommand& Command)
+    // Commands are moved in, the queue keeps its capacity across frames so steady state enqueues do not allocate.
+    void AddCommand(CRenderCommand&& Command)
     {
-        Commands.Push(Command);
+        Commands.Emplace(std::move(Command));
     }
 
     void Sort()
@@ -1,5 +1,10 @@
 ﻿#pragma once
 
+// With 2 frames in flight, the CPU and the GPU can be working on their own tasks at the same time. 
+// If the CPU finishes early, it will wait till the GPU finishes rendering before submitting more work. 
+// With 3 or more frames in flight, the CPU could get ahead of the GPU, adding frames of latency
+static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
+
 class CRendererContext
 {
 protected:
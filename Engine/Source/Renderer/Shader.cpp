@@ -3,22 +3,46 @@
 #include <Windows.h>
 #include <wrl.h>
 #include <dxcapi.h>
+#include <string>
 #include <vector>
 
 #include "Core/Assert.h"
 #include "Platform/Vulkan/VulkanRendererContext.h"
 #include "Core/Window.h"
 #include "Memory/Mem.h"
+#include "Memory/Memory.h"
+#include "Memory/StackAllocator.h"
 
 using Microsoft::WRL::ComPtr;
 
-void RkShader::Compile(EShaderType ShaderType, const std::wstring& ShaderSourcePath, const std::wstring& Entrypoint, const std::string& TargetProfile)
+namespace
+{
+    // DXC takes wide strings, converted into scratch memory of the caller's stack scope.
+    static const wchar_t* WidenName(SName Name, CStackAllocator& Stack)
+    {
+        const std::string_view String = Name.ToString();
+        const int32 Length = MultiByteToWideChar(CP_UTF8, 0, String.data(), static_cast<int32>(String.size()), nullptr, 0);
+
+        wchar_t* Wide = static_cast<wchar_t*>(Stack.Allocate((Length + 1) * sizeof(wchar_t), alignof(wchar_t)));
+        MultiByteToWideChar(CP_UTF8, 0, String.data(), static_cast<int32>(String.size()), Wide, Length);
+        Wide[Length] = L'\0';
+        return Wide;
+    }
+}
+
+void RkShader::Compile(EShaderType ShaderType, SName ShaderSourcePath, SName Entrypoint, SName TargetProfile)
 {
     ComPtr<IDxcCompiler> Compiler;
     ComPtr<IDxcLibrary> Library;
     ComPtr<IDxcBlobEncoding> SourceBlob;
     ComPtr<IDxcOperationResult> OperationResult;
 
+    // Wide strings and compilation arguments, only needed until the compiler returns
+    RK_SCOPED_STACK(Stack);
+    const wchar_t* ShaderSourcePathW = WidenName(ShaderSourcePath, Stack);
+    const wchar_t* EntrypointW = WidenName(Entrypoint, Stack);
+    const wchar_t* TargetProfileW = WidenName(TargetProfile, Stack);
+
     // Create the DXC library instance
     HRESULT DxcResult = DxcCreateInstance(CLSID_DxcLibrary, IID_PPV_ARGS(&Library));
     RK_ENGINE_ASSERT(!FAILED(DxcResult), "Failed to create DXC Library instance.");
@@ -28,27 +52,26 @@ void RkShader::Compile(EShaderType ShaderType, const std::wstring& ShaderSourceP
     RK_ENGINE_ASSERT(!FAILED(DxcResult), "Failed to create DXC Compiler instance.");
 
     // Load and encode the shader source file
-    DxcResult = Library->CreateBlobFromFile(ShaderSourcePath.c_str(), nullptr, &SourceBlob);
+    DxcResult = Library->CreateBlobFromFile(ShaderSourcePathW, nullptr, &SourceBlob);
     RK_ENGINE_ASSERT(!FAILED(DxcResult), "Failed to load shader source file.");
 
-    // Compilation arguments
-    std::wstring TargetProfileW(TargetProfile.begin(), TargetProfile.end());
-    std::vector<LPCWSTR> Arguments;
-    Arguments.push_back(L"-E");
-    Arguments.push_back(Entrypoint.c_str());
-    Arguments.push_back(L"-T");
-    Arguments.push_back(TargetProfileW.c_str());
-    Arguments.push_back(L"-spirv");
-    Arguments.push_back(L"-fvk-use-dx-layout");
+    TArray<LPCWSTR, SStackAllocator> Arguments(Stack);
+    Arguments.Reserve(6);
+    Arguments.Push(L"-E");
+    Arguments.Push(EntrypointW);
+    Arguments.Push(L"-T");
+    Arguments.Push(TargetProfileW);
+    Arguments.Push(L"-spirv");
+    Arguments.Push(L"-fvk-use-dx-layout");
 
     // Compile HLSL into SPIR-V bytecode using DirectX Shader Compiler
     DxcResult = Compiler->Compile(
         SourceBlob.Get(), 
-        ShaderSourcePath.c_str(), 
-        Entrypoint.c_str(), 
-        TargetProfileW.c_str(), 
-        Arguments.data(), 
-        Arguments.size(), 
+        ShaderSourcePathW, 
+        EntrypointW, 
+        TargetProfileW, 
+        Arguments.GetData(), 
+        static_cast<UINT32>(Arguments.GetSize()), 
         nullptr,
         0, 
         nullptr, 
@@ -5,6 +5,7 @@
 #include <unordered_map>
 #include <glm/ext/vector_float3.hpp>
 
+#include "Core/Name.h"
 #include "Math/MathTypes.h"
 
 enum EShaderType : uint8
@@ -25,7 +26,7 @@ struct SShaderProgram
 class RkShader
 {
 public:
-	void Compile(EShaderType ShaderType, const std::wstring& ShaderSourcePath, const std::wstring& Entrypoint, const std::string& TargetProfile);
+	void Compile(EShaderType ShaderType, SName ShaderSourcePath, SName Entrypoint, SName TargetProfile);
 	void PostCompile();
 
 	std::vector<SShaderProgram> ShaderPrograms;
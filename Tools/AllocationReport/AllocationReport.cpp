@@ -0,0 +1,317 @@
+/*
+ * Offline analysis of allocation captures written by AllocationRecorder.
+ *
+ * Usage: AllocationReport <capture> [--buckets N] [--top N]
+ *
+ * Prints live heap bytes over time per tag, the allocation sites with the most sampled bytes, and a
+ * fragmentation estimate: the share of the pages touched by live blocks that live bytes do not cover.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Memory/AllocationRecorder.h"
+
+namespace
+{
+    using namespace AllocationCapture;
+
+    static constexpr uint32 NoSite = ~0u;
+    static constexpr uint64 PageSize = 4096;
+
+    struct SParsedEvent
+    {
+        uint64 Timestamp;
+        uint64 Address;
+        uint64 Size;
+        EEventType Type;
+        uint8 Tag;
+        uint32 ThreadId;
+        uint32 Site;
+    };
+
+    struct SSite
+    {
+        std::vector<uint64> Frames;
+        uint64 NumAllocations = 0;
+        uint64 Bytes = 0;
+        uint64 LiveBytes = 0;
+    };
+
+    struct SLiveBlock
+    {
+        uint64 Size;
+        uint8 Tag;
+        uint32 Site;
+    };
+
+    struct SCapture
+    {
+        SFileHeader Header;
+        std::vector<SParsedEvent> Events;
+        std::vector<SSite> Sites;
+        uint32 NumThreads = 0;
+    };
+
+    bool ReadCapture(const char* Path, SCapture& Capture)
+    {
+        std::ifstream File(Path, std::ios::binary);
+        if (!File)
+        {
+            std::fprintf(stderr, "Cannot open %s\n", Path);
+            return false;
+        }
+
+        std::vector<char> Data((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+        if (Data.size() < sizeof(SFileHeader))
+        {
+            std::fprintf(stderr, "%s is too small to be a capture.\n", Path);
+            return false;
+        }
+
+        std::memcpy(&Capture.Header, Data.data(), sizeof(SFileHeader));
+        Capture.Header.NumTags = std::min(Capture.Header.NumTags, MaxTags);
+        const SFileHeader& Header = Capture.Header;
+        if (Header.Magic != Magic || Header.Version != Version)
+        {
+            std::fprintf(stderr, "%s is not a version %u allocation capture.\n", Path, Version);
+            return false;
+        }
+        if (Header.DataSize > Data.size() - sizeof(SFileHeader))
+        {
+            std::fprintf(stderr, "%s is truncated, the recorder was probably not stopped.\n", Path);
+            return false;
+        }
+
+        std::unordered_map<std::string, uint32> SiteIndices;
+        Capture.Events.reserve(Header.NumEvents);
+
+        size_t Offset = sizeof(SFileHeader);
+        const size_t End = sizeof(SFileHeader) + Header.DataSize;
+        while (Offset + sizeof(SBlockHeader) <= End)
+        {
+            SBlockHeader Block;
+            std::memcpy(&Block, Data.data() + Offset, sizeof(Block));
+            Offset += sizeof(Block);
+            Capture.NumThreads = std::max(Capture.NumThreads, Block.ThreadId + 1);
+
+            const size_t BlockEnd = std::min(End, Offset + Block.Size);
+            while (Offset + sizeof(SEvent) <= BlockEnd)
+            {
+                SEvent Event;
+                std::memcpy(&Event, Data.data() + Offset, sizeof(Event));
+                Offset += sizeof(Event);
+
+                const size_t StackSize = Event.NumFrames * sizeof(uint64);
+                uint32 Site = NoSite;
+                if (Event.NumFrames > 0 && Offset + StackSize <= BlockEnd)
+                {
+                    const std::string Key(Data.data() + Offset, StackSize);
+                    auto [It, bInserted] = SiteIndices.emplace(Key, static_cast<uint32>(Capture.Sites.size()));
+                    if (bInserted)
+                    {
+                        SSite NewSite;
+                        NewSite.Frames.resize(Event.NumFrames);
+                        std::memcpy(NewSite.Frames.data(), Key.data(), StackSize);
+                        Capture.Sites.push_back(std::move(NewSite));
+                    }
+                    Site = It->second;
+                }
+                Offset += StackSize;
+
+                Capture.Events.push_back({ Event.Timestamp, Event.Address, Event.Size, Event.Type, Event.Tag, Block.ThreadId, Site });
+            }
+            Offset = BlockEnd;
+        }
+
+        // Blocks of different threads interleave in the file.
+        std::stable_sort(Capture.Events.begin(), Capture.Events.end(), [](const SParsedEvent& A, const SParsedEvent& B)
+        {
+            return A.Timestamp < B.Timestamp;
+        });
+        return true;
+    }
+
+    // Pages that hold at least one byte of a live block. Large free gaps between them are what the estimate penalizes.
+    uint64 CountPinnedPages(const std::unordered_map<uint64, SLiveBlock>& LiveBlocks)
+    {
+        std::vector<std::pair<uint64, uint64>> Ranges;
+        Ranges.reserve(LiveBlocks.size());
+        for (const auto& [Address, Block] : LiveBlocks)
+        {
+            if (Block.Size > 0)
+            {
+                Ranges.emplace_back(Address / PageSize, (Address + Block.Size - 1) / PageSize);
+            }
+        }
+        std::sort(Ranges.begin(), Ranges.end());
+
+        uint64 NumPages = 0;
+        uint64 NextFreePage = 0;
+        for (const auto& [FirstPage, LastPage] : Ranges)
+        {
+            const uint64 Start = std::max(FirstPage, NextFreePage);
+            if (LastPage >= Start)
+            {
+                NumPages += LastPage - Start + 1;
+                NextFreePage = LastPage + 1;
+            }
+        }
+        return NumPages;
+    }
+
+    // Also accumulates per-site totals for the sampled allocations.
+    void PrintTimeline(SCapture& Capture, uint32 NumBuckets)
+    {
+        const SFileHeader& Header = Capture.Header;
+        std::vector<SSite>& Sites = Capture.Sites;
+        const uint64 Duration = Capture.Events.empty() ? 0 : Capture.Events.back().Timestamp + 1;
+
+        std::unordered_map<uint64, SLiveBlock> LiveBlocks;
+        std::vector<uint64> LiveBytesPerTag(Header.NumTags + 1, 0);
+        uint64 LiveBytes = 0;
+        uint64 PeakLiveBytes = 0;
+
+        std::printf("Live heap over time\n");
+        std::printf("%10s %14s %10s %14s %9s", "Time (s)", "Live bytes", "Blocks", "Peak bytes", "Frag %");
+        for (uint32 Tag = 0; Tag < Header.NumTags; ++Tag)
+        {
+            std::printf(" %14s", Header.TagNames[Tag]);
+        }
+        std::printf("\n");
+
+        auto PrintRow = [&](uint64 Timestamp)
+        {
+            const uint64 PinnedBytes = CountPinnedPages(LiveBlocks) * PageSize;
+            const double Fragmentation = PinnedBytes > 0 ? 100.0 * (1.0 - static_cast<double>(LiveBytes) / PinnedBytes) : 0.0;
+            std::printf("%10.3f %14llu %10zu %14llu %8.1f%%", Timestamp / 1e9, static_cast<unsigned long long>(LiveBytes), LiveBlocks.size(),
+                static_cast<unsigned long long>(PeakLiveBytes), Fragmentation);
+            for (uint32 Tag = 0; Tag < Header.NumTags; ++Tag)
+            {
+                std::printf(" %14llu", static_cast<unsigned long long>(LiveBytesPerTag[Tag]));
+            }
+            std::printf("\n");
+        };
+
+        uint32 Bucket = 1;
+        for (const SParsedEvent& Event : Capture.Events)
+        {
+            while (Bucket < NumBuckets && Event.Timestamp >= Duration * Bucket / NumBuckets)
+            {
+                PrintRow(Duration * Bucket / NumBuckets);
+                ++Bucket;
+            }
+
+            const uint32 TagIndex = std::min<uint32>(Event.Tag, Header.NumTags);
+            if (Event.Type == EEventType::Allocate)
+            {
+                LiveBlocks[Event.Address] = SLiveBlock { Event.Size, Event.Tag, Event.Site };
+                LiveBytes += Event.Size;
+                LiveBytesPerTag[TagIndex] += Event.Size;
+                PeakLiveBytes = std::max(PeakLiveBytes, LiveBytes);
+
+                if (Event.Site != NoSite)
+                {
+                    ++Sites[Event.Site].NumAllocations;
+                    Sites[Event.Site].Bytes += Event.Size;
+                }
+            }
+            else
+            {
+                // Blocks allocated before the capture started are unknown and ignored.
+                auto It = LiveBlocks.find(Event.Address);
+                if (It != LiveBlocks.end())
+                {
+                    LiveBytes -= It->second.Size;
+                    LiveBytesPerTag[std::min<uint32>(It->second.Tag, Header.NumTags)] -= It->second.Size;
+                    LiveBlocks.erase(It);
+                }
+            }
+        }
+        PrintRow(Duration);
+
+        for (const auto& [Address, Block] : LiveBlocks)
+        {
+            if (Block.Site != NoSite)
+            {
+                Sites[Block.Site].LiveBytes += Block.Size;
+            }
+        }
+    }
+
+    void PrintTopSites(const SCapture& Capture, uint32 NumSites)
+    {
+        const std::vector<SSite>& Sites = Capture.Sites;
+        std::vector<uint32> Order(Sites.size());
+        for (uint32 Index = 0; Index < Order.size(); ++Index)
+        {
+            Order[Index] = Index;
+        }
+        std::sort(Order.begin(), Order.end(), [&](uint32 A, uint32 B)
+        {
+            return Sites[A].Bytes > Sites[B].Bytes;
+        });
+
+        const uint32 SampleRate = Capture.Header.StackSampleRate;
+        std::printf("\nTop allocation sites (1 in %u allocations sampled, totals are scaled estimates)\n", SampleRate);
+        for (uint32 Rank = 0; Rank < Order.size() && Rank < NumSites; ++Rank)
+        {
+            const SSite& Site = Sites[Order[Rank]];
+            std::printf("#%u  ~%llu allocations, ~%llu bytes, ~%llu bytes still live at the end\n", Rank + 1,
+                static_cast<unsigned long long>(Site.NumAllocations * SampleRate),
+                static_cast<unsigned long long>(Site.Bytes * SampleRate),
+                static_cast<unsigned long long>(Site.LiveBytes * SampleRate));
+            for (uint64 Frame : Site.Frames)
+            {
+                std::printf("      0x%016llx\n", static_cast<unsigned long long>(Frame));
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "Usage: %s <capture> [--buckets N] [--top N]\n", argv[0]);
+        return 1;
+    }
+
+    uint32 NumBuckets = 20;
+    uint32 NumSites = 10;
+    for (int32 Arg = 2; Arg + 1 < argc; Arg += 2)
+    {
+        if (std::strcmp(argv[Arg], "--buckets") == 0)
+        {
+            NumBuckets = std::max(1, std::atoi(argv[Arg + 1]));
+        }
+        else if (std::strcmp(argv[Arg], "--top") == 0)
+        {
+            NumSites = std::max(0, std::atoi(argv[Arg + 1]));
+        }
+    }
+
+    SCapture Capture;
+    if (!ReadCapture(argv[1], Capture))
+    {
+        return 1;
+    }
+
+    std::printf("%s: %zu events from %u threads", argv[1], Capture.Events.size(), Capture.NumThreads);
+    if (Capture.Header.NumDroppedEvents > 0)
+    {
+        std::printf(", %llu events dropped because the capture file was full", static_cast<unsigned long long>(Capture.Header.NumDroppedEvents));
+    }
+    std::printf("\n\n");
+
+    PrintTimeline(Capture, NumBuckets);
+    PrintTopSites(Capture, NumSites);
+    return 0;
+}
@@ -0,0 +1,375 @@
+/*
+ * Correctness check and micro-benchmark of TIntrusiveList and TChunkedList in Memory/LinkedList.h against TArray.
+ *
+ * Usage: ListBenchmark [--elements N] [--iterations N]
+ *
+ * Runs randomized append and remove churn on both lists against a reference array, checking the order of the
+ * elements and that the chunked list stays within its chunk bound, and fails with exit code 1 on a mismatch. Then
+ * times append, traversal, removal by value and steady state churn against TArray. Churn removes a random live
+ * element and appends a new one. The array and the chunked list find it by value, the intrusive list by its node.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "Memory/LinkedList.h"
+#include "Memory/Memory.h"
+
+namespace
+{
+    static constexpr uint32 ElementsPerChunk = 32;
+
+    using TChunkedListType = TChunkedList<uint32, ElementsPerChunk>;
+
+    // Owner of an intrusive link with a payload, in the shape of an active object list entry.
+    struct SObject : public TIntrusiveListNode<SObject>
+    {
+        uint32 Value = 0;
+
+        uint32 Padding[15] = {};
+    };
+
+    size_t GetMaxChunks(size_t Size)
+    {
+        return 4 * Size / ElementsPerChunk + 1;
+    }
+
+    bool CheckChunkedList(const TChunkedListType& List, const std::vector<uint32>& Expected)
+    {
+        if (List.GetSize() != Expected.size() || List.GetNumChunks() > GetMaxChunks(Expected.size()))
+        {
+            return false;
+        }
+        size_t Index = 0;
+        for (uint32 Value : List)
+        {
+            if (Value != Expected[Index++])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool CheckIntrusiveList(const TIntrusiveList<SObject>& List, const std::vector<uint32>& Expected)
+    {
+        if (List.GetSize() != Expected.size())
+        {
+            return false;
+        }
+        size_t Index = 0;
+        for (const SObject& Object : List)
+        {
+            if (Object.Value != Expected[Index++])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool RunChecks()
+    {
+        std::mt19937 Random(7);
+        bool bPassed = true;
+
+        // Alternating growth and shrink phases, so chunks are filled, drained from the middle and merged.
+        {
+            TChunkedListType List;
+            std::vector<uint32> Expected;
+            uint32 NextValue = 0;
+            size_t MaxChunks = 0;
+            for (uint32 Step = 0; Step < 200000 && bPassed; ++Step)
+            {
+                const bool bGrowing = (Step / 20000) % 2 == 0;
+                if (Expected.empty() || Random() % 100 < (bGrowing ? 70u : 30u))
+                {
+                    List.Push(NextValue);
+                    Expected.push_back(NextValue++);
+                }
+                else
+                {
+                    const size_t Index = Random() % Expected.size();
+                    bPassed &= List.Remove(Expected[Index]);
+                    Expected.erase(Expected.begin() + Index);
+                }
+
+                if (Step % 4999 == 0)
+                {
+                    const uint32 Divisor = 2 + Random() % 5;
+                    const size_t NumRemoved = List.RemoveIf([Divisor](uint32 Value) { return Value % Divisor == 0; });
+                    const size_t OldSize = Expected.size();
+                    Expected.erase(std::remove_if(Expected.begin(), Expected.end(), [Divisor](uint32 Value) { return Value % Divisor == 0; }), Expected.end());
+                    bPassed &= NumRemoved == OldSize - Expected.size();
+                }
+
+                bPassed &= List.GetNumChunks() <= GetMaxChunks(Expected.size());
+                if (Step % 101 == 0)
+                {
+                    bPassed &= CheckChunkedList(List, Expected);
+                }
+                MaxChunks = std::max(MaxChunks, List.GetNumChunks());
+            }
+            bPassed &= CheckChunkedList(List, Expected);
+            std::printf("  %-14s %s, %zu elements in %zu chunks at the end, at most %zu chunks\n", "TChunkedList", bPassed ? "ok" : "FAILED", List.GetSize(), List.GetNumChunks(), MaxChunks);
+        }
+
+        {
+            static constexpr uint32 NumObjects = 4096;
+            std::vector<SObject> Objects(NumObjects);
+            TIntrusiveList<SObject> List;
+            std::vector<uint32> Expected;
+            bool bListPassed = true;
+            for (uint32 Index = 0; Index < NumObjects; ++Index)
+            {
+                Objects[Index].Value = Index;
+            }
+            for (uint32 Step = 0; Step < 100000 && bListPassed; ++Step)
+            {
+                SObject& Object = Objects[Random() % NumObjects];
+                if (Object.IsLinked())
+                {
+                    List.Remove(Object);
+                    Expected.erase(std::find(Expected.begin(), Expected.end(), Object.Value));
+                }
+                else if (Random() % 2 == 0)
+                {
+                    List.PushBack(Object);
+                    Expected.push_back(Object.Value);
+                }
+                else
+                {
+                    List.PushFront(Object);
+                    Expected.insert(Expected.begin(), Object.Value);
+                }
+
+                if (Step % 101 == 0)
+                {
+                    bListPassed &= CheckIntrusiveList(List, Expected);
+                }
+            }
+            bListPassed &= CheckIntrusiveList(List, Expected);
+            List.Empty();
+            std::printf("  %-14s %s\n", "TIntrusiveList", bListPassed ? "ok" : "FAILED");
+            bPassed &= bListPassed;
+        }
+        return bPassed;
+    }
+
+    template<typename TFunction>
+    double MeasureNanosecondsPerElement(size_t NumElements, uint32 NumIterations, TFunction Function)
+    {
+        using SClock = std::chrono::steady_clock;
+
+        // One untimed pass warms the caches and the branch predictors.
+        Function();
+
+        const SClock::time_point Start = SClock::now();
+        for (uint32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+        {
+            Function();
+        }
+        const double Nanoseconds = std::chrono::duration<double, std::nano>(SClock::now() - Start).count();
+        return Nanoseconds / (static_cast<double>(NumElements) * NumIterations);
+    }
+
+    // For passes that consume their input, such as removals, which cannot be repeated or warmed up.
+    template<typename TFunction>
+    double MeasureSinglePass(size_t NumElements, TFunction Function)
+    {
+        using SClock = std::chrono::steady_clock;
+
+        const SClock::time_point Start = SClock::now();
+        Function();
+        const double Nanoseconds = std::chrono::duration<double, std::nano>(SClock::now() - Start).count();
+        return Nanoseconds / static_cast<double>(NumElements);
+    }
+
+    // Keeps the compiler from discarding a traversal whose result is unused.
+    volatile uint64 GSink = 0;
+
+    void RunBenchmark(size_t NumElements, uint32 NumIterations)
+    {
+        std::mt19937 Random(42);
+
+        // Objects are allocated one by one in shuffled order, like long-lived entities linked into an active list.
+        std::vector<std::unique_ptr<SObject>> Objects(NumElements);
+        for (size_t Index = 0; Index < NumElements; ++Index)
+        {
+            Objects[Index] = std::make_unique<SObject>();
+            Objects[Index]->Value = static_cast<uint32>(Index);
+        }
+        std::shuffle(Objects.begin(), Objects.end(), Random);
+
+        std::vector<uint32> RemovalOrder(NumElements);
+        for (size_t Index = 0; Index < NumElements; ++Index)
+        {
+            RemovalOrder[Index] = static_cast<uint32>(Index);
+        }
+        std::shuffle(RemovalOrder.begin(), RemovalOrder.end(), Random);
+
+        // Removal by value searches linearly in the array and the chunked list, so it runs over a smaller prefix.
+        const size_t NumRemovals = std::max<size_t>(1, std::min<size_t>(NumElements / 2, 4096));
+
+        std::printf("\nLists of %zu elements, %u iterations, nanoseconds per element\n", NumElements, NumIterations);
+        std::printf("  %-14s %9s %9s %9s %9s\n", "", "Append", "Traverse", "Remove", "Churn");
+
+        {
+            TArray<uint32> Array;
+            const double Append = MeasureNanosecondsPerElement(NumElements, NumIterations, [&]()
+            {
+                Array = TArray<uint32>();
+                for (size_t Index = 0; Index < NumElements; ++Index)
+                {
+                    Array.Push(static_cast<uint32>(Index));
+                }
+            });
+            const double Traverse = MeasureNanosecondsPerElement(NumElements, NumIterations, [&]()
+            {
+                uint64 Sum = 0;
+                for (uint32 Value : Array)
+                {
+                    Sum += Value;
+                }
+                GSink = GSink + Sum;
+            });
+            const double Remove = MeasureSinglePass(NumRemovals, [&]()
+            {
+                for (size_t Removal = 0; Removal < NumRemovals; ++Removal)
+                {
+                    const uint32* Found = std::find(Array.begin(), Array.end(), RemovalOrder[Removal]);
+                    if (Found != Array.end())
+                    {
+                        Array.RemoveAtSwap(static_cast<size_t>(Found - Array.begin()));
+                    }
+                }
+            });
+            const double Churn = MeasureNanosecondsPerElement(NumRemovals, NumIterations, [&]()
+            {
+                for (size_t Removal = 0; Removal < NumRemovals; ++Removal)
+                {
+                    const uint32 Value = Array[Random() % Array.GetSize()];
+                    Array.RemoveAtSwap(static_cast<size_t>(std::find(Array.begin(), Array.end(), Value) - Array.begin()));
+                    Array.Push(Value);
+                }
+            });
+            std::printf("  %-14s %9.3f %9.3f %9.3f %9.3f\n", "TArray", Append, Traverse, Remove, Churn);
+        }
+
+        {
+            TChunkedListType List;
+            const double Append = MeasureNanosecondsPerElement(NumElements, NumIterations, [&]()
+            {
+                List.Empty();
+                for (size_t Index = 0; Index < NumElements; ++Index)
+                {
+                    List.Push(static_cast<uint32>(Index));
+                }
+            });
+            const double Traverse = MeasureNanosecondsPerElement(NumElements, NumIterations, [&]()
+            {
+                uint64 Sum = 0;
+                for (uint32 Value : List)
+                {
+                    Sum += Value;
+                }
+                GSink = GSink + Sum;
+            });
+            const double Remove = MeasureSinglePass(NumRemovals, [&]()
+            {
+                for (size_t Removal = 0; Removal < NumRemovals; ++Removal)
+                {
+                    List.Remove(RemovalOrder[Removal]);
+                }
+            });
+
+            // Removes a random element and appends a new one, the pattern that used to leave sparse chunks behind.
+            std::vector<uint32> Live;
+            for (uint32 Value : List)
+            {
+                Live.push_back(Value);
+            }
+            const double Churn = MeasureNanosecondsPerElement(NumRemovals, NumIterations, [&]()
+            {
+                for (size_t Removal = 0; Removal < NumRemovals; ++Removal)
+                {
+                    const size_t Index = Random() % Live.size();
+                    List.Remove(Live[Index]);
+                    Live[Index] = static_cast<uint32>(NumElements + Removal);
+                    List.Push(Live[Index]);
+                }
+            });
+            std::printf("  %-14s %9.3f %9.3f %9.3f %9.3f  %zu chunks after churn, bound %zu\n", "TChunkedList", Append, Traverse, Remove, Churn, List.GetNumChunks(), GetMaxChunks(List.GetSize()));
+        }
+
+        {
+            TIntrusiveList<SObject> List;
+            const double Append = MeasureNanosecondsPerElement(NumElements, NumIterations, [&]()
+            {
+                List.Empty();
+                for (const std::unique_ptr<SObject>& Object : Objects)
+                {
+                    List.PushBack(*Object);
+                }
+            });
+            const double Traverse = MeasureNanosecondsPerElement(NumElements, NumIterations, [&]()
+            {
+                uint64 Sum = 0;
+                for (const SObject& Object : List)
+                {
+                    Sum += Object.Value;
+                }
+                GSink = GSink + Sum;
+            });
+            const double Remove = MeasureSinglePass(NumRemovals, [&]()
+            {
+                for (size_t Removal = 0; Removal < NumRemovals; ++Removal)
+                {
+                    List.Remove(*Objects[RemovalOrder[Removal]]);
+                }
+            });
+            const double Churn = MeasureNanosecondsPerElement(NumRemovals, NumIterations, [&]()
+            {
+                for (size_t Removal = 0; Removal < NumRemovals; ++Removal)
+                {
+                    SObject& Object = *Objects[Random() % NumElements];
+                    if (Object.IsLinked())
+                    {
+                        List.Remove(Object);
+                    }
+                    List.PushBack(Object);
+                }
+            });
+            List.Empty();
+            std::printf("  %-14s %9.3f %9.3f %9.3f %9.3f\n", "TIntrusiveList", Append, Traverse, Remove, Churn);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t NumElements = 1 << 16;
+    uint32 NumIterations = 100;
+    for (int32 Arg = 1; Arg + 1 < argc; Arg += 2)
+    {
+        if (std::strcmp(argv[Arg], "--elements") == 0)
+        {
+            NumElements = static_cast<size_t>(std::max(2, std::atoi(argv[Arg + 1])));
+        }
+        else if (std::strcmp(argv[Arg], "--iterations") == 0)
+        {
+            NumIterations = static_cast<uint32>(std::max(1, std::atoi(argv[Arg + 1])));
+        }
+    }
+
+    std::printf("Randomized churn against a reference array\n");
+    const bool bPassed = RunChecks();
+    RunBenchmark(NumElements, NumIterations);
+    return bPassed ? 0 : 1;
+}
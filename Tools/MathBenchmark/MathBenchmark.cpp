@@ -0,0 +1,343 @@
+/*
+ * Accuracy check and micro-benchmark of the square root tiers in Math/Math.h, and of the matrix and transform
+ * kernels in Math/Matrix.h and Math/Transform.h.
+ *
+ * Usage: MathBenchmark [--elements N] [--iterations N]
+ *
+ * Measures the maximum relative error of every tier against a double precision reference over positive normal
+ * floats, and fails with exit code 1 when a tier exceeds the bound documented on EMathAccuracy. Then times the
+ * batch kernels against a plain std::sqrt loop, and the matrix batch kernels against scalar loops over the elements.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "Math/Math.h"
+#include "Math/Matrix.h"
+#include "Math/Transform.h"
+#include "Memory/Memory.h"
+
+namespace
+{
+    struct STier
+    {
+        EMathAccuracy Accuracy;
+        const char* Name;
+
+        // Maximum relative error documented for the tier.
+        double Bound;
+    };
+
+    static const STier Tiers[] =
+    {
+        { EMathAccuracy::Exact,     "Exact",    1.2e-7 },
+        { EMathAccuracy::Fast,      "Fast",     4.8e-7 },
+        { EMathAccuracy::Estimate,  "Estimate", 4.9e-4 },
+    };
+
+    // Every mantissa pattern in the top 16 bits across a wide exponent range, plus the edges of the float range.
+    std::vector<float> MakeAccuracyInputs()
+    {
+        std::vector<float> Inputs;
+        for (uint32 Exponent = 1; Exponent < 255; Exponent += 3)
+        {
+            for (uint32 Mantissa = 0; Mantissa < (1u << 23); Mantissa += 1u << 7)
+            {
+                const uint32 Bits = (Exponent << 23) | Mantissa;
+                float Value;
+                std::memcpy(&Value, &Bits, sizeof(Value));
+                Inputs.push_back(Value);
+            }
+        }
+        Inputs.push_back(std::numeric_limits<float>::min());
+        Inputs.push_back(std::numeric_limits<float>::max());
+        return Inputs;
+    }
+
+    double MaxRelativeError(const std::vector<float>& Inputs, const std::vector<float>& Results, bool bReciprocal)
+    {
+        double MaxError = 0.0;
+        for (size_t Index = 0; Index < Inputs.size(); ++Index)
+        {
+            const double Root = std::sqrt(static_cast<double>(Inputs[Index]));
+            const double Expected = bReciprocal ? 1.0 / Root : Root;
+            MaxError = std::max(MaxError, std::abs(Results[Index] - Expected) / Expected);
+        }
+        return MaxError;
+    }
+
+    bool CheckEdgeCases(const STier& Tier)
+    {
+        const bool bSqrtZero = Math::Sqrt(0.0f, Tier.Accuracy) == 0.0f;
+        const bool bInvSqrtZero = std::isinf(Math::InvSqrt(0.0f, Tier.Accuracy));
+        if (!bSqrtZero || !bInvSqrtZero)
+        {
+            std::printf("  %-8s  edge cases FAILED: Sqrt(0) = %g, InvSqrt(0) = %g\n", Tier.Name, Math::Sqrt(0.0f, Tier.Accuracy), Math::InvSqrt(0.0f, Tier.Accuracy));
+            return false;
+        }
+        return true;
+    }
+
+    bool RunAccuracy()
+    {
+        std::vector<float> Inputs = MakeAccuracyInputs();
+        std::vector<float> Results(Inputs.size());
+        const TArrayView<float> InputView(Inputs.data(), Inputs.size());
+        const TArrayView<float> ResultView(Results.data(), Results.size());
+
+        std::printf("Accuracy over %zu inputs, maximum relative error\n", Inputs.size());
+        bool bPassed = true;
+        for (const STier& Tier : Tiers)
+        {
+            Math::SqrtBatch(ResultView, InputView, Tier.Accuracy);
+            const double SqrtError = MaxRelativeError(Inputs, Results, false);
+
+            Math::InvSqrtBatch(ResultView, InputView, Tier.Accuracy);
+            const double InvSqrtError = MaxRelativeError(Inputs, Results, true);
+
+            const bool bWithinBound = SqrtError <= Tier.Bound && InvSqrtError <= Tier.Bound;
+            std::printf("  %-8s  Sqrt %.3e  InvSqrt %.3e  bound %.1e  %s\n", Tier.Name, SqrtError, InvSqrtError, Tier.Bound, bWithinBound ? "ok" : "EXCEEDED");
+
+            bPassed &= bWithinBound && CheckEdgeCases(Tier);
+        }
+        return bPassed;
+    }
+
+    template<typename TFunction>
+    double MeasureNanosecondsPerElement(size_t NumElements, uint32 NumIterations, TFunction Function)
+    {
+        using SClock = std::chrono::steady_clock;
+
+        // One untimed pass warms the caches and the branch predictors.
+        Function();
+
+        const SClock::time_point Start = SClock::now();
+        for (uint32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+        {
+            Function();
+        }
+        const double Nanoseconds = std::chrono::duration<double, std::nano>(SClock::now() - Start).count();
+        return Nanoseconds / (static_cast<double>(NumElements) * NumIterations);
+    }
+
+    void RunBenchmark(size_t NumElements, uint32 NumIterations)
+    {
+        std::mt19937 Random(42);
+        std::uniform_real_distribution<float> Distribution(1e-3f, 1e6f);
+
+        std::vector<float> Inputs(NumElements);
+        for (float& Input : Inputs)
+        {
+            Input = Distribution(Random);
+        }
+        std::vector<float> Results(NumElements);
+        const TArrayView<float> InputView(Inputs.data(), Inputs.size());
+        const TArrayView<float> ResultView(Results.data(), Results.size());
+
+        std::printf("\nThroughput over %zu elements, %u iterations, nanoseconds per element\n", NumElements, NumIterations);
+
+        const double Baseline = MeasureNanosecondsPerElement(NumElements, NumIterations, [&]()
+        {
+            for (size_t Index = 0; Index < NumElements; ++Index)
+            {
+                Results[Index] = 1.0f / std::sqrt(Inputs[Index]);
+            }
+        });
+        std::printf("  %-22s %.3f\n", "1 / std::sqrt loop", Baseline);
+
+        for (const STier& Tier : Tiers)
+        {
+            const double SqrtTime = MeasureNanosecondsPerElement(NumElements, NumIterations, [&]()
+            {
+                Math::SqrtBatch(ResultView, InputView, Tier.Accuracy);
+            });
+            const double InvSqrtTime = MeasureNanosecondsPerElement(NumElements, NumIterations, [&]()
+            {
+                Math::InvSqrtBatch(ResultView, InputView, Tier.Accuracy);
+            });
+            std::printf("  %-8s SqrtBatch    %.3f\n", Tier.Name, SqrtTime);
+            std::printf("  %-8s InvSqrtBatch %.3f\n", Tier.Name, InvSqrtTime);
+        }
+    }
+
+    float RandomElement(std::mt19937& Random)
+    {
+        return std::uniform_real_distribution<float>(-1.0f, 1.0f)(Random);
+    }
+
+    void RunMatrixBenchmark(size_t NumElements, uint32 NumIterations)
+    {
+        std::mt19937 Random(42);
+
+        std::vector<SMatrix4x4f> Left(NumElements);
+        std::vector<SMatrix4x4f> Right(NumElements);
+        std::vector<SMatrix4x4f> Products(NumElements);
+        std::vector<SVector4f> Vectors(NumElements);
+        std::vector<SVector4f> Transformed(NumElements);
+        for (size_t Index = 0; Index < NumElements; ++Index)
+        {
+            for (uint32 Row = 0; Row < 4; ++Row)
+            {
+                for (uint32 Column = 0; Column < 4; ++Column)
+                {
+                    Left[Index](Row, Column) = RandomElement(Random);
+                    Right[Index](Row, Column) = RandomElement(Random);
+                }
+                Vectors[Index][Row] = RandomElement(Random);
+            }
+        }
+        const TArrayView<SMatrix4x4f> LeftView(Left.data(), Left.size());
+        const TArrayView<SMatrix4x4f> RightView(Right.data(), Right.size());
+        const TArrayView<SMatrix4x4f> ProductView(Products.data(), Products.size());
+        const TArrayView<SVector4f> VectorView(Vectors.data(), Vectors.size());
+        const TArrayView<SVector4f> TransformedView(Transformed.data(), Transformed.size());
+
+        std::printf("\nMatrices over %zu elements, %u iterations, nanoseconds per element\n", NumElements, NumIterations);
+
+        const double ScalarMultiply = MeasureNanosecondsPerElement(NumElements, NumIterations, [&]()
+        {
+            for (size_t Index = 0; Index < NumElements; ++Index)
+            {
+                for (uint32 Row = 0; Row < 4; ++Row)
+                {
+                    for (uint32 Column = 0; Column < 4; ++Column)
+                    {
+                        float Sum = 0.0f;
+                        for (uint32 Inner = 0; Inner < 4; ++Inner)
+                        {
+                            Sum += Left[Index](Row, Inner) * Right[Index](Inner, Column);
+                        }
+                        Products[Index](Row, Column) = Sum;
+                    }
+                }
+            }
+        });
+        const double BatchMultiply = MeasureNanosecondsPerElement(NumElements, NumIterations, [&]()
+        {
+            Math::MultiplyBatch(ProductView, LeftView, RightView);
+        });
+
+        const double ScalarTransform = MeasureNanosecondsPerElement(NumElements, NumIterations, [&]()
+        {
+            const SMatrix4x4f& Matrix = Left[0];
+            for (size_t Index = 0; Index < NumElements; ++Index)
+            {
+                for (uint32 Row = 0; Row < 4; ++Row)
+                {
+                    float Sum = 0.0f;
+                    for (uint32 Column = 0; Column < 4; ++Column)
+                    {
+                        Sum += Matrix(Row, Column) * Vectors[Index][Column];
+                    }
+                    Transformed[Index][Row] = Sum;
+                }
+            }
+        });
+        const double BatchTransform = MeasureNanosecondsPerElement(NumElements, NumIterations, [&]()
+        {
+            Math::TransformBatch(TransformedView, Left[0], VectorView);
+        });
+
+        const double Inverse = MeasureNanosecondsPerElement(NumElements, NumIterations, [&]()
+        {
+            for (size_t Index = 0; Index < NumElements; ++Index)
+            {
+                Products[Index] = Left[Index].GetInverse();
+            }
+        });
+
+        std::printf("  %-22s %.3f\n", "4x4 multiply loop", ScalarMultiply);
+        std::printf("  %-22s %.3f\n", "MultiplyBatch", BatchMultiply);
+        std::printf("  %-22s %.3f\n", "4x4 transform loop", ScalarTransform);
+        std::printf("  %-22s %.3f\n", "TransformBatch", BatchTransform);
+        std::printf("  %-22s %.3f\n", "GetInverse", Inverse);
+    }
+
+    void RunTransformBenchmark(size_t NumElements, uint32 NumIterations)
+    {
+        std::mt19937 Random(42);
+
+        std::vector<STransform> Transforms(NumElements);
+        std::vector<float> Components[10];
+        for (STransform& Transform : Transforms)
+        {
+            Transform.Location = SVector3f(RandomElement(Random), RandomElement(Random), RandomElement(Random));
+            Transform.Rotation = SQuaternion(RandomElement(Random), RandomElement(Random), RandomElement(Random), RandomElement(Random)).GetNormalized();
+            Transform.Scale = SVector3f(RandomElement(Random), RandomElement(Random), RandomElement(Random));
+
+            const float Values[10] =
+            {
+                Transform.Location.X, Transform.Location.Y, Transform.Location.Z,
+                Transform.Rotation.X, Transform.Rotation.Y, Transform.Rotation.Z, Transform.Rotation.W,
+                Transform.Scale.X, Transform.Scale.Y, Transform.Scale.Z,
+            };
+            for (uint32 Component = 0; Component < 10; ++Component)
+            {
+                Components[Component].push_back(Values[Component]);
+            }
+        }
+
+        STransformSoAView View;
+        for (uint32 Component = 0; Component < 3; ++Component)
+        {
+            View.Location[Component] = Components[Component].data();
+            View.Scale[Component] = Components[7 + Component].data();
+        }
+        for (uint32 Component = 0; Component < 4; ++Component)
+        {
+            View.Rotation[Component] = Components[3 + Component].data();
+        }
+        View.Size = NumElements;
+
+        std::vector<SMatrix3x4f> Matrices(NumElements);
+        const TArrayView<SMatrix3x4f> MatrixView(Matrices.data(), Matrices.size());
+
+        std::printf("\nTransforms to matrices over %zu elements, %u iterations, nanoseconds per element\n", NumElements, NumIterations);
+
+        const double Single = MeasureNanosecondsPerElement(NumElements, NumIterations, [&]()
+        {
+            for (size_t Index = 0; Index < NumElements; ++Index)
+            {
+                Matrices[Index] = Transforms[Index].ToMatrix();
+            }
+        });
+        const double Batch = MeasureNanosecondsPerElement(NumElements, NumIterations, [&]()
+        {
+            Math::TransformToMatrixBatch(MatrixView, View);
+        });
+
+        std::printf("  %-22s %.3f\n", "ToMatrix loop", Single);
+        std::printf("  %-22s %.3f\n", "TransformToMatrixBatch", Batch);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t NumElements = 1 << 16;
+    uint32 NumIterations = 1000;
+    for (int32 Arg = 1; Arg + 1 < argc; Arg += 2)
+    {
+        if (std::strcmp(argv[Arg], "--elements") == 0)
+        {
+            NumElements = static_cast<size_t>(std::max(1, std::atoi(argv[Arg + 1])));
+        }
+        else if (std::strcmp(argv[Arg], "--iterations") == 0)
+        {
+            NumIterations = static_cast<uint32>(std::max(1, std::atoi(argv[Arg + 1])));
+        }
+    }
+
+    std::printf("Math backend: %s\n\n", Simd::GetBackendName());
+
+    const bool bPassed = RunAccuracy();
+    RunBenchmark(NumElements, NumIterations);
+    RunMatrixBenchmark(NumElements, NumIterations / 10 + 1);
+    RunTransformBenchmark(NumElements, NumIterations / 10 + 1);
+    return bPassed ? 0 : 1;
+}
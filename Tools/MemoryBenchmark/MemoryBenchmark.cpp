@@ -0,0 +1,310 @@
+/*
+ * Correctness check and micro-benchmark of the memory primitives in Memory/Mem.h against their libc equivalents.
+ *
+ * Usage: MemoryBenchmark [--bytes N] [--iterations N]
+ *
+ * Compares every primitive with libc over all sizes up to a few vector widths and a spread of larger sizes, at every
+ * source and destination misalignment within a cache line, and fails with exit code 1 on the first mismatch or on a
+ * write outside the destination range. Then times the copy and set kernels against memcpy and memset across sizes,
+ * for cache line aligned and misaligned buffers.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "Memory/Mem.h"
+
+namespace
+{
+    // Guard bytes on both sides of every destination, they must still hold this pattern after each call.
+    static constexpr size_t GuardSize = 64;
+    static constexpr uint8 GuardByte = 0xCD;
+
+    static constexpr size_t MaxOffset = CACHE_LINE_SIZE;
+
+    // Cache line aligned buffer with room for the guards and every offset.
+    struct SBuffer
+    {
+        std::vector<uint8> Storage;
+
+        uint8* Base = nullptr;
+
+        explicit SBuffer(size_t Size)
+            : Storage(Size + 2 * GuardSize + MaxOffset + CACHE_LINE_SIZE)
+        {
+            const uintptr_t Address = reinterpret_cast<uintptr_t>(Storage.data()) + GuardSize;
+            Base = reinterpret_cast<uint8*>((Address + CACHE_LINE_SIZE - 1) & ~(CACHE_LINE_SIZE - 1));
+        }
+    };
+
+    std::vector<size_t> MakeCheckSizes()
+    {
+        std::vector<size_t> Sizes;
+        for (size_t Size = 0; Size <= 300; ++Size)
+        {
+            Sizes.push_back(Size);
+        }
+        for (size_t Size = 512; Size <= 1024 * 1024; Size *= 2)
+        {
+            Sizes.push_back(Size - 1);
+            Sizes.push_back(Size);
+            Sizes.push_back(Size + 33);
+        }
+        return Sizes;
+    }
+
+    void Fill(uint8* Data, size_t Size, std::mt19937& Random)
+    {
+        for (size_t Index = 0; Index < Size; ++Index)
+        {
+            Data[Index] = static_cast<uint8>(Random());
+        }
+    }
+
+    bool CheckGuards(const uint8* Data, size_t Size)
+    {
+        for (size_t Index = 1; Index <= GuardSize; ++Index)
+        {
+            if (Data[-static_cast<ptrdiff_t>(Index)] != GuardByte || Data[Size + Index - 1] != GuardByte)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int32 Sign(int32 Value)
+    {
+        return (Value > 0) - (Value < 0);
+    }
+
+    bool Fail(const char* Name, size_t Size, size_t DestinationOffset, size_t SourceOffset)
+    {
+        std::printf("  %-16s FAILED at %zu bytes, destination offset %zu, source offset %zu\n", Name, Size, DestinationOffset, SourceOffset);
+        return false;
+    }
+
+    // Runs one primitive and the libc reference on identical inputs and compares the destinations and guards.
+    template<typename TPrimitive, typename TReference>
+    bool CheckCopy(const char* Name, const std::vector<size_t>& Sizes, size_t OffsetStep, TPrimitive Primitive, TReference Reference)
+    {
+        const size_t MaxSize = Sizes.back();
+        SBuffer Source(MaxSize);
+        SBuffer Result(MaxSize);
+        SBuffer Expected(MaxSize);
+        std::mt19937 Random(7);
+        Fill(Source.Base, MaxSize + MaxOffset, Random);
+
+        for (size_t Size : Sizes)
+        {
+            // Large sizes take long enough per call that a few offsets cover the alignment cases.
+            const size_t Step = Size > 4096 ? OffsetStep * 7 : OffsetStep;
+            for (size_t DestinationOffset = 0; DestinationOffset < MaxOffset; DestinationOffset += Step)
+            {
+                for (size_t SourceOffset = 0; SourceOffset < MaxOffset; SourceOffset += Step)
+                {
+                    uint8* ResultData = Result.Base + DestinationOffset;
+                    uint8* ExpectedData = Expected.Base + DestinationOffset;
+                    std::memset(ResultData - GuardSize, GuardByte, Size + 2 * GuardSize);
+                    std::memset(ExpectedData - GuardSize, GuardByte, Size + 2 * GuardSize);
+
+                    Primitive(ResultData, Source.Base + SourceOffset, Size);
+                    Reference(ExpectedData, Source.Base + SourceOffset, Size);
+
+                    if (std::memcmp(ResultData, ExpectedData, Size) != 0 || !CheckGuards(ResultData, Size))
+                    {
+                        return Fail(Name, Size, DestinationOffset, SourceOffset);
+                    }
+                }
+            }
+        }
+        std::printf("  %-16s ok\n", Name);
+        return true;
+    }
+
+    bool CheckMemmoveOverlap(const std::vector<size_t>& Sizes)
+    {
+        const size_t MaxSize = std::min<size_t>(Sizes.back(), 64 * 1024);
+        SBuffer Result(2 * MaxSize);
+        SBuffer Expected(2 * MaxSize);
+        std::mt19937 Random(11);
+
+        for (size_t Size : Sizes)
+        {
+            if (Size > MaxSize)
+            {
+                break;
+            }
+            for (size_t Shift = 1; Shift < MaxOffset; Shift += Size > 4096 ? 7 : 1)
+            {
+                Fill(Result.Base, 2 * Size + MaxOffset, Random);
+                std::memcpy(Expected.Base, Result.Base, 2 * Size + MaxOffset);
+
+                // Forward and backward overlap.
+                Mem::Memmove(Result.Base + Shift, Result.Base, Size);
+                std::memmove(Expected.Base + Shift, Expected.Base, Size);
+                Mem::Memmove(Result.Base, Result.Base + Shift, Size);
+                std::memmove(Expected.Base, Expected.Base + Shift, Size);
+
+                if (std::memcmp(Result.Base, Expected.Base, 2 * Size + MaxOffset) != 0)
+                {
+                    return Fail("Memmove overlap", Size, Shift, 0);
+                }
+            }
+        }
+        std::printf("  %-16s ok\n", "Memmove overlap");
+        return true;
+    }
+
+    bool CheckMemcmp(const std::vector<size_t>& Sizes)
+    {
+        const size_t MaxSize = Sizes.back();
+        SBuffer Left(MaxSize);
+        SBuffer Right(MaxSize);
+        std::mt19937 Random(13);
+
+        for (size_t Size : Sizes)
+        {
+            const size_t Offset = Size % MaxOffset;
+            Fill(Left.Base + Offset, Size, Random);
+            std::memcpy(Right.Base, Left.Base + Offset, Size);
+            if (Mem::Memcmp(Left.Base + Offset, Right.Base, Size) != 0)
+            {
+                return Fail("Memcmp", Size, Offset, 0);
+            }
+
+            // A single differing byte at the start, in the middle and at the end, in both directions.
+            const size_t Positions[] = { 0, Size / 2, Size - 1 };
+            for (size_t Position : Positions)
+            {
+                if (Size == 0)
+                {
+                    break;
+                }
+                const uint8 Original = Right.Base[Position];
+                for (uint8 Delta : { uint8(1), uint8(255) })
+                {
+                    Right.Base[Position] = static_cast<uint8>(Original + Delta);
+                    const int32 Expected = Sign(std::memcmp(Left.Base + Offset, Right.Base, Size));
+                    if (Mem::Memcmp(Left.Base + Offset, Right.Base, Size) != Expected)
+                    {
+                        return Fail("Memcmp", Size, Offset, Position);
+                    }
+                }
+                Right.Base[Position] = Original;
+            }
+        }
+        std::printf("  %-16s ok\n", "Memcmp");
+        return true;
+    }
+
+    bool RunChecks()
+    {
+        const std::vector<size_t> Sizes = MakeCheckSizes();
+
+        std::printf("Comparing against libc over %zu sizes up to %zu bytes\n", Sizes.size(), Sizes.back());
+
+        bool bPassed = true;
+        bPassed &= CheckCopy("Memcpy", Sizes, 1,
+            [](uint8* Destination, const uint8* Source, size_t Size) { Mem::Memcpy(Destination, Source, Size); },
+            [](uint8* Destination, const uint8* Source, size_t Size) { std::memcpy(Destination, Source, Size); });
+        bPassed &= CheckCopy("Memmove", Sizes, 3,
+            [](uint8* Destination, const uint8* Source, size_t Size) { Mem::Memmove(Destination, Source, Size); },
+            [](uint8* Destination, const uint8* Source, size_t Size) { std::memmove(Destination, Source, Size); });
+        bPassed &= CheckCopy("MemcpyStreaming", Sizes, 5,
+            [](uint8* Destination, const uint8* Source, size_t Size) { Mem::MemcpyStreaming(Destination, Source, Size); },
+            [](uint8* Destination, const uint8* Source, size_t Size) { std::memcpy(Destination, Source, Size); });
+
+        // The source only seeds the value, which also covers values outside the byte range.
+        bPassed &= CheckCopy("Memset", Sizes, 1,
+            [](uint8* Destination, const uint8* Source, size_t Size) { Mem::Memset(Destination, 0x100 | Source[0], Size); },
+            [](uint8* Destination, const uint8* Source, size_t Size) { std::memset(Destination, 0x100 | Source[0], Size); });
+        bPassed &= CheckCopy("MemZero", Sizes, 1,
+            [](uint8* Destination, const uint8*, size_t Size) { Mem::MemZero(Destination, Size); },
+            [](uint8* Destination, const uint8*, size_t Size) { std::memset(Destination, 0, Size); });
+
+        bPassed &= CheckMemmoveOverlap(Sizes);
+        bPassed &= CheckMemcmp(Sizes);
+        return bPassed;
+    }
+
+    template<typename TFunction>
+    double MeasureBytesPerNanosecond(size_t NumBytes, uint32 NumIterations, TFunction Function)
+    {
+        using SClock = std::chrono::steady_clock;
+
+        // One untimed pass warms the caches and the branch predictors.
+        Function();
+
+        const SClock::time_point Start = SClock::now();
+        for (uint32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+        {
+            Function();
+        }
+        const double Nanoseconds = std::chrono::duration<double, std::nano>(SClock::now() - Start).count();
+        return static_cast<double>(NumBytes) * NumIterations / std::max(Nanoseconds, 1.0);
+    }
+
+    void RunBenchmark(size_t MaxBytes, uint32 NumIterations)
+    {
+        SBuffer Source(MaxBytes);
+        SBuffer Destination(MaxBytes);
+        std::mt19937 Random(42);
+        Fill(Source.Base, MaxBytes + MaxOffset, Random);
+
+        // Function pointers keep the compiler from inlining libc calls, both sides then pay for one call.
+        void* (*volatile LibcMemcpy)(void*, const void*, size_t) = &std::memcpy;
+        void* (*volatile LibcMemset)(void*, int, size_t) = &std::memset;
+
+        std::printf("\nThroughput with %s kernels, bytes per nanosecond (GB/s)\n", Mem::GetKernelName());
+        std::printf("  %10s %-9s %9s %9s %9s %9s %9s\n", "Size", "Alignment", "memcpy", "Memcpy", "Streaming", "memset", "Memset");
+
+        for (size_t Size = 16; Size <= MaxBytes; Size *= 4)
+        {
+            // Roughly the same number of bytes per size, so small sizes measure call overhead rather than timer noise.
+            const uint32 Iterations = static_cast<uint32>(std::max<size_t>(1, NumIterations * (MaxBytes / Size) / 64));
+
+            for (bool bAligned : { true, false })
+            {
+                uint8* Out = Destination.Base + (bAligned ? 0 : 3);
+                const uint8* In = Source.Base + (bAligned ? 0 : 17);
+
+                const double LibcCopy = MeasureBytesPerNanosecond(Size, Iterations, [&]() { LibcMemcpy(Out, In, Size); });
+                const double Copy = MeasureBytesPerNanosecond(Size, Iterations, [&]() { Mem::Memcpy(Out, In, Size); });
+                const double Streaming = MeasureBytesPerNanosecond(Size, Iterations, [&]() { Mem::MemcpyStreaming(Out, In, Size); });
+                const double LibcSet = MeasureBytesPerNanosecond(Size, Iterations, [&]() { LibcMemset(Out, 0x5A, Size); });
+                const double Set = MeasureBytesPerNanosecond(Size, Iterations, [&]() { Mem::Memset(Out, 0x5A, Size); });
+
+                std::printf("  %10zu %-9s %9.2f %9.2f %9.2f %9.2f %9.2f\n", Size, bAligned ? "aligned" : "unaligned", LibcCopy, Copy, Streaming, LibcSet, Set);
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t MaxBytes = 16 * 1024 * 1024;
+    uint32 NumIterations = 64;
+    for (int32 Arg = 1; Arg + 1 < argc; Arg += 2)
+    {
+        if (std::strcmp(argv[Arg], "--bytes") == 0)
+        {
+            MaxBytes = static_cast<size_t>(std::max(16, std::atoi(argv[Arg + 1])));
+        }
+        else if (std::strcmp(argv[Arg], "--iterations") == 0)
+        {
+            NumIterations = static_cast<uint32>(std::max(1, std::atoi(argv[Arg + 1])));
+        }
+    }
+
+    std::printf("Memory kernels: %s\n\n", Mem::GetKernelName());
+
+    const bool bPassed = RunChecks();
+    RunBenchmark(MaxBytes, NumIterations);
+    return bPassed ? 0 : 1;
+}
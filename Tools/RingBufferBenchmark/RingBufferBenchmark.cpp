@@ -0,0 +1,298 @@
+/*
+ * Stress test and throughput benchmark of the lock-free queues in Memory/RingBuffer.h.
+ *
+ * Usage: RingBufferBenchmark [--items N] [--capacity N] [--threads N]
+ *
+ * Runs producers and consumers on separate threads, with single and batch push and pop, and checks that every
+ * item arrives exactly once and that each consumer sees the items of any one producer in the order they were
+ * pushed. Fails with exit code 1 on a violation. Reports the throughput of each configuration next to a queue
+ * guarded by a mutex.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Memory/RingBuffer.h"
+
+namespace
+{
+    // Items carry their producer in the top bits and a per-producer sequence number below.
+    static constexpr uint32 SequenceBits = 40;
+    static constexpr uint64 SequenceMask = (uint64(1) << SequenceBits) - 1;
+
+    static constexpr size_t BatchSize = 32;
+
+    inline uint64 MakeItem(uint32 Producer, uint64 Sequence)
+    {
+        return (static_cast<uint64>(Producer) << SequenceBits) | Sequence;
+    }
+
+    /* Baseline with the same interface, a deque guarded by a mutex. */
+    class CMutexQueue
+    {
+    private:
+        std::mutex Mutex;
+
+        std::deque<uint64> Items;
+
+        size_t Capacity;
+
+    public:
+        explicit CMutexQueue(size_t InCapacity)
+            : Capacity(InCapacity)
+        {
+        }
+
+        bool TryPush(uint64 Value)
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            if (Items.size() == Capacity)
+            {
+                return false;
+            }
+            Items.push_back(Value);
+            return true;
+        }
+
+        size_t PushBatch(const uint64* Values, size_t Count)
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            const size_t NumPushed = std::min(Count, Capacity - Items.size());
+            Items.insert(Items.end(), Values, Values + NumPushed);
+            return NumPushed;
+        }
+
+        bool TryPop(uint64& OutValue)
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            if (Items.empty())
+            {
+                return false;
+            }
+            OutValue = Items.front();
+            Items.pop_front();
+            return true;
+        }
+
+        size_t PopBatch(uint64* OutValues, size_t MaxCount)
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            const size_t NumPopped = std::min(MaxCount, Items.size());
+            std::copy(Items.begin(), Items.begin() + NumPopped, OutValues);
+            Items.erase(Items.begin(), Items.begin() + NumPopped);
+            return NumPopped;
+        }
+    };
+
+    struct SRunResult
+    {
+        bool bPassed = true;
+
+        double ItemsPerSecond = 0.0;
+    };
+
+    /*
+     * Pushes NumItemsPerProducer items from every producer and pops them on the consumers until all have arrived.
+     * Each consumer checks the per-producer order as it pops, every item is then counted once in Received.
+     */
+    template<typename TQueue>
+    SRunResult Run(TQueue& Queue, uint32 NumProducers, uint32 NumConsumers, uint64 NumItemsPerProducer, bool bBatch)
+    {
+        const uint64 NumItems = NumItemsPerProducer * NumProducers;
+
+        std::vector<std::atomic<uint8>> Received(NumItems);
+        for (std::atomic<uint8>& Count : Received)
+        {
+            Count.store(0, std::memory_order_relaxed);
+        }
+
+        std::atomic<uint64> NumPopped { 0 };
+        std::atomic<bool> bOrderViolated { false };
+        std::atomic<uint32> NumReady { 0 };
+        std::atomic<bool> bStart { false };
+
+        auto WaitForStart = [&]()
+        {
+            NumReady.fetch_add(1);
+            while (!bStart.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+        };
+
+        std::vector<std::thread> Threads;
+        for (uint32 Producer = 0; Producer < NumProducers; ++Producer)
+        {
+            Threads.emplace_back([&, Producer]()
+            {
+                WaitForStart();
+
+                uint64 Values[BatchSize];
+                uint64 Sequence = 0;
+                while (Sequence < NumItemsPerProducer)
+                {
+                    if (bBatch)
+                    {
+                        const size_t Count = static_cast<size_t>(std::min<uint64>(BatchSize, NumItemsPerProducer - Sequence));
+                        for (size_t Index = 0; Index < Count; ++Index)
+                        {
+                            Values[Index] = MakeItem(Producer, Sequence + Index);
+                        }
+
+                        const size_t NumPushed = Queue.PushBatch(Values, Count);
+                        Sequence += NumPushed;
+                        if (NumPushed == 0)
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                    else if (Queue.TryPush(MakeItem(Producer, Sequence)))
+                    {
+                        ++Sequence;
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        for (uint32 Consumer = 0; Consumer < NumConsumers; ++Consumer)
+        {
+            Threads.emplace_back([&]()
+            {
+                WaitForStart();
+
+                // Next sequence number this consumer may see from each producer, at least.
+                std::vector<uint64> NextSequence(NumProducers, 0);
+                uint64 Values[BatchSize];
+
+                while (NumPopped.load(std::memory_order_relaxed) < NumItems)
+                {
+                    size_t Count = 0;
+                    if (bBatch)
+                    {
+                        Count = Queue.PopBatch(Values, BatchSize);
+                    }
+                    else if (Queue.TryPop(Values[0]))
+                    {
+                        Count = 1;
+                    }
+
+                    if (Count == 0)
+                    {
+                        std::this_thread::yield();
+                        continue;
+                    }
+
+                    for (size_t Index = 0; Index < Count; ++Index)
+                    {
+                        const uint32 Producer = static_cast<uint32>(Values[Index] >> SequenceBits);
+                        const uint64 Sequence = Values[Index] & SequenceMask;
+                        if (Producer >= NumProducers || Sequence >= NumItemsPerProducer || Sequence < NextSequence[Producer])
+                        {
+                            bOrderViolated.store(true, std::memory_order_relaxed);
+                            continue;
+                        }
+                        NextSequence[Producer] = Sequence + 1;
+                        Received[Producer * NumItemsPerProducer + Sequence].fetch_add(1, std::memory_order_relaxed);
+                    }
+                    NumPopped.fetch_add(Count, std::memory_order_relaxed);
+                }
+            });
+        }
+
+        while (NumReady.load() < NumProducers + NumConsumers)
+        {
+            std::this_thread::yield();
+        }
+
+        using SClock = std::chrono::steady_clock;
+        const SClock::time_point Start = SClock::now();
+        bStart.store(true, std::memory_order_release);
+        for (std::thread& Thread : Threads)
+        {
+            Thread.join();
+        }
+        const double Seconds = std::chrono::duration<double>(SClock::now() - Start).count();
+
+        SRunResult Result;
+        Result.bPassed = !bOrderViolated.load() && NumPopped.load() == NumItems;
+        for (const std::atomic<uint8>& Count : Received)
+        {
+            Result.bPassed &= Count.load(std::memory_order_relaxed) == 1;
+        }
+        Result.ItemsPerSecond = static_cast<double>(NumItems) / std::max(Seconds, 1e-9);
+        return Result;
+    }
+
+    void PrintResult(const char* Name, uint32 NumProducers, uint32 NumConsumers, bool bBatch, const SRunResult& Result)
+    {
+        std::printf("  %-12s %2u:%-2u %-6s %8.2f M items/s  %s\n", Name, NumProducers, NumConsumers, bBatch ? "batch" : "single",
+            Result.ItemsPerSecond / 1e6, Result.bPassed ? "ok" : "FAILED");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint64 NumItems = 1 << 22;
+    size_t Capacity = 1024;
+    uint32 MaxThreads = 4;
+    for (int32 Arg = 1; Arg + 1 < argc; Arg += 2)
+    {
+        if (std::strcmp(argv[Arg], "--items") == 0)
+        {
+            NumItems = static_cast<uint64>(std::max(1, std::atoi(argv[Arg + 1])));
+        }
+        else if (std::strcmp(argv[Arg], "--capacity") == 0)
+        {
+            // Queues require a power of two.
+            const size_t Requested = static_cast<size_t>(std::max(1, std::atoi(argv[Arg + 1])));
+            Capacity = 1;
+            while (Capacity < Requested)
+            {
+                Capacity *= 2;
+            }
+        }
+        else if (std::strcmp(argv[Arg], "--threads") == 0)
+        {
+            MaxThreads = static_cast<uint32>(std::max(1, std::atoi(argv[Arg + 1])));
+        }
+    }
+
+    std::printf("%llu items through a capacity of %zu, %u hardware threads\n", static_cast<unsigned long long>(NumItems), Capacity, std::thread::hardware_concurrency());
+
+    bool bPassed = true;
+    for (bool bBatch : { false, true })
+    {
+        TSpscQueue<uint64> Queue(Capacity);
+        const SRunResult Result = Run(Queue, 1, 1, NumItems, bBatch);
+        PrintResult("TSpscQueue", 1, 1, bBatch, Result);
+        bPassed &= Result.bPassed;
+    }
+
+    for (uint32 NumThreads = 1; NumThreads <= MaxThreads; NumThreads *= 2)
+    {
+        for (bool bBatch : { false, true })
+        {
+            TMpmcQueue<uint64> Queue(Capacity);
+            const SRunResult Result = Run(Queue, NumThreads, NumThreads, NumItems / NumThreads, bBatch);
+            PrintResult("TMpmcQueue", NumThreads, NumThreads, bBatch, Result);
+            bPassed &= Result.bPassed;
+
+            CMutexQueue Baseline(Capacity);
+            PrintResult("Mutex", NumThreads, NumThreads, bBatch, Run(Baseline, NumThreads, NumThreads, NumItems / NumThreads, bBatch));
+        }
+    }
+
+    return bPassed ? 0 : 1;
+}